@@ -1764,7 +1764,12 @@ void ParserBuilder::_hiltiGetLookAhead(shared_ptr<Production> prod, const std::l
 
     shared_ptr<hilti::Expression> mstate = nullptr;
 
-    if ( regexps.size() )
+    // If the regexps are all just plain byte sequences, we match them with a
+    // trie instead.
+    literal_list literals;
+    bool plain = (regexps.size() && _literalTokens(regexps, &literals));
+
+    if ( regexps.size() && ! plain )
         mstate = _hiltiMatchTokenInit(id_name, regexps);
 
     cg()->builder()->addInstruction(hilti::instruction::flow::Jump, loop->block());
@@ -1776,12 +1781,21 @@ void ParserBuilder::_hiltiGetLookAhead(shared_ptr<Production> prod, const std::l
     if ( regexps.size() ) {
         re_done = cg()->moduleBuilder()->newBuilder("lahead-regexp-done");
 
-        auto mresult = _hiltiMatchTokenAdvance(mstate);
-        cg()->builder()->addInstruction(token, hilti::instruction::tuple::Index, mresult, hilti::builder::integer::create(0));
+        if ( plain )
+            _hiltiMatchLiterals(literals, token, ncur);
+
+        else {
+            auto mresult = _hiltiMatchTokenAdvance(mstate);
+            cg()->builder()->addInstruction(token, hilti::instruction::tuple::Index, mresult, hilti::builder::integer::create(0));
+        }
+
         _hiltiDebugShowToken("regexp token", token);
 
         auto found = cg()->moduleBuilder()->pushBuilder("lahead-regexp-found");
-        cg()->builder()->addInstruction(ncur, hilti::instruction::operator_::Assign, state()->cur);
+
+        if ( ! plain )
+            cg()->builder()->addInstruction(ncur, hilti::instruction::operator_::Assign, state()->cur);
+
         cg()->builder()->addInstruction(hilti::instruction::flow::Jump, re_done->block());
         cg()->moduleBuilder()->popBuilder(found);
 
@@ -1959,6 +1973,166 @@ shared_ptr<hilti::Expression> ParserBuilder::_hiltiMatchTokenAdvance(shared_ptr<
     return mresult;
 }
 
+// Decodes a regular expression that just spells out a plain byte sequence.
+// Returns false if the pattern uses any other regular expression features.
+static bool _decodeLiteralPattern(const string& pattern, string* result)
+{
+    static const string meta = ".[]()*+?{}|^$";
+    static const string escapable = "\\/.[](){}*+?|^$-\"";
+
+    for ( size_t i = 0; i < pattern.size(); i++ ) {
+        auto c = pattern[i];
+
+        if ( meta.find(c) != string::npos )
+            return false;
+
+        if ( c != '\\' ) {
+            *result += c;
+            continue;
+        }
+
+        if ( ++i >= pattern.size() )
+            return false;
+
+        c = pattern[i];
+
+        if ( escapable.find(c) != string::npos )
+            *result += c;
+
+        else if ( c == 'n' )
+            *result += '\n';
+
+        else if ( c == 'r' )
+            *result += '\r';
+
+        else if ( c == 't' )
+            *result += '\t';
+
+        else if ( c == 'x' && i + 2 < pattern.size() && isxdigit(pattern[i + 1]) && isxdigit(pattern[i + 2]) ) {
+            *result += (char)strtol(pattern.substr(i + 1, 2).c_str(), 0, 16);
+            i += 2;
+        }
+
+        else
+            return false;
+    }
+
+    return result->size() > 0;
+}
+
+bool ParserBuilder::_literalTokens(const std::list<shared_ptr<production::Terminal>>& terms, literal_list* literals)
+{
+    std::map<string, int> seen;
+
+    for ( auto t : terms ) {
+        auto c = ast::tryCast<production::Ctor>(t);
+
+        if ( ! c )
+            return false;
+
+        auto re = ast::tryCast<ctor::RegExp>(c->ctor());
+
+        if ( ! re || re->attributes().size() )
+            return false;
+
+        for ( auto p : re->patterns() ) {
+            string data;
+
+            if ( ! _decodeLiteralPattern(p, &data) )
+                return false;
+
+            // Leave it to the regexp engine to sort out the same sequence
+            // mapping to different tokens.
+            auto i = seen.find(data);
+
+            if ( i != seen.end() && i->second != t->tokenID() )
+                return false;
+
+            seen[data] = t->tokenID();
+        }
+    }
+
+    for ( auto s : seen )
+        literals->push_back(s);
+
+    return true;
+}
+
+void ParserBuilder::_hiltiMatchLiterals(const literal_list& literals, shared_ptr<hilti::Expression> token, shared_ptr<hilti::Expression> ncur)
+{
+    auto p = cg()->moduleBuilder()->addTmp("trie_cur", _hiltiTypeIteratorBytes());
+    auto byte = cg()->moduleBuilder()->addTmp("trie_byte", hilti::builder::integer::type(8));
+    auto c = cg()->moduleBuilder()->addTmp("trie_c", hilti::builder::integer::type(64));
+    auto at_end = cg()->moduleBuilder()->addTmp("trie_at_end", hilti::builder::boolean::type());
+
+    auto eod = _hiltiEod();
+    auto frozen = _hiltiIsFrozen();
+
+    cg()->builder()->addInstruction(p, hilti::instruction::operator_::Assign, state()->cur);
+    cg()->builder()->addInstruction(token, hilti::instruction::operator_::Assign, _hiltiLookAheadNone());
+
+    auto done = cg()->moduleBuilder()->newBuilder("trie-done");
+
+    auto need_more = cg()->moduleBuilder()->pushBuilder("trie-need-more");
+    cg()->builder()->addInstruction(token, hilti::instruction::operator_::Assign, hilti::builder::integer::create(-1));
+    cg()->builder()->addInstruction(hilti::instruction::flow::Jump, done->block());
+    cg()->moduleBuilder()->popBuilder(need_more);
+
+    // If we run out of input while a longer match is still possible, we
+    // need to wait for more unless the input is complete.
+    auto at_eod = cg()->moduleBuilder()->pushBuilder("trie-at-eod");
+    cg()->builder()->addInstruction(hilti::instruction::flow::IfElse, frozen, done->block(), need_more->block());
+    cg()->moduleBuilder()->popBuilder(at_eod);
+
+    // Generates the code for one trie node, given all the literals sharing
+    // the node's prefix of length depth.
+    std::function<void (const literal_list&, size_t)> node = [&] (const literal_list& lits, size_t depth) {
+        std::map<unsigned char, literal_list> children;
+
+        for ( auto l : lits ) {
+            if ( l.first.size() > depth ) {
+                children[(unsigned char)l.first[depth]].push_back(l);
+                continue;
+            }
+
+            // Record the match; a longer one may still follow.
+            cg()->builder()->addInstruction(token, hilti::instruction::operator_::Assign, hilti::builder::integer::create(l.second));
+            cg()->builder()->addInstruction(ncur, hilti::instruction::operator_::Assign, p);
+        }
+
+        if ( children.empty() ) {
+            cg()->builder()->addInstruction(hilti::instruction::flow::Jump, done->block());
+            return;
+        }
+
+        auto next = cg()->moduleBuilder()->newBuilder("trie-next");
+        cg()->builder()->addInstruction(at_end, hilti::instruction::operator_::Equal, p, eod);
+        cg()->builder()->addInstruction(hilti::instruction::flow::IfElse, at_end, at_eod->block(), next->block());
+
+        cg()->moduleBuilder()->pushBuilder(next);
+        cg()->builder()->addInstruction(byte, hilti::instruction::iterBytes::Deref, p);
+        cg()->builder()->addInstruction(c, hilti::instruction::integer::ZExt, byte);
+        cg()->builder()->addInstruction(p, hilti::instruction::iterBytes::Incr, p);
+
+        hilti::builder::BlockBuilder::case_list cases;
+
+        for ( auto ch : children ) {
+            auto b = cg()->moduleBuilder()->pushBuilder("trie-node");
+            node(ch.second, depth + 1);
+            cg()->moduleBuilder()->popBuilder(b);
+
+            cases.push_back(std::make_pair(hilti::builder::integer::create(ch.first), b));
+        }
+
+        cg()->builder()->addSwitch(c, done, cases);
+        cg()->moduleBuilder()->popBuilder(next);
+    };
+
+    node(literals, 0);
+
+    cg()->moduleBuilder()->pushBuilder(done); // Leave on stack.
+}
+
 shared_ptr<hilti::builder::BlockBuilder> ParserBuilder::_hiltiAddMatchTokenErrorCases(shared_ptr<Production> prod,
                                                                              hilti::builder::BlockBuilder::case_list* cases,
                                                                              shared_ptr<hilti::builder::BlockBuilder> repeat,
@@ -2252,6 +2426,108 @@ shared_ptr<hilti::Expression> ParserBuilder::_hiltiIntUnpackFormat(int width, bo
     return result;
 }
 
+shared_ptr<hilti::Expression> ParserBuilder::_hiltiByteOrder(shared_ptr<binpac::Expression> byteorder)
+{
+    if ( ! byteorder )
+        return hilti::builder::id::create("Hilti::ByteOrder::Big");
+
+    auto hltbo = cg()->hiltiExpression(byteorder);
+
+    auto t1 = hilti::builder::tuple::create({
+        hilti::builder::id::create("BinPAC::ByteOrder::Little"),
+        hilti::builder::id::create("Hilti::ByteOrder::Little") });
+
+    auto t2 = hilti::builder::tuple::create({
+        hilti::builder::id::create("BinPAC::ByteOrder::Big"),
+        hilti::builder::id::create("Hilti::ByteOrder::Big") });
+
+    auto t3 = hilti::builder::tuple::create({
+        hilti::builder::id::create("BinPAC::ByteOrder::Host"),
+        hilti::builder::id::create("Hilti::ByteOrder::Host") });
+
+    auto tuple = hilti::builder::tuple::create({ t1, t2, t3 });
+    auto result = cg()->moduleBuilder()->addTmp("order", hilti::builder::type::byName("Hilti::ByteOrder"));
+    cg()->builder()->addInstruction(result, hilti::instruction::Misc::SelectValue, hltbo, tuple);
+
+    return result;
+}
+
+shared_ptr<type::Integer> ParserBuilder::_bulkElementType(production::Counter* c)
+{
+    if ( ! (cg()->options().optimize && cg()->options().optimizing("bulk-vectors")) )
+        return nullptr;
+
+    // With debugging, we want to see each element individually.
+    if ( cg()->options().debug > 0 || ! storingValues() )
+        return nullptr;
+
+    auto vec = ast::tryCast<type::unit::item::field::container::Vector>(c->pgMeta()->field);
+    auto var = ast::tryCast<production::Variable>(c->body());
+
+    if ( ! (vec && var) )
+        return nullptr;
+
+    auto itype = ast::tryCast<type::Integer>(var->type());
+
+    if ( ! itype || var->expression() || var->filter() || var->sink() )
+        return nullptr;
+
+    switch ( itype->width() ) {
+     case 8:
+     case 16:
+     case 32:
+     case 64:
+        break;
+
+     default:
+        return nullptr;
+    }
+
+    auto elem = vec->field();
+
+    if ( elem->hooks().size() || elem->condition() || elem->sinks().size() )
+        return nullptr;
+
+    for ( auto a : elem->attributes()->attributes() ) {
+        if ( a->key() != "byteorder" )
+            return nullptr;
+    }
+
+    // The only foreach hook we can do without is the one that adds the
+    // elements to the vector. Note that we can only see hooks that the
+    // unit's own module defines; the "bulk-vectors" optimization therefore
+    // assumes that no other module adds foreach hooks to it.
+    for ( auto h : vec->hooks() ) {
+        if ( h->foreach() && h != vec->pushBackHook() )
+            return nullptr;
+    }
+
+    auto unit = state()->unit;
+    auto name = vec->id()->name();
+
+    for ( auto g : unit->globalHooks() ) {
+        if ( g->id()->local() != name )
+            continue;
+
+        for ( auto h : g->hooks() ) {
+            if ( h->foreach() )
+                return nullptr;
+        }
+    }
+
+    auto module = unit->firstParent<Module>();
+    assert(module);
+
+    for ( auto d : module->body()->declarations() ) {
+        auto h = ast::tryCast<declaration::Hook>(d);
+
+        if ( h && h->hook()->foreach() && h->hook()->unit() == unit && h->id()->local() == name )
+            return nullptr;
+    }
+
+    return itype;
+}
+
 void ParserBuilder::disableStoringValues()
 {
     --_store_values;
@@ -2770,8 +3046,10 @@ void ParserBuilder::visit(ctor::Bytes* b)
 
     cg()->builder()->addComment(util::fmt("Bytes constant: %s", field->id()->name()));
 
+    auto expr = std::make_shared<expression::Ctor>(b->sharedPtr<ctor::Bytes>());
+
     if ( state()->mode == ParserState::LAHEAD_REPARSE ) {
-        auto value = cg()->hiltiExpression(std::make_shared<expression::Ctor>(b->sharedPtr<ctor::Bytes>()));
+        auto value = cg()->hiltiExpression(expr);
         setResult(value);
         return;
     }
@@ -2781,37 +3059,58 @@ void ParserBuilder::visit(ctor::Bytes* b)
     if ( state()->mode == ParserState::TRY )
         ocur = _hiltiSavePosition();
 
-    // We parse the field as fixed bytes and then compare the value against
-    // the constant we expect.
-    auto length = hilti::builder::integer::create(b->length());
-    auto length_op = cg()->builder()->addTmp("unpack_len", hilti::builder::integer::type(64)); // This will be adapted by _hiltiCheckChunk().
-    cg()->builder()->addInstruction(length_op, hilti::instruction::operator_::Assign, length);
-
-    auto op1 = state()->cur;
-    auto op2 = hilti::builder::id::create("Hilti::Packed::BytesFixed");
-    auto value = hiltiUnpack(std::make_shared<binpac::type::Bytes>(), op1, op2, length_op, [&] () { _hiltiCheckChunk(field); });
-
-    auto expr = std::make_shared<expression::Ctor>(b->sharedPtr<ctor::Bytes>());
-    auto mismatch = cg()->builder()->addTmp("mismatch", hilti::builder::boolean::type());
-    cg()->builder()->addInstruction(mismatch, hilti::instruction::operator_::Unequal, value, cg()->hiltiExpression(expr));
+    // We compare the input against the constant in place, without
+    // extracting it into a new bytes object first. Once matched, the value
+    // is the constant itself, which gets instantiated only if the field is
+    // stored or otherwise used.
+    auto match = cg()->moduleBuilder()->newBuilder("match-bytes");
+    auto check_insufficient = cg()->moduleBuilder()->newBuilder("match-bytes-check");
+    auto yield = cg()->moduleBuilder()->newBuilder("match-bytes-yield");
+    auto error = cg()->moduleBuilder()->newBuilder("match-bytes-error");
+    auto matched = cg()->moduleBuilder()->newBuilder("match-bytes-found");
+    auto cont = cg()->moduleBuilder()->newBuilder("match-bytes-cont");
+
+    cg()->builder()->addInstruction(hilti::instruction::flow::Jump, match->block());
+
+    cg()->moduleBuilder()->pushBuilder(match);
+    auto result = cg()->builder()->addTmp("match_result", hilti::builder::integer::type(8));
+    auto cond = cg()->builder()->addTmp("cond", hilti::builder::boolean::type());
+    cg()->builder()->addInstruction(result, hilti::instruction::bytes::MatchAt, state()->cur, cg()->hiltiExpression(expr));
+    cg()->builder()->addInstruction(cond, hilti::instruction::integer::Equal, result, hilti::builder::integer::create(1));
+    cg()->builder()->addInstruction(hilti::instruction::flow::IfElse, cond, matched->block(), check_insufficient->block());
+    cg()->moduleBuilder()->popBuilder(match);
+
+    cg()->moduleBuilder()->pushBuilder(check_insufficient);
+    cg()->builder()->addInstruction(cond, hilti::instruction::integer::Equal, result, hilti::builder::integer::create(-1));
+    cg()->builder()->addInstruction(hilti::instruction::flow::IfElse, cond, yield->block(), error->block());
+    cg()->moduleBuilder()->popBuilder(check_insufficient);
 
-    auto branches = cg()->builder()->addIf(mismatch);
-    auto error = std::get<0>(branches);
-    auto cont = std::get<1>(branches);
+    cg()->moduleBuilder()->pushBuilder(yield);
+    _hiltiCheckChunk(field);
+    _hiltiInsufficientInputHandler(false);
+    cg()->builder()->addInstruction(hilti::instruction::flow::Jump, match->block());
+    cg()->moduleBuilder()->popBuilder(yield);
 
     cg()->moduleBuilder()->pushBuilder(error);
 
-    if ( state()->mode == ParserState::TRY )
+    if ( state()->mode == ParserState::TRY ) {
         _hiltiRestorePosition(ocur);
+        cg()->builder()->addInstruction(hilti::instruction::flow::Jump, cont->block());
+    }
 
     else
         _hiltiParseError(util::fmt("bytes constant expected (%s)", b->render()));
 
     cg()->moduleBuilder()->popBuilder(error);
 
+    cg()->moduleBuilder()->pushBuilder(matched);
+    _hiltiAdvanceBy(hilti::builder::integer::create(b->length()));
+    cg()->builder()->addInstruction(hilti::instruction::flow::Jump, cont->block());
+    cg()->moduleBuilder()->popBuilder(matched);
+
     cg()->moduleBuilder()->pushBuilder(cont);
 
-    setResult(value);
+    setResult(cg()->hiltiExpression(expr));
 }
 
 void ParserBuilder::visit(ctor::RegExp* r)
@@ -2845,19 +3144,35 @@ void ParserBuilder::visit(ctor::RegExp* r)
     auto ocur = cg()->moduleBuilder()->addTmp("ocur", _hiltiTypeIteratorBytes());
     cg()->builder()->addInstruction(ocur, hilti::instruction::operator_::Assign, state()->cur);
 
-    auto mstate = _hiltiMatchTokenInit(name, { lit->sharedPtr<production::Literal>() });
+    literal_list literals;
+    bool plain = _literalTokens({ lit->sharedPtr<production::Literal>() }, &literals);
+
+    auto ncur = cg()->moduleBuilder()->addTmp("ncur", _hiltiTypeIteratorBytes());
+    shared_ptr<hilti::Expression> mstate = nullptr;
+    shared_ptr<hilti::Expression> mresult = nullptr;
+
+    if ( ! plain )
+        mstate = _hiltiMatchTokenInit(name, { lit->sharedPtr<production::Literal>() });
+
     cg()->builder()->addInstruction(hilti::instruction::flow::Jump, loop->block());
 
     cg()->moduleBuilder()->pushBuilder(loop);
 
-    auto mresult = _hiltiMatchTokenAdvance(mstate);
-    cg()->builder()->addInstruction(symbol, hilti::instruction::tuple::Index, mresult, hilti::builder::integer::create(0));
+    if ( plain )
+        _hiltiMatchLiterals(literals, symbol, ncur);
+
+    else {
+        mresult = _hiltiMatchTokenAdvance(mstate);
+        cg()->builder()->addInstruction(symbol, hilti::instruction::tuple::Index, mresult, hilti::builder::integer::create(0));
+    }
 
     _hiltiDebugShowToken("regexp token", symbol);
 
     auto found_lit = cg()->moduleBuilder()->pushBuilder("found-literal");
-    auto ncur = cg()->builder()->addTmp("ncur", _hiltiTypeIteratorBytes());
-    cg()->builder()->addInstruction(ncur, hilti::instruction::tuple::Index, mresult, hilti::builder::integer::create(1));
+
+    if ( ! plain )
+        cg()->builder()->addInstruction(ncur, hilti::instruction::tuple::Index, mresult, hilti::builder::integer::create(1));
+
     _hiltiAdvanceTo(ncur); // Move position.
     cg()->builder()->addInstruction(value, hilti::instruction::bytes::Sub, ocur, state()->cur);
     cg()->builder()->addInstruction(hilti::instruction::flow::Jump, done->block());
@@ -2874,8 +3189,10 @@ void ParserBuilder::visit(ctor::RegExp* r)
 
     cg()->moduleBuilder()->pushBuilder(done);
 
-    cg()->builder()->addInstruction(hilti::instruction::operator_::Clear, mresult);
-    cg()->builder()->addInstruction(hilti::instruction::operator_::Clear, mstate);
+    if ( ! plain ) {
+        cg()->builder()->addInstruction(hilti::instruction::operator_::Clear, mresult);
+        cg()->builder()->addInstruction(hilti::instruction::operator_::Clear, mstate);
+    }
 
     setResult(value);
 }
@@ -3008,7 +3325,49 @@ void ParserBuilder::visit(production::Counter* c)
 
     auto cnt = cg()->hiltiExpression(c->expression(), std::make_shared<type::Integer>(64, false));
     cg()->builder()->addInstruction(i, hilti::instruction::operator_::Assign, cnt);
-    cg()->builder()->addInstruction(hilti::instruction::flow::Jump, loop->block());
+
+    if ( auto itype = _bulkElementType(c) ) {
+        // If all the elements are already available, decode them in one go.
+        // Otherwise we fall back to the element-wise loop, which knows how
+        // to wait for more input.
+        auto bulk = cg()->moduleBuilder()->newBuilder("count-bulk");
+        auto need = cg()->builder()->addTmp("count-need", hilti::builder::integer::type(64));
+        auto avail = cg()->builder()->addTmp("count-avail", hilti::builder::integer::type(64));
+        auto ok = cg()->builder()->addTmp("count-ok", hilti::builder::boolean::type());
+        auto size = hilti::builder::integer::create(itype->width() / 8);
+
+        // Compare element counts rather than byte counts, as the count may
+        // come straight from the input and multiplying could overflow.
+        cg()->builder()->addInstruction(avail, hilti::instruction::bytes::Diff, state()->cur, _hiltiEod());
+        cg()->builder()->addInstruction(avail, hilti::instruction::integer::Div, avail, size);
+        cg()->builder()->addInstruction(ok, hilti::instruction::integer::Sleq, i, avail);
+        cg()->builder()->addInstruction(b, hilti::instruction::integer::Sgt, i, hilti::builder::integer::create(0));
+        cg()->builder()->addInstruction(ok, hilti::instruction::boolean::And, ok, b);
+        cg()->builder()->addInstruction(hilti::instruction::flow::IfElse, ok, bulk->block(), loop->block());
+
+        cg()->moduleBuilder()->pushBuilder(bulk);
+
+        cg()->builder()->addInstruction(need, hilti::instruction::integer::Mul, i, size);
+
+        auto ncur = cg()->builder()->addTmp("count-ncur", _hiltiTypeIteratorBytes());
+        cg()->builder()->addInstruction(ncur, hilti::instruction::operator_::IncrBy, state()->cur, need);
+
+        if ( ! field->transient() ) {
+            auto vec = ast::checkedCast<type::unit::item::field::container::Vector>(field);
+            auto order = _hiltiByteOrder(vec->field()->inheritedProperty("byteorder"));
+            auto iters = hilti::builder::tuple::create({ state()->cur, ncur });
+            auto v = cg()->hiltiItemGet(state()->self, field);
+            cg()->builder()->addInstruction(hilti::instruction::vector::PushBackUnpacked, v, iters, order);
+        }
+
+        _hiltiAdvanceTo(ncur);
+        cg()->builder()->addInstruction(hilti::instruction::flow::Jump, cont->block());
+
+        cg()->moduleBuilder()->popBuilder(bulk);
+    }
+
+    else
+        cg()->builder()->addInstruction(hilti::instruction::flow::Jump, loop->block());
 
     cg()->moduleBuilder()->pushBuilder(loop);
     cg()->builder()->addInstruction(b, hilti::instruction::integer::Sleq, i, hilti::builder::integer::create(0));
@@ -199,6 +199,7 @@ protected:
 
 private:
     typedef std::list<std::pair<shared_ptr<hilti::Expression>, shared_ptr<Type>>> hilti_expression_type_list;
+    typedef std::list<std::pair<string, int>> literal_list;
 
     // Pushes an empty parse function with the right standard signature. If
     // value_type is given, the function return tuple will contain an
@@ -302,6 +303,19 @@ private:
     // Performs the matching of the next token. Throws execeptions if the matching fails.
     shared_ptr<hilti::Expression> _hiltiMatchTokenAdvance(shared_ptr<hilti::Expression> mstate);
 
+    // Checks whether all the terminals are regular expressions that just
+    // spell out plain byte sequences. If so, returns true and adds the byte
+    // sequences to \a literals along with their token IDs.
+    bool _literalTokens(const std::list<shared_ptr<production::Terminal>>& terms, literal_list* literals);
+
+    // Generates HILTI code matching a set of plain byte sequences at the
+    // current position by walking a byte trie, without going through the
+    // regular expression engine. Sets \a token to the ID of the longest
+    // match, to zero if none matches, or to -1 if more input is needed to
+    // decide. On a match, sets \a ncur to the position following it. The
+    // current position remains unchanged.
+    void _hiltiMatchLiterals(const literal_list& literals, shared_ptr<hilti::Expression> token, shared_ptr<hilti::Expression> ncur);
+
     // Adds the standard error cases for a switch statement switching on the match result.
     shared_ptr<hilti::builder::BlockBuilder> _hiltiAddMatchTokenErrorCases(shared_ptr<Production> prod,
                                                                            hilti::builder::BlockBuilder::case_list* cases,
@@ -330,6 +344,17 @@ private:
     // byteorder is null, network order is used as default.
     shared_ptr<hilti::Expression> _hiltiIntUnpackFormat(int width, bool signed_, shared_ptr<binpac::Expression> byteorder);
 
+    // Returns a HILTI expression of type Hilti::ByteOrder corresponding to
+    // the given BinPAC::ByteOrder expression. If \a byteorder is null,
+    // network order is used as default.
+    shared_ptr<hilti::Expression> _hiltiByteOrder(shared_ptr<binpac::Expression> byteorder);
+
+    // Checks whether a counted container can be parsed in bulk rather than
+    // element by element. That's the case for vectors of integers for
+    // which nothing needs to see the individual elements. Returns the
+    // element type if so, and null otherwise.
+    shared_ptr<type::Integer> _bulkElementType(production::Counter* c);
+
     // Disables saving parsed values in a parse objects. This is primarily
     // for parsing container items that aren't directly stored there.
     void disableStoringValues();
@@ -10,6 +10,7 @@
 
 #include "parser/driver.h"
 
+#include "passes/field-usage.h"
 #include "passes/grammar-builder.h"
 #include "passes/id-resolver.h"
 #include "passes/overload-resolver.h"
@@ -299,6 +300,30 @@ bool binpac::CompilerContext::finalize(shared_ptr<Module> node, bool verify)
     return true;
 }
 
+bool binpac::CompilerContext::elideUnusedFields(shared_ptr<Module> module, const std::list<shared_ptr<Node>>& readers, std::list<shared_ptr<type::unit::item::Field>>* elided)
+{
+    passes::FieldUsage field_usage;
+
+    _beginPass(module, field_usage);
+
+    if ( ! field_usage.run(module) )
+        return false;
+
+    for ( auto r : readers ) {
+        if ( ! field_usage.run(r) )
+            return false;
+    }
+
+    auto fields = field_usage.elide(module);
+
+    if ( elided )
+        elided->insert(elided->end(), fields.begin(), fields.end());
+
+    _endPass();
+
+    return true;
+}
+
 llvm::Module* binpac::CompilerContext::compile(shared_ptr<Module> module, shared_ptr<hilti::Module>* hilti_module_out, bool hilti_only)
 {
     CodeGen codegen(this);
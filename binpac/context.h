@@ -88,6 +88,22 @@ public:
     /// Returns: True if the partial finalizing proceeded as expected.
     bool partialFinalize(shared_ptr<Module> module);
 
+    /// Turns all fields of a module's units transient that no code reads,
+    /// so that parsing just advances over them. Code accessing the units
+    /// from outside of the module must be passed in as \a readers; all
+    /// ASTs must have been finalized. See passes::FieldUsage for the
+    /// analysis. This must run before the module is compiled.
+    ///
+    /// module: The module whose units to process.
+    ///
+    /// readers: Further ASTs that may access the module's unit fields.
+    ///
+    /// elided: If given, the fields that have been turned transient will be
+    /// appended to this list.
+    ///
+    /// Returns: True if no errors were encountered.
+    bool elideUnusedFields(shared_ptr<Module> module, const std::list<shared_ptr<Node>>& readers, std::list<shared_ptr<type::unit::item::Field>>* elided = nullptr);
+
     /// Compiles an AST into an LLVM module. This is the main interface to
     /// the code generater. The AST must have passed through finalize().
     /// After compilation, it needs to be linked with linkModules().
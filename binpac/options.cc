@@ -24,13 +24,17 @@ Options::string_set Options::cgDebugLabels() const
 
 Options::string_set Options::optimizationLabels() const
 {
-    return hilti::Options::optimizationLabels();
+    auto labels = hilti::Options::optimizationLabels();
+    labels.insert("bulk-vectors");
+    return labels;
 }
 
 void Options::toCacheKey(::util::cache::FileCache::Key* key) const
 {
     hilti::Options::toCacheKey(key);
 
+    key->options += (elide_fields ? "E" : "e");
+
     for ( auto d : libdirs_pac2 )
         key->dirs.insert(d);
 }
@@ -23,6 +23,12 @@ public:
     /// HILTI library directories (in that order).
     string_list libdirs_pac2;
 
+    /// If true, a host application that knows all code accessing its
+    /// units may call CompilerContext::elideUnusedFields() to skip storing
+    /// fields nobody reads. This option records that choice so that it
+    /// becomes part of the cache key.
+    bool elide_fields = false;
+
     string_set cgDebugLabels() const override;
     string_set optimizationLabels() const override;
     void toCacheKey(::util::cache::FileCache::Key* key) const override;
@@ -0,0 +1,196 @@
+
+#include "../declaration.h"
+#include "../expression.h"
+#include "../function.h"
+#include "../statement.h"
+#include "../type.h"
+
+#include "field-usage.h"
+
+using namespace binpac;
+using namespace binpac::passes;
+
+FieldUsage::FieldUsage() : Pass<AstInfo>("binpac::FieldUsage", false)
+{
+}
+
+FieldUsage::~FieldUsage()
+{
+}
+
+bool FieldUsage::run(shared_ptr<ast::NodeBase> ast)
+{
+    _accounted.clear();
+    return processAllPreOrder(ast);
+}
+
+FieldUsage::field_list FieldUsage::elide(shared_ptr<Module> module)
+{
+    field_list elided;
+
+    if ( _unresolved )
+        return elided;
+
+    // Using a unit as a whole also uses all units nested inside it.
+    for ( auto u : std::set<type::Unit*>(_whole) )
+        _markWhole(u);
+
+    for ( auto d : module->body()->declarations() ) {
+        auto t = ast::tryCast<declaration::Type>(d);
+
+        if ( ! t )
+            continue;
+
+        auto unit = ast::tryCast<type::Unit>(t->type());
+
+        if ( ! unit )
+            continue;
+
+        if ( _whole.find(unit.get()) != _whole.end() )
+            continue;
+
+        for ( auto i : unit->items() ) {
+            auto f = ast::tryCast<type::unit::item::Field>(i);
+
+            if ( ! f || _keep(unit, f) )
+                continue;
+
+            if ( _reads.find(std::make_pair(unit.get(), f->id()->name())) != _reads.end() )
+                continue;
+
+            f->setTransient();
+            elided.push_back(f);
+        }
+    }
+
+    return elided;
+}
+
+bool FieldUsage::_keep(shared_ptr<type::Unit> unit, shared_ptr<type::unit::item::Field> f)
+{
+    if ( f->anonymous() || f->aliased() || f->transient() )
+        return true;
+
+    if ( ! f->type() || ast::isA<type::Void>(f->type()) )
+        return true;
+
+    // Switches store their cases' fields in a union that we don't rewrite.
+    if ( ast::isA<type::unit::item::field::Switch>(f) )
+        return true;
+
+    auto name = f->id()->name();
+
+    if ( _hooked.find(std::make_pair(unit.get(), name)) != _hooked.end() )
+        return true;
+
+    // A non-foreach hook sees the field's final value.
+    for ( auto h : f->hooks() ) {
+        if ( ! h->foreach() )
+            return true;
+    }
+
+    for ( auto g : unit->globalHooks() ) {
+        if ( g->id()->local() != name )
+            continue;
+
+        for ( auto h : g->hooks() ) {
+            if ( ! h->foreach() )
+                return true;
+        }
+    }
+
+    return false;
+}
+
+void FieldUsage::_markWhole(type::Unit* unit)
+{
+    _whole.insert(unit);
+
+    for ( auto i : unit->flattenedItems() ) {
+        if ( ! i->type() )
+            continue;
+
+        auto ftype = i->fieldType();
+
+        if ( auto c = ast::type::tryTrait<type::trait::Container>(ftype) )
+            ftype = c->elementType();
+
+        auto sub = ast::tryCast<type::Unit>(ftype);
+
+        if ( sub && _whole.find(sub.get()) == _whole.end() )
+            _markWhole(sub.get());
+    }
+}
+
+void FieldUsage::visit(Expression* e)
+{
+    auto unit = ast::tryCast<type::Unit>(e->type());
+
+    if ( ! unit )
+        return;
+
+    // We get here for the operand only after its operator has been visited,
+    // so anything not accounted for by an operator uses the unit as a whole.
+    if ( _accounted.find(e) != _accounted.end() )
+        return;
+
+    _whole.insert(unit.get());
+}
+
+void FieldUsage::visit(expression::ResolvedOperator* o)
+{
+    switch ( o->kind() ) {
+     case operator_::Attribute:
+     case operator_::HasAttribute:
+     case operator_::TryAttribute:
+     case operator_::AttributeAssign:
+     case operator_::MethodCall:
+        break;
+
+     default:
+        return;
+    }
+
+    auto op1 = o->op1();
+    auto unit = ast::tryCast<type::Unit>(op1->type());
+
+    if ( ! unit )
+        return;
+
+    _accounted.insert(op1.get());
+
+    // Method calls on units don't touch fields, and assignments only write.
+    if ( o->kind() == operator_::MethodCall || o->kind() == operator_::AttributeAssign )
+        return;
+
+    // A container's own push_back hook doesn't count as a reader.
+    auto hook = current<Hook>();
+
+    if ( hook && _push_hooks.find(hook.get()) != _push_hooks.end() )
+        return;
+
+    auto attr = ast::checkedCast<expression::MemberAttribute>(o->op2());
+    _reads.insert(std::make_pair(unit.get(), attr->id()->name()));
+}
+
+void FieldUsage::visit(expression::UnresolvedOperator* o)
+{
+    // We can't tell what this accesses.
+    _unresolved = true;
+}
+
+void FieldUsage::visit(declaration::Hook* h)
+{
+    auto hook = h->hook();
+
+    if ( hook->foreach() || ! hook->unit() )
+        return;
+
+    _hooked.insert(std::make_pair(hook->unit().get(), h->id()->local()));
+}
+
+void FieldUsage::visit(type::unit::item::field::Container* c)
+{
+    if ( c->pushBackHook() )
+        _push_hooks.insert(c->pushBackHook().get());
+}
@@ -0,0 +1,76 @@
+
+#ifndef BINPAC_PASSES_FIELD_USAGE_H
+#define BINPAC_PASSES_FIELD_USAGE_H
+
+#include <ast/pass.h>
+
+#include "../common.h"
+#include "../ast-info.h"
+
+namespace binpac {
+namespace passes {
+
+/// Determines which unit fields are ever read, and turns those that aren't
+/// into transient fields. The pass first needs to see all code that could
+/// access a unit's fields (the unit's own module, any other modules using
+/// it, and any host-generated code); run() can be called multiple times for
+/// that. elide() then marks fields that none of that code reads as
+/// transient, so that the parser just advances over them without storing
+/// their values.
+///
+/// The analysis is conservative: if a unit instance is used as a whole
+/// (e.g., passed to a function or printed), all of its fields count as
+/// read. Likewise, a field with a non-foreach hook is always kept. If any
+/// of the code hasn't been fully resolved, elide() doesn't change anything.
+class FieldUsage : public ast::Pass<AstInfo>
+{
+public:
+    typedef std::list<shared_ptr<type::unit::item::Field>> field_list;
+
+    FieldUsage();
+    virtual ~FieldUsage();
+
+    /// Records all field accesses in an AST.
+    ///
+    /// ast: The AST to scan. This must have been finalized.
+    ///
+    /// Returns: True if no error were encountered.
+    bool run(shared_ptr<ast::NodeBase> ast) override;
+
+    /// Marks all fields of the units declared in a module as transient that
+    /// none of the code recorded so far reads. The module itself must have
+    /// been passed to run() before.
+    ///
+    /// module: The module whose units to process.
+    ///
+    /// Returns: The fields that have been turned transient.
+    field_list elide(shared_ptr<Module> module);
+
+protected:
+    void visit(Expression* e) override;
+    void visit(expression::ResolvedOperator* o) override;
+    void visit(expression::UnresolvedOperator* o) override;
+    void visit(declaration::Hook* h) override;
+    void visit(type::unit::item::field::Container* c) override;
+
+private:
+    typedef std::pair<type::Unit*, string> field_ref;
+
+    // Returns true if the field must be stored no matter whether it's read.
+    bool _keep(shared_ptr<type::Unit> unit, shared_ptr<type::unit::item::Field> f);
+
+    // Records a unit, and all units nested inside it, as used as a whole.
+    void _markWhole(type::Unit* unit);
+
+    std::set<field_ref> _reads;
+    std::set<field_ref> _hooked;
+    std::set<type::Unit*> _whole;
+    std::set<Expression*> _accounted;
+    std::set<Hook*> _push_hooks;
+    bool _unresolved = false;
+};
+
+}
+}
+
+#endif
@@ -1088,6 +1088,18 @@ void unit::Item::addHook(shared_ptr<binpac::Hook> hook)
     addChild(_hooks.back());
 }
 
+void unit::Item::removeHook(shared_ptr<binpac::Hook> hook)
+{
+    for ( auto i = _hooks.begin(); i != _hooks.end(); i++ ) {
+        if ( (*i).get() != hook.get() )
+            continue;
+
+        removeChild(*i);
+        _hooks.erase(i);
+        return;
+    }
+}
+
 void unit::Item::setType(shared_ptr<binpac::Type> type)
 {
     removeChild(_type);
@@ -1187,6 +1199,11 @@ bool unit::item::Field::transient() const
     return attributes()->has("transient");
 }
 
+void unit::item::Field::setTransient()
+{
+    attributes()->add(std::make_shared<Attribute>("transient"));
+}
+
 /// Returns the item's associated condition, or null if none.
 shared_ptr<Expression> unit::item::Field::condition() const
 {
@@ -1336,8 +1353,8 @@ unit::item::field::Container::Container(shared_ptr<ID> id,
         auto push_back = std::make_shared<expression::UnresolvedOperator>(operator_::MethodCall, ops, l);
         body_push->addStatement(std::make_shared<statement::Expression>(push_back, l));
 
-        auto hook_push = std::make_shared<binpac::Hook>(body_push, 254, false, true, l);
-        addHook(hook_push);
+        _push_hook = std::make_shared<binpac::Hook>(body_push, 254, false, true, l);
+        addHook(_push_hook);
     }
 
     // If they have an &until/&while, they also get another (even higher
@@ -1386,6 +1403,22 @@ shared_ptr<unit::item::Field> unit::item::field::Container::field() const
     return _field;
 }
 
+shared_ptr<binpac::Hook> unit::item::field::Container::pushBackHook() const
+{
+    return _push_hook;
+}
+
+void unit::item::field::Container::setTransient()
+{
+    Field::setTransient();
+
+    if ( ! _push_hook )
+        return;
+
+    removeHook(_push_hook);
+    _push_hook = nullptr;
+}
+
 unit::item::field::container::List::List(shared_ptr<ID> id,
                                         shared_ptr<Field> field,
                                         shared_ptr<Expression> cond,
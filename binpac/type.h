@@ -1225,6 +1225,9 @@ protected:
     /// resolve the AST.
     void addHook(shared_ptr<binpac::Hook> hook);
 
+    /// Removes a hook from the item.
+    void removeHook(shared_ptr<binpac::Hook> hook);
+
 private:
     bool _anonymous = false;
     bool _aliased = false;
@@ -1267,6 +1270,10 @@ public:
     /// object.
     bool transient() const;
 
+    /// Turns the field into a transient one after the AST has been
+    /// finalized. Primarily for internal use by passes::FieldUsage.
+    virtual void setTransient();
+
     shared_ptr<binpac::Type> fieldType() override;
 
     /// Create a field for parsing a type. This internally knows which field
@@ -1508,10 +1515,17 @@ public:
     /// Returns the contained field.
     shared_ptr<Field> field() const;
 
+    /// Returns the foreach hook that adds each parsed element to the
+    /// container, or null if the field is transient.
+    shared_ptr<binpac::Hook> pushBackHook() const;
+
+    void setTransient() override;
+
     ACCEPT_VISITOR(Field);
 
 private:
     node_ptr<Field> _field;
+    shared_ptr<binpac::Hook> _push_hook;
 };
 
 namespace container {
@@ -5,6 +5,7 @@
 #include <memory>
 
 #include <glob.h>
+#include <dlfcn.h>
 
 extern "C" {
 #include <libbinpac/libbinpac++.h>
@@ -166,6 +167,7 @@ struct bro::hilti::Pac2EventInfo
 	shared_ptr<::binpac::type::Unit> unit_type;	// The BinPAC++ type of referenced unit.
 	shared_ptr<::binpac::Module> unit_module;       // The module the referenced unit is defined in.
 	shared_ptr<::binpac::declaration::Hook> pac2_hook;	// The generated BinPAC hook.
+	shared_ptr<::binpac::Statement> pac2_condition;	// The hook's check of the event's condition, if any.
 	shared_ptr<::hilti::declaration::Function> hilti_raise;	// The generated HILTI raise() function.
 	shared_ptr<Pac2ModuleInfo> minfo;		// The module the event was defined in.
 	BroType* bro_event_type;                        // The type of the Bro event.
@@ -198,6 +200,8 @@ struct Manager::PIMPL
 	bool save_pac2;		// Saves all generated BinPAC++ modules into a file, set from BifConst::Hilti::save_pac2.
 	bool save_hilti;	// Saves all HILTI modules into a file, set from BifConst::Hilti::save_hilti.
 	bool save_llvm;		// Saves the final linked LLVM code into a file, set from BifConst::Hilti::save_llvm.
+	bool save_bundle;	// Saves the final linked LLVM bitcode plus manifest for building a bundle, set from BifConst::Hilti::save_bundle.
+	string bundle;		// Path of a precompiled bundle to load instead of JITing, set from BifConst::Hilti::bundle.
 	bool pac2_to_compiler;  // If compiling scripts, raise event hooks from BinPAC++ code directly.
 	unsigned int profile;	// True to enable run-time profiling.
 	unsigned int hilti_workers;	// Number of HILTI worker threads to spawn.
@@ -216,6 +220,7 @@ struct Manager::PIMPL
 	path_set evt_files;                             // All loaded *.evt files.
 	path_set pac2_files;                            // All loaded *.pac2 files.
 	path_set hlt_files;                             // All loaded *.hlt files specified by the user.
+	std::list<string> elided_fields;                // All unit fields turned transient, for the debug summary.
 
 	shared_ptr<::hilti::CompilerContext>         hilti_context = nullptr;
 	shared_ptr<::binpac::CompilerContext>        pac2_context = nullptr;
@@ -236,6 +241,18 @@ struct Manager::PIMPL
 	// The execution engine used for JITing llvm_linked_module.
 	llvm::ExecutionEngine* llvm_execution_engine;
 
+	// The handle of the precompiled bundle if we loaded one instead of
+	// JITing.
+	void* bundle_handle;
+
+	// The cache key of the sources as loaded, which a bundle must match.
+	util::cache::FileCache::Key bundle_key;
+
+	// The compiled script functions a loaded bundle provides, per its
+	// manifest. Takes the place of the compiler's map, as we don't
+	// compile the scripts then.
+	compiler::Compiler::function_symbol_map bundle_functions;
+
 	// Pointers to compiled script functions indxed by their unique ID.
 	std::vector<void *> native_functions;
 	};
@@ -333,6 +350,8 @@ bool Manager::InitPostScripts()
 	pimpl->save_pac2 = BifConst::Hilti::save_pac2;
 	pimpl->save_hilti = BifConst::Hilti::save_hilti;
 	pimpl->save_llvm = BifConst::Hilti::save_llvm;
+	pimpl->save_bundle = BifConst::Hilti::save_bundle;
+	pimpl->bundle = BifConst::Hilti::bundle->CheckString();
 	pimpl->pac2_to_compiler = BifConst::Hilti::pac2_to_compiler;
 	pimpl->hilti_workers = BifConst::Hilti::hilti_workers;
 
@@ -350,10 +369,25 @@ bool Manager::InitPostScripts()
 	pimpl->pac2_options->profile = BifConst::Hilti::profile;
 	pimpl->pac2_options->verify = ! BifConst::Hilti::no_verify;
 	pimpl->pac2_options->cg_debug = cg_debug;
+	pimpl->pac2_options->elide_fields = BifConst::Hilti::elide_fields;
 	pimpl->pac2_options->module_cache = BifConst::Hilti::use_cache ? ".cache" : "";
 
+	string pgo = BifConst::Hilti::pgo->CheckString();
+
+	if ( pgo.size() && pgo != "instrument" && pgo != "use" )
+		reporter::error(::util::fmt("unknown PGO mode '%s'", pgo));
+
+	if ( pgo == "use" && ! BifConst::Hilti::optimize )
+		reporter::warning("Hilti::pgo has no effect without Hilti::optimize");
+
+	pimpl->hilti_options->pgo_instrument = pimpl->pac2_options->pgo_instrument = (pgo == "instrument");
+	pimpl->hilti_options->pgo_use = pimpl->pac2_options->pgo_use = (pgo == "use");
+
+	pimpl->hilti_options->unwind_exceptions = pimpl->pac2_options->unwind_exceptions = BifConst::Hilti::unwind_exceptions;
+
 	pimpl->llvm_linked_module = nullptr;
 	pimpl->llvm_execution_engine = nullptr;
+	pimpl->bundle_handle = nullptr;
 
 	for ( auto a : pimpl->pac2_analyzers )
 		{
@@ -589,9 +623,6 @@ bool Manager::Compile()
 	assert(pre_scripts_init_run);
 	assert(post_scripts_init_run);
 
-	if ( ! CompileBroScripts() )
-		return false;
-
 	for ( auto a : pimpl->pac2_analyzers )
 		{
 		if ( a->unit_name_orig.size() )
@@ -638,6 +669,18 @@ bool Manager::Compile()
 			file_mgr->RegisterAnalyzerForMIMEType(a->tag, mt);
 		}
 
+	// Bundles are matched against the sources as loaded, before
+	// compiling adds any intermediary modules.
+	pimpl->bundle_key = CacheKeyForLinkedModule();
+
+	// If we have a precompiled bundle matching our sources, we skip
+	// compilation altogether, including that of the scripts.
+	if ( pimpl->bundle.size() && LoadBundle(pimpl->bundle) )
+		return InitParsersAndFunctions();
+
+	if ( ! CompileBroScripts() )
+		return false;
+
 	// See if we can short-cut this all by reusing our cache.
 	auto llvm_module = CheckCacheForLinkedModule();
 
@@ -661,6 +704,22 @@ bool Manager::Compile()
 			for ( auto d : m->dependencies )
 				m->key.files.insert(d);
 
+			if ( pimpl->pac2_options->elide_fields )
+				{
+				// Which fields we elide depends on all the code
+				// that could access the module's units.
+				m->key.options += "E";
+
+				for ( auto o : pimpl->pac2_modules )
+					{
+					if ( o->path != "-" )
+						m->key.files.insert(o->path);
+					}
+
+				for ( auto e : pimpl->evt_files )
+					m->key.files.insert(e);
+				}
+
 			auto lms = pimpl->hilti_context->checkCache(m->key);
 
 			if ( ! lms.size() )
@@ -673,6 +732,22 @@ bool Manager::Compile()
 			}
 		}
 
+	if ( pimpl->pac2_options->elide_fields )
+		{
+		// Resolve the hooks' conditions so that we can see what they
+		// access.
+		for ( auto m : pimpl->pac2_modules )
+			pimpl->pac2_context->partialFinalize(m->pac2_module);
+
+		// We do this for cached modules as well, as the ones we still
+		// compile need to see the same unit layouts.
+		for ( auto m : pimpl->pac2_modules )
+			{
+			if ( ! ElideUnusedFields(m) )
+				return false;
+			}
+		}
+
 	// Compile all the *.pac2 modules.
 	for ( auto m : pimpl->pac2_modules )
 		{
@@ -885,6 +960,9 @@ bool Manager::Compile()
 
 	llvm_module->setModuleIdentifier("__bro_linked__");
 
+	if ( pimpl->save_bundle && ! SaveBundle(llvm_module, "bro.bc", "bro.manifest") )
+		return false;
+
 	pimpl->llvm_linked_module = llvm_module;
 	pimpl->hilti_context->updateCache(CacheKeyForLinkedModule(), llvm_module);
 
@@ -943,8 +1021,231 @@ bool Manager::RunJIT(llvm::Module* llvm_module)
 		return false;
 		}
 
+	pimpl->llvm_linked_module = llvm_module;
 	pimpl->llvm_execution_engine = ee;
 
+	InitRuntimeConfig();
+
+	hlt_init_jit(hilti_context, llvm_module, ee);
+	binpac_init();
+	binpac_init_jit(hilti_context, llvm_module, ee);
+
+	return InitParsersAndFunctions();
+	}
+
+bool Manager::LoadBundle(const string& path)
+	{
+	PLUGIN_DBG_LOG(HiltiPlugin, "Loading precompiled bundle %s", path.c_str());
+
+	auto manifest = ::util::endsWith(path, ".so")
+		? path.substr(0, path.size() - 3) + ".manifest"
+		: path + ".manifest";
+
+	std::ifstream in(manifest);
+
+	if ( ! in )
+		{
+		reporter::warning(::util::fmt("cannot open bundle manifest %s, compiling instead", manifest));
+		return false;
+		}
+
+	string magic;
+	std::getline(in, magic);
+
+	if ( magic != "hilti-bundle v1" )
+		{
+		reporter::warning(::util::fmt("%s is not a bundle manifest, compiling instead", manifest));
+		return false;
+		}
+
+	std::list<string> symbols;
+	std::set<string> parsers;
+	std::set<string> hooks;
+	compiler::Compiler::function_symbol_map functions;
+
+	while ( in.good() )
+		{
+		string line;
+		std::getline(in, line);
+
+		if ( line == "key" )
+			break;
+
+		auto l = ::util::strsplit(line);
+		std::vector<string> m(l.begin(), l.end());
+
+		if ( m.size() >= 2 && m[0] == "function" )
+			{
+			symbols.push_back(m[1]);
+
+			if ( m.size() < 3 )
+				continue;
+
+			// A compiled script function; it must still exist.
+			auto id = ::global_scope()->Lookup(m[2].c_str());
+
+			if ( ! (id && id->HasVal() && id->ID_Val()->Type()->Tag() == TYPE_FUNC) )
+				{
+				reporter::warning(::util::fmt("bundle %s provides unknown script function %s, compiling instead", path, m[2]));
+				return false;
+				}
+
+			functions[m[1]] = id->ID_Val()->AsFunc();
+			}
+
+		else if ( m.size() >= 2 && m[0] == "parser" )
+			parsers.insert(m[1]);
+
+		else if ( m.size() >= 3 && m[0] == "hook" )
+			hooks.insert(m[1] + " " + m[2]);
+		}
+
+	// The cache key describing the sources follows last. If it
+	// doesn't match what we have loaded, the bundle is outdated and
+	// we compile the current sources instead.
+	util::cache::FileCache::Key key;
+	in >> key;
+	key._timestamp = ::util::cache::modificationTime(manifest);
+
+	if ( ! key.valid() || key != pimpl->bundle_key )
+		{
+		reporter::warning(::util::fmt("bundle %s does not match the currently loaded sources, compiling instead", path));
+		return false;
+		}
+
+	// The key covers the files, but the analyzers and events we have
+	// configured must also be the ones the bundle has been built for.
+	if ( parsers != BundleParsers() || hooks != BundleHooks() )
+		{
+		reporter::warning(::util::fmt("bundle %s has been built for different analyzers or events, compiling instead", path));
+		return false;
+		}
+
+	// RTLD_GLOBAL isn't needed: the bundle resolves references to
+	// Bro and to the plugin against the process, but we look up
+	// everything inside it through the handle.
+	auto handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+
+	if ( ! handle )
+		{
+		reporter::warning(::util::fmt("cannot load bundle %s: %s, compiling instead", path, dlerror()));
+		return false;
+		}
+
+	for ( auto s : symbols )
+		{
+		if ( ! dlsym(handle, s.c_str()) )
+			{
+			reporter::warning(::util::fmt("bundle %s lacks function %s listed in manifest, compiling instead", path, s));
+			dlclose(handle);
+			return false;
+			}
+		}
+
+	pimpl->bundle_handle = handle;
+	pimpl->bundle_functions = functions;
+
+	InitRuntimeConfig();
+
+	hlt_init_bundle(handle);
+	binpac_init();
+	binpac_init_bundle(handle);
+
+	return true;
+	}
+
+bool Manager::SaveBundle(llvm::Module* llvm_module, const string& bc, const string& manifest)
+	{
+	PLUGIN_DBG_LOG(HiltiPlugin, "Saving bitcode for bundle to %s", bc.c_str());
+
+	ofstream out(bc);
+
+	if ( ! (out && pimpl->hilti_context->writeBitcode(llvm_module, out)) )
+		{
+		reporter::error(::util::fmt("cannot write bundle bitcode to %s", bc));
+		return false;
+		}
+
+	out.close();
+
+	ofstream mout(manifest);
+
+	if ( ! mout )
+		{
+		reporter::error(::util::fmt("cannot write bundle manifest to %s", manifest));
+		return false;
+		}
+
+	// The format is line-based: a magic line, one line per entry point,
+	// then the cache key of the sources the bundle has been built from.
+	mout << "hilti-bundle v1" << std::endl;
+	mout << "function binpac_parsers" << std::endl;
+
+	for ( auto p : BundleParsers() )
+		mout << "parser " << p << std::endl;
+
+	for ( auto h : BundleHooks() )
+		mout << "hook " << h << std::endl;
+
+	if ( pimpl->compile_scripts )
+		{
+		for ( auto i : pimpl->compiler->HiltiFunctionSymbolMap() )
+			mout << "function " << i.first << " " << i.second->Name() << std::endl;
+		}
+
+	mout << "key" << std::endl;
+	mout << pimpl->bundle_key;
+	mout.close();
+
+	return true;
+	}
+
+std::set<string> Manager::BundleParsers()
+	{
+	std::set<string> parsers;
+
+	for ( auto a : pimpl->pac2_analyzers )
+		{
+		if ( a->unit_name_orig.size() )
+			parsers.insert(a->unit_name_orig);
+
+		if ( a->unit_name_resp.size() )
+			parsers.insert(a->unit_name_resp);
+		}
+
+	for ( auto a : pimpl->pac2_file_analyzers )
+		{
+		if ( a->unit_name.size() )
+			parsers.insert(a->unit_name);
+		}
+
+	return parsers;
+	}
+
+std::set<string> Manager::BundleHooks()
+	{
+	std::set<string> hooks;
+
+	for ( auto ev : pimpl->pac2_events )
+		hooks.insert(ev->hook + " " + ev->name);
+
+	return hooks;
+	}
+
+void* Manager::NativeFunction(const string& symbol)
+	{
+	if ( pimpl->bundle_handle )
+		return dlsym(pimpl->bundle_handle, symbol.c_str());
+
+	assert(pimpl->llvm_linked_module && pimpl->llvm_execution_engine);
+
+	return pimpl->hilti_context->nativeFunction(pimpl->llvm_linked_module,
+						    pimpl->llvm_execution_engine,
+						    symbol);
+	}
+
+void Manager::InitRuntimeConfig()
+	{
 	PLUGIN_DBG_LOG(HiltiPlugin, "Initializing HILTI runtime");
 
 	hlt_config cfg = *hlt_config_get();
@@ -952,11 +1253,10 @@ bool Manager::RunJIT(llvm::Module* llvm_module)
 	cfg.profiling = pimpl->profile;
 	cfg.num_workers = pimpl->hilti_workers;
 	hlt_config_set(&cfg);
+	}
 
-	hlt_init_jit(hilti_context, llvm_module, ee);
-	binpac_init();
-	binpac_init_jit(hilti_context, llvm_module, ee);
-
+bool Manager::InitParsersAndFunctions()
+	{
 	PLUGIN_DBG_LOG(HiltiPlugin, "Retrieving binpac_parsers() function");
 
 #ifdef BRO_PLUGIN_HAVE_PROFILING
@@ -964,7 +1264,7 @@ bool Manager::RunJIT(llvm::Module* llvm_module)
 #endif
 
 	typedef hlt_list* (*binpac_parsers_func)(hlt_exception** excpt, hlt_execution_context* ctx);
-	auto binpac_parsers = (binpac_parsers_func)hilti_context->nativeFunction(llvm_module, ee, "binpac_parsers");
+	auto binpac_parsers = (binpac_parsers_func)NativeFunction("binpac_parsers");
 
 #ifdef BRO_PLUGIN_HAVE_PROFILING
 	profile_update(PROFILE_JIT_LAND, PROFILE_STOP);
@@ -986,38 +1286,32 @@ bool Manager::RunJIT(llvm::Module* llvm_module)
 	// Record them with our analyzers.
 	ExtractParsers(parsers);
 
-	// Cache the native functions for compiled script code.
-	if ( pimpl->compile_scripts )
-		{
-		PLUGIN_DBG_LOG(HiltiPlugin, "Caching native script functions");
+	// Cache the trampolines for compiled script code and custom event
+	// handlers, so that calls don't need to look them up.
+	PLUGIN_DBG_LOG(HiltiPlugin, "Caching native script functions");
 
 #ifdef BRO_PLUGIN_HAVE_PROFILING
-		profile_update(PROFILE_JIT_LAND, PROFILE_START);
+	profile_update(PROFILE_JIT_LAND, PROFILE_START);
 #endif
 
-		for ( auto i : pimpl->compiler->HiltiFunctionSymbolMap() )
-			{
-			auto symbol = i.first;
-			auto func = i.second;
-
-			auto native = pimpl->hilti_context->nativeFunction(pimpl->llvm_linked_module,
-									 pimpl->llvm_execution_engine,
-									 symbol);
+	auto& functions = pimpl->bundle_handle ? pimpl->bundle_functions
+					       : pimpl->compiler->HiltiFunctionSymbolMap();
 
-			auto id = func->GetUniqueFuncID();
+	for ( auto i : functions )
+		{
+		auto symbol = i.first;
+		auto func = i.second;
 
-			if ( pimpl->native_functions.size() <= id )
-				pimpl->native_functions.resize(id + 1);
+		auto native = NativeFunction(symbol);
 
-			pimpl->native_functions[id] = native;
+		RegisterNativeFunction(func, native);
 
-			PLUGIN_DBG_LOG(HiltiPlugin, "    %s -> %s at %p", func->Name(), symbol.c_str(), native);
-			}
+		PLUGIN_DBG_LOG(HiltiPlugin, "    %s -> %s at %p", func->Name(), symbol.c_str(), native);
+		}
 
 #ifdef BRO_PLUGIN_HAVE_PROFILING
-		profile_update(PROFILE_JIT_LAND, PROFILE_STOP);
+	profile_update(PROFILE_JIT_LAND, PROFILE_STOP);
 #endif
-		}
 
 	// Done, print out debug summary if requested.
 
@@ -1074,6 +1368,9 @@ util::cache::FileCache::Key Manager::CacheKeyForLinkedModule()
 	for ( auto m : pimpl->evt_files )
 		key.files.insert(m);
 
+	if ( pimpl->pac2_context->options().pgo_use )
+		key.files.insert(pimpl->hilti_context->profileDataFile("__bro_linked__"));
+
 	for ( auto d : pimpl->import_paths )
 		key.dirs.insert(d);
 
@@ -2195,6 +2492,7 @@ bool Manager::CreatePac2Hook(Pac2EventInfo* ev)
 		auto if_ = std::make_shared<::binpac::statement::IfElse>(not_, return_);
 
 		body->addStatement(if_);
+		ev->pac2_condition = if_;
 		}
 
 	// Raise the event.
@@ -2250,6 +2548,49 @@ bool Manager::CreatePac2Hook(Pac2EventInfo* ev)
 	return true;
 	}
 
+bool Manager::ElideUnusedFields(shared_ptr<Pac2ModuleInfo> minfo)
+	{
+	std::list<shared_ptr<::binpac::Node>> readers;
+
+	for ( auto m : pimpl->pac2_modules )
+		{
+		if ( m != minfo )
+			readers.push_back(m->module);
+		}
+
+	// The generated hooks pass the unit on to the HILTI raise functions
+	// as a whole, but those only ever read from it through the
+	// accessors. So we look at just those, plus any conditions.
+	for ( auto ev : pimpl->pac2_events )
+		{
+		if ( ! ev->pac2_hook )
+			continue;
+
+		if ( ev->pac2_condition )
+			readers.push_back(ev->pac2_condition);
+
+		for ( auto acc : ev->expr_accessors )
+			{
+			if ( acc->pac2_func )
+				readers.push_back(acc->pac2_func);
+			}
+		}
+
+	std::list<shared_ptr<::binpac::type::unit::item::Field>> elided;
+
+	if ( ! minfo->context->elideUnusedFields(minfo->module, readers, &elided) )
+		return false;
+
+	for ( auto f : elided )
+		{
+		auto name = ::util::fmt("%s::%s::%s", minfo->module->id()->name(), f->unit()->id()->local(), f->id()->name());
+		PLUGIN_DBG_LOG(HiltiPlugin, "Eliding unused field %s", name.c_str());
+		pimpl->elided_fields.push_back(name);
+		}
+
+	return true;
+	}
+
 bool Manager::CreateExpressionAccessors(shared_ptr<Pac2EventInfo> ev)
 	{
 	int nr = 0;
@@ -2800,32 +3141,22 @@ bool Manager::RuntimeRaiseEvent(Event* event)
 
 ::Val* Manager::RuntimeCallFunctionInternal(const ::Func* func, val_list* args)
 	{
-	// TODO: We should cache the nativeFunction() lookup here between
-	// calls to speed it up, unless that method itself is already as fast
-	// as we would that get that way.
-
-	assert(pimpl->llvm_linked_module && pimpl->llvm_execution_engine);
-
 	auto id = func->GetUniqueFuncID();
 
 	void* native = 0;
 
-	if ( pimpl->native_functions.size() <= id )
-		pimpl->native_functions.resize(id + 1);
-
-	native = pimpl->native_functions[id];
+	if ( id < pimpl->native_functions.size() )
+		native = pimpl->native_functions[id];
 
 	if ( ! native )
 		{
 		// First try again to get it, it could be a custom user
 		// function that we haven't used yet.
-		auto symbol = pimpl->compiler->HiltiStubSymbol(func, nullptr, true);
-		native = pimpl->hilti_context->nativeFunction(pimpl->llvm_linked_module,
-							      pimpl->llvm_execution_engine,
-							      symbol);
+		auto symbol = pimpl->compiler->HiltiTrampolineSymbol(func, nullptr, true);
+		native = NativeFunction(symbol);
 
 		if ( native )
-			pimpl->native_functions[id] = native;
+			RegisterNativeFunction(func, native);
 
 		else
 			{
@@ -2842,43 +3173,9 @@ bool Manager::RuntimeRaiseEvent(Event* event)
 	profile_update(PROFILE_HILTI_LAND, PROFILE_START);
 #endif
 
-	::Val* result = nullptr;
-
-	switch ( args->length() ) {
-	case 0:
-		typedef ::Val* (*e0)(hlt_exception**, hlt_execution_context*);
-		result = (*(e0)native)(&excpt, ctx);
-		break;
-
-	case 1:
-		typedef ::Val* (*e1)(Val*, hlt_exception**, hlt_execution_context*);
-		result = (*(e1)native)((*args)[0], &excpt, ctx);
-		break;
-
-	case 2:
-		typedef ::Val* (*e2)(Val*, Val*, hlt_exception**, hlt_execution_context*);
-		result = (*(e2)native)((*args)[0], (*args)[1], &excpt, ctx);
-		break;
-
-	case 3:
-		typedef ::Val* (*e3)(Val*, Val*, Val*, hlt_exception**, hlt_execution_context*);
-		result = (*(e3)native)((*args)[0], (*args)[1], (*args)[2], &excpt, ctx);
-		break;
-
-	case 4:
-		typedef ::Val* (*e4)(Val*, Val*, Val*, Val*, hlt_exception**, hlt_execution_context*);
-		result = (*(e4)native)((*args)[0], (*args)[1], (*args)[2], (*args)[3], &excpt, ctx);
-		break;
-
-	case 5:
-		typedef ::Val* (*e5)(Val*, Val*, Val*, Val*, Val*, hlt_exception**, hlt_execution_context*);
-		result = (*(e5)native)((*args)[0], (*args)[1], (*args)[2], (*args)[3], (*args)[4], &excpt, ctx);
-		break;
-
-	default:
-		reporter::error(::util::fmt("function/event %s with %d parameters not yet supported in RuntimeCallFunction()", func->Name(), args->length()));
-		return new ::Val(0, ::TYPE_ERROR);
-	}
+	// The trampoline forwards the arguments to the function's stub.
+	typedef ::Val* (*trampoline)(val_list*, hlt_exception**, hlt_execution_context*);
+	::Val* result = (*(trampoline)native)(args, &excpt, ctx);
 
 #ifdef BRO_PLUGIN_HAVE_PROFILING
 	profile_update(PROFILE_HILTI_LAND, PROFILE_STOP);
@@ -2899,8 +3196,12 @@ bool Manager::RuntimeRaiseEvent(Event* event)
 void Manager::RegisterNativeFunction(const ::Func* func, void* native)
 	{
 	auto id = func->GetUniqueFuncID();
+
+	if ( pimpl->native_functions.size() <= id )
+		pimpl->native_functions.resize(id + 1);
+
 	pimpl->native_functions[id] = native;
-    }
+	}
 
 bool Manager::WantEvent(Pac2EventInfo* ev)
 	{
@@ -3017,6 +3318,18 @@ void Manager::DumpDebug()
 		std::cerr << "    " << uinfo->name << std::endl;
 		}
 
+	if ( pimpl->pac2_options->elide_fields )
+		{
+		std::cerr << std::endl;
+		std::cerr << "  Elided Fields" << std::endl;
+
+		for ( auto f : pimpl->elided_fields )
+			std::cerr << "    " << f << std::endl;
+
+		if ( pimpl->elided_fields.empty() )
+			std::cerr << "    none" << std::endl;
+		}
+
 	std::cerr << std::endl;
 	std::cerr << "  Events" << std::endl;
 
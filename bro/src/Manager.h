@@ -34,6 +34,7 @@
 
 #include <istream>
 #include <functional>
+#include <set>
 
 #include <analyzer/Analyzer.h>
 #include <file_analysis/Analyzer.h>
@@ -230,7 +231,12 @@ public:
 	::Val* RuntimeCallFunction(const Func* func, val_list* args);
 
 	/**
-	 * XXX
+	 * Records the native trampoline to call for a compiled function.
+	 *
+	 * @param func The Bro function.
+	 *
+	 * @param native The function's trampoline, which receives the
+	 * arguments as a \a val_list.
 	 */
 	void RegisterNativeFunction(const ::Func* func, void* native);
 
@@ -409,6 +415,17 @@ protected:
 	 */
 	bool CreateExpressionAccessors(shared_ptr<Pac2EventInfo> ev);
 
+	/**
+	 * Turns all fields of a module's units transient that neither the
+	 * grammars nor the argument expressions and conditions of any wanted
+	 * event read.
+	 *
+	 * @param minfo The module to process.
+	 *
+	 * @return True if successful.
+	 */
+	bool ElideUnusedFields(shared_ptr<Pac2ModuleInfo> minfo);
+
 	/**
 	 * Creates a BinPAC++ function for an event argument expression that
 	 * extracts the corresponding value from the parse object.
@@ -463,6 +480,66 @@ protected:
 	 */
 	bool RunJIT(llvm::Module* llvm_module);
 
+	/**
+	 * Loads and initializes a precompiled bundle instead of JITing,
+	 * skipping all LLVM processing as well as compiling the scripts.
+	 * Rejects the bundle if it hasn't been built from the currently
+	 * loaded sources, analyzers and events, or lacks any of the
+	 * functions its manifest lists.
+	 *
+	 * @param path The path to the bundle's shared object. Its manifest
+	 * is expected to be in the same place with extension \c .manifest.
+	 *
+	 * @return True if the bundle is in use; false if the caller needs
+	 * to compile the sources instead.
+	 */
+	bool LoadBundle(const string& path);
+
+	/**
+	 * Writes out the final linked module's bitcode along with a
+	 * manifest describing its entry points, as input for building a
+	 * precompiled bundle.
+	 *
+	 * @param llvm_module The final linked module.
+	 *
+	 * @param bc The path to write the bitcode to.
+	 *
+	 * @param manifest The path to write the manifest to.
+	 */
+	bool SaveBundle(llvm::Module* llvm_module, const string& bc, const string& manifest);
+
+	/**
+	 * Returns the unit types of all configured analyzers, as recorded
+	 * in a bundle's manifest.
+	 */
+	std::set<string> BundleParsers();
+
+	/**
+	 * Returns the hooks of all configured events along with the events'
+	 * names, as recorded in a bundle's manifest.
+	 */
+	std::set<string> BundleHooks();
+
+	/**
+	 * Returns a pointer to a compiled function, either from the JIT or
+	 * from the loaded bundle. Returns null if not found.
+	 *
+	 * @param symbol The function's symbol in the linked module.
+	 */
+	void* NativeFunction(const string& symbol);
+
+	/**
+	 * Sets the HILTI runtime configuration prior to initialization.
+	 */
+	void InitRuntimeConfig();
+
+	/**
+	 * Retrieves the parsers and compiled script functions once the
+	 * runtime has been initialized with either JITed or precompiled
+	 * code.
+	 */
+	bool InitParsersAndFunctions();
+
 	/**
 	 * Returns the cache key to use for looking up / storing the final
 	 * linked module.
@@ -15,6 +15,8 @@ extern "C" {
 #include "Manager.h"
 #include "LocalReporter.h"
 
+namespace BifConst { namespace Hilti { extern int memory_regions; } }
+
 using namespace bro::hilti;
 using namespace binpac;
 
@@ -129,6 +131,9 @@ int Pac2_Analyzer::FeedChunk(int len, const u_char* data, bool is_orig, bool eod
 		if ( eod )
 			hlt_bytes_freeze(endp->data, 1, &excpt, ctx);
 
+		if ( BifConst::Hilti::memory_regions )
+			hlt_memory_region_begin(ctx);
+
 #ifdef BRO_PLUGIN_HAVE_PROFILING
 		profile_update(PROFILE_HILTI_LAND, PROFILE_START);
 #endif
@@ -140,6 +145,9 @@ int Pac2_Analyzer::FeedChunk(int len, const u_char* data, bool is_orig, bool eod
 #endif
 
 		GC_DTOR_GENERIC(&pobj, endp->parser->type_info, ctx);
+
+		if ( BifConst::Hilti::memory_regions )
+			hlt_memory_region_end(ctx);
 		}
 
 	else
@@ -155,6 +163,9 @@ int Pac2_Analyzer::FeedChunk(int len, const u_char* data, bool is_orig, bool eod
 		if ( eod )
 			hlt_bytes_freeze(endp->data, 1, &excpt, ctx);
 
+		if ( BifConst::Hilti::memory_regions )
+			hlt_memory_region_begin(ctx);
+
 #ifdef BRO_PLUGIN_HAVE_PROFILING
 		profile_update(PROFILE_HILTI_LAND, PROFILE_START);
 #endif
@@ -167,6 +178,9 @@ int Pac2_Analyzer::FeedChunk(int len, const u_char* data, bool is_orig, bool eod
 
 		GC_DTOR_GENERIC(&pobj, endp->parser->type_info, ctx);
 		endp->resume = 0;
+
+		if ( BifConst::Hilti::memory_regions )
+			hlt_memory_region_end(ctx);
 		}
 
 	if ( excpt )
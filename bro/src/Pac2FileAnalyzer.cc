@@ -15,6 +15,8 @@ extern "C" {
 #include "Manager.h"
 #include "LocalReporter.h"
 
+namespace BifConst { namespace Hilti { extern int memory_regions; } }
+
 using namespace bro::hilti;
 using namespace binpac;
 
@@ -123,6 +125,9 @@ int Pac2_FileAnalyzer::FeedChunk(int len, const u_char* chunk, bool eod)
 		if ( eod )
 			hlt_bytes_freeze(data, 1, &excpt, ctx);
 
+		if ( BifConst::Hilti::memory_regions )
+			hlt_memory_region_begin(ctx);
+
 #ifdef BRO_PLUGIN_HAVE_PROFILING
 		profile_update(PROFILE_HILTI_LAND, PROFILE_START);
 #endif
@@ -134,6 +139,9 @@ int Pac2_FileAnalyzer::FeedChunk(int len, const u_char* chunk, bool eod)
 #endif
 
 		GC_DTOR_GENERIC(&pobj, parser->type_info, ctx);
+
+		if ( BifConst::Hilti::memory_regions )
+			hlt_memory_region_end(ctx);
 		}
 
 	else
@@ -149,6 +157,9 @@ int Pac2_FileAnalyzer::FeedChunk(int len, const u_char* chunk, bool eod)
 		if ( eod )
 			hlt_bytes_freeze(data, 1, &excpt, ctx);
 
+		if ( BifConst::Hilti::memory_regions )
+			hlt_memory_region_begin(ctx);
+
 #ifdef BRO_PLUGIN_HAVE_PROFILING
 		profile_update(PROFILE_HILTI_LAND, PROFILE_START);
 #endif
@@ -160,6 +171,9 @@ int Pac2_FileAnalyzer::FeedChunk(int len, const u_char* chunk, bool eod)
 #endif
 		GC_DTOR_GENERIC(&pobj, parser->type_info, ctx);
 		resume = 0;
+
+		if ( BifConst::Hilti::memory_regions )
+			hlt_memory_region_end(ctx);
 		}
 
 	if ( excpt )
@@ -573,6 +573,59 @@ void libbro_bro_table_insert(::TableVal* val, ::Val* k, ::Val* v, hlt_exception*
 	val->Assign(k, v);
 	}
 
+void libbro_bro_table_remove(::TableVal* val, ::Val* k, hlt_exception** excpt, hlt_execution_context* ctx)
+	{
+	Unref(val->Delete(k));
+	}
+
+// A Bro table kept in sync with a HILTI map, along with the table's
+// modification stamp at the time we last brought it up to date.
+struct table_shadow {
+	::TableVal* table;
+	uint32 last_modified;
+};
+
+static void release_table_shadow(void* obj)
+	{
+	auto shadow = static_cast<table_shadow*>(obj);
+	Unref(shadow->table);
+	delete shadow;
+	}
+
+::Val* libbro_h2b_table_shadow(hlt_map* m, hlt_exception** excpt, hlt_execution_context* ctx)
+	{
+	auto shadow = static_cast<table_shadow*>(__hlt_map_shadow(m));
+
+	if ( ! shadow )
+		return 0;
+
+	// If the Bro side has modified the table since, we can't trust it
+	// anymore and the caller converts the map from scratch.
+	if ( shadow->table->LastModified() != shadow->last_modified )
+		return 0;
+
+	Ref(shadow->table);
+	return shadow->table;
+	}
+
+void libbro_h2b_table_shadow_set(hlt_map* m, ::TableVal* t, hlt_exception** excpt, hlt_execution_context* ctx)
+	{
+	auto shadow = static_cast<table_shadow*>(__hlt_map_shadow(m));
+
+	if ( shadow && shadow->table == t )
+		{
+		shadow->last_modified = t->LastModified();
+		return;
+		}
+
+	shadow = new table_shadow;
+	shadow->table = t;
+	shadow->last_modified = t->LastModified();
+	Ref(t);
+
+	__hlt_map_set_shadow(m, shadow, release_table_shadow, ctx);
+	}
+
 ::ListVal* libbro_bro_list_new(hlt_exception** excpt, hlt_execution_context* ctx)
 	{
 	return new ListVal(::TYPE_ANY);
@@ -596,6 +649,12 @@ void libbro_bro_list_append(::ListVal* lval, ::Val* val, hlt_exception** excpt,
 	return v;
 	}
 
+::Val* libbro_bro_val_list_index(val_list* args, int64_t idx, hlt_exception** excpt, hlt_execution_context* ctx)
+	{
+	// Borrowed, like the arguments passed to the stubs directly.
+	return (*args)[idx];
+	}
+
 ::TypeList* libbro_bro_list_type_new(::BroType* pure_type, hlt_exception** excpt, hlt_execution_context* ctx)
 	{
 	return new ::TypeList(pure_type);
@@ -230,7 +230,7 @@ std::list<const ::Func *> CollectorCallback::Functions(const string& ns)
 
 void Compiler::RegisterCompiledFunction(const Func* func)
 	{
-	auto symbol = HiltiStubSymbol(func, nullptr, true);
+	auto symbol = HiltiTrampolineSymbol(func, nullptr, true);
 	hilti_function_symbol_map.insert(std::make_pair(symbol, func));
 	}
 
@@ -545,6 +545,8 @@ Compiler::module_list Compiler::CompileExternalModules()
 				mbuilder->CompileEventStub(static_cast<const ::BroFunc*>(ev));
 				popModuleBuilder();
 				}
+
+			RegisterCompiledFunction(ev);
 			}
 
 		delete handlers;
@@ -693,6 +695,11 @@ std::string Compiler::HiltiStubSymbol(const ::Func* func, shared_ptr<::hilti::Mo
 #endif
 	}
 
+std::string Compiler::HiltiTrampolineSymbol(const ::Func* func, shared_ptr<::hilti::Module> module, bool include_module)
+	{
+	return normalizeSymbol(func->Name(), "", "trampoline", module ? module->id()->name() : "", true, include_module);
+	}
+
 string Compiler::HiltiSymbol(const ::ID* id, shared_ptr<::hilti::Module> module)
 	{
 	return normalizeSymbol(id->Name(), "", "", module ? module->id()->name() : "", id->IsGlobal());
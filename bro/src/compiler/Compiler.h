@@ -144,6 +144,23 @@ public:
 	 */
 	std::string HiltiStubSymbol(const ::Func* func, shared_ptr<::hilti::Module> module, bool include_module);
 
+	/**
+	 * Returns the internal HILTI-level symbol for the trampoline of a
+	 * Bro Function. The trampoline takes the arguments as a \a val_list
+	 * and forwards them to the function's stub.
+	 *
+	 * @param func The function.
+	 *
+	 * @param module If non-null, a module to which the returned symbol
+	 * should be relative. If the function's ID has the same namespace as
+	 * the module, it will be skipped; otherwise included.
+	 *
+	 * @param include_module If true, the returned name will include the
+	 * module name and hence reoresent the symbol as visibile at the LLVM
+	 * level after linking.
+	 */
+	std::string HiltiTrampolineSymbol(const ::Func* func, shared_ptr<::hilti::Module> module, bool include_module);
+
 	/**
 	 * Returns the internal HILTI-level symbol for a Bro ID.
 	 *
@@ -199,8 +216,8 @@ public:
 	typedef std::map<std::string, const ::Func*> function_symbol_map;
 
 	/**
-	 * Returns a map mapping the HILTI symbols of all compiled scripts
-	 * functions to their corresponding Bro functions.
+	 * Returns a map mapping the HILTI symbols of the trampolines of all
+	 * compiled scripts functions to their corresponding Bro functions.
 	 */
 	const function_symbol_map& HiltiFunctionSymbolMap() const;
 
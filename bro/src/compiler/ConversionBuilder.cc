@@ -251,6 +251,28 @@ bool ConversionBuilder::IsShadowedType(const BroType* type) const
 		;
 	}
 
+bool ConversionBuilder::HasValueSemantics(const BroType* type) const
+	{
+	switch ( type->Tag() ) {
+	case TYPE_ADDR:
+	case TYPE_BOOL:
+	case TYPE_COUNT:
+	case TYPE_COUNTER:
+	case TYPE_DOUBLE:
+	case TYPE_ENUM:
+	case TYPE_INT:
+	case TYPE_INTERVAL:
+	case TYPE_PORT:
+	case TYPE_SUBNET:
+	case TYPE_TIME:
+		return true;
+
+	default:
+		// Includes strings, which are references to HILTI bytes.
+		return false;
+	}
+	}
+
 std::shared_ptr<::hilti::Expression> ConversionBuilder::HiltiGlobalForType(const char* tag,
 									   const ::BroType* type)
 	{
@@ -1383,6 +1405,36 @@ std::shared_ptr<::hilti::Expression> ConversionBuilder::HiltiToBro(shared_ptr<::
 			auto rtype = ast::checkedCast<type::Reference>(HiltiType(type));
 			auto mtype = ast::checkedCast<type::Map>(rtype->argType());
 
+			// If the map's keys and values are all held by value, we
+			// remember the table we convert it into and next time only
+			// bring that up to date. Reference values may change
+			// without the map noticing, so for those we always convert
+			// the map from scratch.
+			auto itypes = type->AsTableType()->Indices();
+			bool incremental = HasValueSemantics(type->AsTableType()->YieldType());
+
+			loop_over_list(*itypes->Types(), i)
+				incremental = incremental && HasValueSemantics((*itypes->Types())[i]);
+
+			std::shared_ptr<::hilti::builder::BlockBuilder> cached = nullptr;
+			std::shared_ptr<::hilti::builder::BlockBuilder> not_cached = nullptr;
+			std::shared_ptr<::hilti::builder::BlockBuilder> synced = nullptr;
+
+			if ( incremental )
+				{
+				Builder()->addInstruction(dst,
+							  ::hilti::instruction::flow::CallResult,
+							  ::hilti::builder::id::create("LibBro::h2b_table_shadow"),
+							  ::hilti::builder::tuple::create({ val }));
+
+				auto b = Builder()->addIfElse(dst);
+				cached = std::get<0>(b);
+				not_cached = std::get<1>(b);
+				synced = std::get<2>(b);
+
+				mbuilder->pushBuilder(not_cached);
+				}
+
 			auto cur = mbuilder->addTmp("cur", mtype->iterType());
 			auto end = mbuilder->addTmp("end", mtype->iterType());
 			auto t = mbuilder->addTmp("t", mtype->elementType());
@@ -1416,7 +1468,6 @@ std::shared_ptr<::hilti::Expression> ConversionBuilder::HiltiToBro(shared_ptr<::
 			Builder()->addInstruction(k, ::hilti::instruction::tuple::Index, t, ::hilti::builder::integer::create(0));
 			Builder()->addInstruction(v, ::hilti::instruction::tuple::Index, t, ::hilti::builder::integer::create(1));
 
-			auto itypes = type->AsTableType()->Indices();
 			const ::BroType* index_type = itypes;
 
 			if ( itypes->Types()->length() == 1 )
@@ -1440,6 +1491,109 @@ std::shared_ptr<::hilti::Expression> ConversionBuilder::HiltiToBro(shared_ptr<::
 
 			mbuilder->pushBuilder(done);
 
+			if ( ! incremental )
+				return dst;
+
+			// Start recording changes and remember the table for next time.
+			auto stype = ::hilti::builder::set::type(mtype->keyType());
+			auto changes = mbuilder->addTmp("changes", ::hilti::builder::reference::type(stype));
+
+			Builder()->addInstruction(changes, ::hilti::instruction::map::Changes, val);
+
+			Builder()->addInstruction(::hilti::instruction::flow::CallVoid,
+						  ::hilti::builder::id::create("LibBro::h2b_table_shadow_set"),
+						  ::hilti::builder::tuple::create({ val, dst }));
+
+			Builder()->addInstruction(::hilti::instruction::flow::Jump, synced->block());
+
+			mbuilder->popBuilder(done);
+
+			mbuilder->pushBuilder(cached);
+
+			// Apply what has changed since the last conversion.
+			auto ccur = mbuilder->addTmp("ccur", stype->iterType());
+			auto cend = mbuilder->addTmp("cend", stype->iterType());
+			auto exists = mbuilder->addTmp("exists", ::hilti::builder::boolean::type());
+
+			Builder()->addInstruction(changes, ::hilti::instruction::map::Changes, val);
+			Builder()->addInstruction(ccur, ::hilti::instruction::operator_::Begin, changes);
+			Builder()->addInstruction(cend, ::hilti::instruction::operator_::End, changes);
+
+			auto cloop = mbuilder->pushBuilder("changes_loop");
+
+			Builder()->addInstruction(is_end, ::hilti::instruction::operator_::Equal, ccur, cend);
+
+			auto cblocks = Builder()->addIf(is_end);
+			auto cdone = std::get<0>(cblocks);
+			auto ccont = std::get<1>(cblocks);
+
+			mbuilder->popBuilder(cloop);
+
+			mbuilder->pushBuilder(ccont);
+
+			auto ck = mbuilder->addTmp("ck", mtype->keyType());
+			Builder()->addInstruction(ck, ::hilti::instruction::operator_::Deref, ccur);
+
+			auto ckval = RuntimeHiltiToVal(ck, index_type);
+
+			Builder()->addInstruction(exists, ::hilti::instruction::map::Exists, val, ck);
+
+			auto eblocks = Builder()->addIfElse(exists);
+			auto update = std::get<0>(eblocks);
+			auto remove = std::get<1>(eblocks);
+			auto next = std::get<2>(eblocks);
+
+			mbuilder->popBuilder(ccont);
+
+			mbuilder->pushBuilder(update);
+
+			auto cv = mbuilder->addTmp("cv", mtype->valueType());
+			Builder()->addInstruction(cv, ::hilti::instruction::map::Get, val, ck);
+
+			auto cvval = RuntimeHiltiToVal(cv, type->AsTableType()->YieldType());
+
+			Builder()->addInstruction(::hilti::instruction::flow::CallVoid,
+						  ::hilti::builder::id::create("LibBro::bro_table_insert"),
+						  ::hilti::builder::tuple::create({ dst, ckval, cvval }));
+
+			BroUnref(cvval);
+
+			Builder()->addInstruction(::hilti::instruction::flow::Jump, next->block());
+
+			mbuilder->popBuilder(update);
+
+			mbuilder->pushBuilder(remove);
+
+			Builder()->addInstruction(::hilti::instruction::flow::CallVoid,
+						  ::hilti::builder::id::create("LibBro::bro_table_remove"),
+						  ::hilti::builder::tuple::create({ dst, ckval }));
+
+			Builder()->addInstruction(::hilti::instruction::flow::Jump, next->block());
+
+			mbuilder->popBuilder(remove);
+
+			mbuilder->pushBuilder(next);
+
+			BroUnref(ckval);
+
+			Builder()->addInstruction(ccur, ::hilti::instruction::operator_::Incr, ccur);
+			Builder()->addInstruction(::hilti::instruction::flow::Jump, cloop->block());
+
+			mbuilder->popBuilder(next);
+
+			mbuilder->pushBuilder(cdone);
+
+			// Remember the table's new state.
+			Builder()->addInstruction(::hilti::instruction::flow::CallVoid,
+						  ::hilti::builder::id::create("LibBro::h2b_table_shadow_set"),
+						  ::hilti::builder::tuple::create({ val, dst }));
+
+			Builder()->addInstruction(::hilti::instruction::flow::Jump, synced->block());
+
+			mbuilder->popBuilder(cdone);
+
+			mbuilder->pushBuilder(synced);
+
 			return dst;
 			});
 		}
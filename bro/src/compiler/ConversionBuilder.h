@@ -129,6 +129,13 @@ public:
 	 */
 	bool IsShadowedType(const BroType* type) const;
 
+	/**
+	 * Returns true if values of a Bro type are held by value on the
+	 * HILTI side, i.e., they can't change without a new value being
+	 * assigned.
+	 */
+	bool HasValueSemantics(const BroType* type) const;
+
 protected:
 	typedef std::function<shared_ptr<::hilti::Expression> (shared_ptr<::hilti::Expression>,
 							       const ::BroType* type)> build_conversion_function_callback;
@@ -260,6 +260,46 @@ void ModuleBuilder::CreateFunctionStub(const BroFunc* func, create_stub_callback
 	popFunction();
 
 	cacheNode("bro-function-stub", stub_name, stub);
+
+	// We also create a trampoline that takes the arguments as a
+	// val_list and forwards them to the stub. That gives the Plugin's
+	// Runtime*() methods a single signature to call for any number of
+	// arguments.
+	auto tramp_name = Compiler()->HiltiTrampolineSymbol(func, module(), false);
+	auto tramp_args = ::hilti::builder::function::parameter_list();
+
+	auto args_name = ::hilti::builder::id::node("args");
+	auto args_type = ::hilti::builder::caddr::type();
+	tramp_args.push_back(::hilti::builder::function::parameter(args_name, args_type, false, nullptr));
+
+	exportID(tramp_name);
+
+	pushFunction(tramp_name, stub_result, tramp_args, ::hilti::type::function::HILTI_C);
+
+	::hilti::builder::tuple::element_list stub_call_args;
+
+	for ( int i = 0; i < args->NumFields(); i++ )
+		{
+		auto arg = addTmp(::util::fmt("arg%d", i+1), vtype);
+
+		Builder()->addInstruction(arg,
+					  ::hilti::instruction::flow::CallResult,
+					  ::hilti::builder::id::create("LibBro::bro_val_list_index"),
+					  ::hilti::builder::tuple::create({ ::hilti::builder::id::create("args"),
+									    ::hilti::builder::integer::create(i) }));
+
+		stub_call_args.push_back(arg);
+		}
+
+	auto trval = addTmp("rval", vtype);
+
+	Builder()->addInstruction(trval,
+				  ::hilti::instruction::flow::CallResult,
+				  ::hilti::builder::id::create(stub_name),
+				  ::hilti::builder::tuple::create(stub_call_args));
+
+	Builder()->addInstruction(::hilti::instruction::flow::ReturnResult, trval);
+	popFunction();
 	}
 
 void ModuleBuilder::CompileScriptFunction(const BroFunc* func, bool exported)
@@ -374,7 +374,7 @@ llvm::Function* abi::X86_64::createFunction(const string& name, llvm::Type* rtyp
     return func;
 }
 
-llvm::Value* abi::X86_64::createCall(llvm::Value *callee, std::vector<llvm::Value *> args, llvm::Type* rtype, const arg_list& targs, type::function::CallingConvention cc)
+llvm::Value* abi::X86_64::createCall(llvm::Value *callee, std::vector<llvm::Value *> args, llvm::Type* rtype, const arg_list& targs, type::function::CallingConvention cc, llvm::BasicBlock* unwind_dest)
 {
     auto cargs = classifyArguments("", rtype, targs, cc);
 
@@ -415,11 +415,22 @@ llvm::Value* abi::X86_64::createCall(llvm::Value *callee, std::vector<llvm::Valu
         }
     }
 
-    auto ci = cg()->llvmCreateCall(callee, nargs);
     auto llvm_cc = cg()->llvmCallingConvention(cc);
-    ci->setCallingConv(llvm_cc);
+    llvm::Value* result = nullptr;
+
+    if ( unwind_dest ) {
+        auto normal = cg()->newBuilder("invoke-cont");
+        auto ii = cg()->llvmCreateInvoke(callee, nargs, normal->GetInsertBlock(), unwind_dest);
+        ii->setCallingConv(llvm_cc);
+        cg()->pushBuilder(normal); // Leave on stack.
+        result = ii;
+    }
 
-    llvm::Value* result = ci;
+    else {
+        auto ci = cg()->llvmCreateCall(callee, nargs);
+        ci->setCallingConv(llvm_cc);
+        result = ci;
+    }
 
     if ( cargs.return_in_mem )
         result = cg()->builder()->CreateLoad(agg_ret);
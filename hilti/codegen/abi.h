@@ -28,7 +28,11 @@ public:
    virtual llvm::FunctionType* createFunctionType(llvm::Type* rtype, const ABI::arg_list& args, type::function::CallingConvention cc) = 0;
 
    /// XXX
-   virtual llvm::Value* createCall(llvm::Value *callee, std::vector<llvm::Value *> args, llvm::Type* rtype, const arg_list& targs, type::function::CallingConvention cc) = 0;
+   ///
+   /// unwind_dest: If given, the call is emitted as an \c invoke that
+   /// continues at this block if the callee unwinds. The normal
+   /// continuation then becomes the current builder (left on the stack).
+   virtual llvm::Value* createCall(llvm::Value *callee, std::vector<llvm::Value *> args, llvm::Type* rtype, const arg_list& targs, type::function::CallingConvention cc, llvm::BasicBlock* unwind_dest = nullptr) = 0;
 
    /// XXX
    CodeGen* cg() const { return _cg; }
@@ -76,7 +80,7 @@ public:
 
    llvm::Function* createFunction(const string& name, llvm::Type* rtype, const ABI::arg_list& args, llvm::GlobalValue::LinkageTypes linkage, llvm::Module* module, type::function::CallingConvention cc) override;
    llvm::FunctionType* createFunctionType(llvm::Type* rtype, const arg_list& args, type::function::CallingConvention cc) override;
-   llvm::Value* createCall(llvm::Value *callee, std::vector<llvm::Value *> args, llvm::Type* rtype, const arg_list& targs, type::function::CallingConvention cc) override;
+   llvm::Value* createCall(llvm::Value *callee, std::vector<llvm::Value *> args, llvm::Type* rtype, const arg_list& targs, type::function::CallingConvention cc, llvm::BasicBlock* unwind_dest = nullptr) override;
 
    string dataLayout() const override;
 
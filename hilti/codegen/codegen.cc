@@ -17,6 +17,7 @@
 #include "abi.h"
 #include "debug-info-builder.h"
 #include "../passes/collector.h"
+#include "../passes/refcount-elision.h"
 #include "../builder/nodes.h"
 
 #include "libhilti/enum.h"
@@ -420,7 +421,7 @@ void CodeGen::llvmStore(statement::Instruction* instr, llvm::Value* value, bool
     _storer->llvmStore(instr->target(), value, false, dtor_first);
 }
 
-llvm::Function* CodeGen::pushFunction(llvm::Function* function, bool push_builder, bool abort_on_excpt, bool is_init_func, type::function::CallingConvention cc)
+llvm::Function* CodeGen::pushFunction(llvm::Function* function, bool push_builder, bool abort_on_excpt, bool is_init_func, type::function::CallingConvention cc, bool unwind)
 {
     unique_ptr<FunctionState> state(new FunctionState);
     state->function = function;
@@ -429,6 +430,7 @@ llvm::Function* CodeGen::pushFunction(llvm::Function* function, bool push_builde
     state->is_init_func = is_init_func;
     state->context = nullptr;
     state->cc = cc;
+    state->unwind = unwind;
     _functions.push_back(std::move(state));
 
     if ( push_builder )
@@ -1619,6 +1621,89 @@ llvm::Function* CodeGen::llvmFunctionHookRun(shared_ptr<Hook> hook)
     return func;
 }
 
+bool CodeGen::unwindsExceptions(shared_ptr<Function> func)
+{
+    if ( ! options().unwind_exceptions || options().profile )
+        return false;
+
+    if ( ast::isA<Hook>(func) || ! func->body() )
+        return false;
+
+    if ( func->type()->callingConvention() != type::function::HILTI )
+        return false;
+
+    // We can only rely on the landing pads of code we generate ourselves.
+    return func->module() == _hilti_module;
+}
+
+llvm::Function* CodeGen::llvmFunctionUnwind(shared_ptr<Function> func)
+{
+    assert(unwindsExceptions(func));
+
+    auto wrapper = llvmFunction(func);
+    auto name = wrapper->getName().str() + ".unwind";
+
+    auto body = _module->getFunction(name);
+
+    if ( body )
+        return body;
+
+    body = llvm::Function::Create(wrapper->getFunctionType(), llvm::Function::InternalLinkage, name, _module);
+    body->setCallingConv(wrapper->getCallingConv());
+    body->setAttributes(wrapper->getAttributes());
+
+    // Parameters are looked up by name.
+    auto a = body->arg_begin();
+
+    for ( auto w = wrapper->arg_begin(); w != wrapper->arg_end(); ++w, ++a )
+        a->setName(w->getName());
+
+    return body;
+}
+
+void CodeGen::llvmBuildUnwindWrapper(shared_ptr<Function> func)
+{
+    auto wrapper = llvmFunction(func);
+    auto body = llvmFunctionUnwind(func);
+    auto rtype = wrapper->getReturnType();
+
+    pushFunction(wrapper, true, false, false, func->type()->callingConvention());
+
+    std::vector<llvm::Value*> args;
+
+    for ( auto a = wrapper->arg_begin(); a != wrapper->arg_end(); ++a )
+        args.push_back(a);
+
+    auto cont = newBuilder("unwind-cont");
+    auto lpad = newBuilder("excpt-unwind");
+
+    auto result = llvmCreateInvoke(body, args, cont->GetInsertBlock(), lpad->GetInsertBlock());
+    result->setAttributes(body->getAttributes());
+
+    pushBuilder(cont);
+
+    if ( rtype->isVoidTy() )
+        builder()->CreateRetVoid();
+    else
+        builder()->CreateRet(result);
+
+    popBuilder();
+
+    // The exception is still set in the execution context, where our caller
+    // will find it.
+    pushBuilder(lpad);
+    llvmCreateLandingPad();
+
+    if ( rtype->isVoidTy() )
+        builder()->CreateRetVoid();
+    else
+        builder()->CreateRet(llvmConstNull(rtype));
+
+    popBuilder();
+
+    popFunction();
+}
+
 void CodeGen::llvmAddHookMetaData(shared_ptr<Hook> hook, llvm::Value *llvm_func)
 {
     std::vector<llvm::Value *> vals;
@@ -1808,15 +1893,70 @@ void CodeGen::llvmAdaptStackForSafepoint(bool pre)
     if ( ! pre )
         llvmCreateStackmap();
 
+    auto rce = hiltiModule()->refCountElision();
+    auto carry_out = rce ? rce->carryOut(_stmt_builder->currentStatement()) : passes::RefCountElision::variable_set();
+    auto& carried = _functions.back()->locals_carried;
+
     for ( auto l : liveValues() ) {
         auto val = std::get<0>(l);
         auto type = std::get<1>(l);
         auto is_ptr = std::get<2>(l);
+        auto var = std::get<3>(l);
 
-        if ( pre )
+        // Values carried over from an earlier safepoint still hold their
+        // reference.
+        if ( carried.find(var->name) != carried.end() )
+            continue;
+
+        if ( pre ) {
             llvmCctor(val, type, is_ptr, "adapt-for-savepoint-pre");
-        else
-            llvmDtor(val, type, is_ptr, "adapt-for-savepoint-post");
+            continue;
+        }
+
+        if ( carry_out.find(var) != carry_out.end() ) {
+            // Keep the reference until the next safepoint is done.
+            carried.insert(std::make_pair(var->name, l));
+            continue;
+        }
+
+        llvmDtor(val, type, is_ptr, "adapt-for-savepoint-post");
+    }
+}
+
+void CodeGen::llvmReleaseLocalsCarriedOverSafepoints()
+{
+    auto rce = hiltiModule()->refCountElision();
+
+    if ( ! rce || _functions.empty() || _functions.back()->locals_carried.empty() )
+        return;
+
+    auto stmt = _stmt_builder->currentStatement();
+    auto release = rce->release(stmt);
+    auto carry_out = rce->carryOut(stmt);
+
+    for ( auto v : release ) {
+        if ( carry_out.find(v) != carry_out.end() )
+            continue;
+
+        auto& carried = _functions.back()->locals_carried;
+        auto i = carried.find(v->name);
+
+        if ( i == carried.end() )
+            continue;
+
+        auto l = i->second;
+        carried.erase(i);
+
+        // If the statement ended the block, release before leaving it.
+        auto term = block()->getTerminator();
+
+        if ( term )
+            builder()->SetInsertPoint(term);
+
+        llvmDtor(std::get<0>(l), std::get<1>(l), std::get<2>(l), "release-carried-over-safepoints");
+
+        if ( term )
+            builder()->SetInsertPoint(block());
     }
 }
 
@@ -1844,7 +1984,7 @@ CodeGen::live_list CodeGen::liveValues()
                 continue;
 
             assert(val);
-            lives.push_back(std::make_tuple(val, type, true));
+            lives.push_back(std::make_tuple(val, type, true, l));
         }
     }
 
@@ -2197,6 +2337,19 @@ void CodeGen::llvmRethrowException()
         llvmClearException();
     }
 
+    if ( _functions.back()->unwind ) {
+        // Our caller has a landing pad waiting for us instead of checking
+        // the context once we return. Clean up what the exit block would
+        // and unwind.
+        ++_in_build_exit;
+        llvmBuildFunctionCleanup();
+        --_in_build_exit;
+
+        llvmCallC("__hlt_exception_unwind", { llvmExecutionContext() }, false, false);
+        builder()->CreateUnreachable();
+        return;
+    }
+
     auto rt = func->getReturnType();
 
     if ( rt->isVoidTy() && _functions.back()->function->hasStructRetAttr() )
@@ -2391,6 +2544,13 @@ void CodeGen::llvmTriggerExceptionHandling(bool known_exception)
 
     llvmBuildInstructionCleanup(false);
 
+    // Release references kept elevated across safepoints; on this path we
+    // won't get to the statement that would normally do so.
+    for ( auto c : _functions.back()->locals_carried ) {
+        auto l = c.second;
+        llvmDtor(std::get<0>(l), std::get<1>(l), std::get<2>(l), "trigger-excpt-handling/carried");
+    }
+
     // Sort catches from most specific to least specific.
     auto catches = _functions.back()->catches;
 
@@ -2458,6 +2618,28 @@ llvm::CallInst* CodeGen::llvmCreateCall(llvm::Value *callee, const llvm::Twine &
     return util::checkedCreateCall(builder(), "CodeGen", callee, no_params, name);
 }
 
+llvm::InvokeInst* CodeGen::llvmCreateInvoke(llvm::Value *callee, llvm::ArrayRef<llvm::Value *> args, llvm::BasicBlock* normal, llvm::BasicBlock* unwind, const llvm::Twine &name)
+{
+    auto ii = builder()->CreateInvoke(callee, normal, unwind, args, name);
+
+    if ( auto f = llvm::dyn_cast<llvm::Function>(callee) )
+        ii->setCallingConv(f->getCallingConv());
+
+    return ii;
+}
+
+void CodeGen::llvmCreateLandingPad()
+{
+    // We don't need the landing pad's result, the exception itself is in the
+    // execution context.
+    std::vector<llvm::Type*> fields = { llvmTypePtr(), llvmTypeInt(32) };
+    auto lptype = llvm::StructType::get(llvmContext(), fields);
+    auto personality = llvm::ConstantExpr::getBitCast(llvmLibFunction("__hlt_personality"), llvmTypePtr());
+
+    auto lp = builder()->CreateLandingPad(lptype, personality, 0);
+    lp->setCleanup(true);
+}
+
 static void _dumpStore(llvm::Value *val, llvm::Value *ptr, const string& where, const string& msg)
 {
     llvm::raw_os_ostream os(std::cerr);
@@ -2856,9 +3038,9 @@ llvm::Value* CodeGen::llvmCallableBind(shared_ptr<Hook> hook, const expr_list ar
     return llvmDoCallableBind(nullptr, hook, hook, hook->type(), args, ref, excpt_check, deep_copy_args, cctor_callable);
 }
 
-llvm::Value* CodeGen::llvmCallableBind(shared_ptr<Function> func, shared_ptr<type::Function> ftype, const expr_list args, bool ref, bool excpt_check, bool deep_copy_args, bool cctor_callable)
+llvm::Value* CodeGen::llvmCallableBind(shared_ptr<Function> func, shared_ptr<type::Function> ftype, const expr_list args, bool ref, bool excpt_check, bool deep_copy_args, bool cctor_callable, const std::set<int>& transfer_args)
 {
-    return llvmDoCallableBind(llvmFunction(func), func, nullptr, func->type(), args, ref, true, deep_copy_args, cctor_callable);
+    return llvmDoCallableBind(llvmFunction(func), func, nullptr, func->type(), args, ref, true, deep_copy_args, cctor_callable, transfer_args);
 }
 
 llvm::Value* CodeGen::llvmCallableBind(llvm::Value* llvm_func_val, shared_ptr<type::Function> ftype, const expr_list args, bool ref, bool excpt_check, bool deep_copy_args, bool cctor_callable)
@@ -2866,7 +3048,7 @@ llvm::Value* CodeGen::llvmCallableBind(llvm::Value* llvm_func_val, shared_ptr<ty
     return llvmDoCallableBind(llvm_func_val, nullptr, nullptr, ftype, args, ref, excpt_check, deep_copy_args, cctor_callable);
 }
 
-llvm::Value* CodeGen::llvmDoCallableBind(llvm::Value* llvm_func_val, shared_ptr<Function> func, shared_ptr<Hook> hook, shared_ptr<type::Function> ftype, const expr_list args, bool result_cctor, bool excpt_check, bool deep_copy_args, bool cctor_callable)
+llvm::Value* CodeGen::llvmDoCallableBind(llvm::Value* llvm_func_val, shared_ptr<Function> func, shared_ptr<Hook> hook, shared_ptr<type::Function> ftype, const expr_list args, bool result_cctor, bool excpt_check, bool deep_copy_args, bool cctor_callable, const std::set<int>& transfer_args)
 {
     auto llvm_func = llvm_func_val ? llvm::cast<llvm::Function>(llvm_func_val) : nullptr;
     auto result = ftype->result();
@@ -2906,6 +3088,9 @@ llvm::Value* CodeGen::llvmDoCallableBind(llvm::Value* llvm_func_val, shared_ptr<
         auto val = llvmValue(args[i]);
 
         if ( deep_copy_args ) {
+            // Arguments are operands that remain accessible to the caller,
+            // so we can only transfer those it won't look at anymore.
+            auto clone = transfer_args.find(i) != transfer_args.end() ? "hlt_clone_transfer_unaliased" : "hlt_clone_deep";
             auto ti = llvmRtti(args[i]->type());
             auto src = llvmCreateAlloca(val->getType());
             auto dst = llvmCreateAlloca(val->getType());
@@ -2914,7 +3099,7 @@ llvm::Value* CodeGen::llvmDoCallableBind(llvm::Value* llvm_func_val, shared_ptr<
 
             llvmCreateStore(val, src);
             value_list vals = { dst_casted, ti, src_casted };
-            llvmCallC("hlt_clone_deep", vals, true, true);
+            llvmCallC(clone, vals, true, true);
             val = builder()->CreateLoad(dst);
         }
 
@@ -3160,6 +3345,7 @@ llvm::Value* CodeGen::llvmCallableMakeFuncs(llvm::Function* llvm_func, shared_pt
     ctyfuncval = llvmConstInsertValue(ctyfuncval, llvm_dtor_func, 2);
     ctyfuncval = llvmConstInsertValue(ctyfuncval, llvm_clone_init_func, 3);
     ctyfuncval = llvmConstInsertValue(ctyfuncval, object_size, 4);
+    ctyfuncval = llvmConstInsertValue(ctyfuncval, llvmConstInt(ftype->mayYield() ? 1 : 0, 8), 5);
 
     auto ctyfuncglob = llvmAddConst("callable.func" + name, ctyfuncval);
 
@@ -3341,6 +3527,17 @@ llvm::Value* CodeGen::llvmDoCall(llvm::Value* llvm_func, shared_ptr<Function> fu
     if ( hook )
         llvm_func = llvmFunctionHookRun(hook);
 
+    // If the callee propagates exceptions by unwinding, call its body
+    // directly and branch to a landing pad if it raises. There's no need to
+    // check the context on return then.
+    IRBuilder* lpad = nullptr;
+
+    if ( func && ! hook && excpt_check && cc == type::function::HILTI && ! _in_build_exit
+         && ! ftype->attributes().has(attribute::NOEXCEPTION) && unwindsExceptions(func) ) {
+        llvm_func = llvmFunctionUnwind(func);
+        lpad = newBuilder("excpt-unwind");
+    }
+
     // Apply calling convention.
     auto orig_args = llvm_args;
 
@@ -3356,7 +3553,33 @@ llvm::Value* CodeGen::llvmDoCall(llvm::Value* llvm_func, shared_ptr<Function> fu
     if ( ftype->mayTriggerSafepoint() )
          llvmAdaptStackForSafepoint(true);
 
-    auto result = abi()->createCall(llvm_func, llvm_args, t.first, t.second, ftype->callingConvention());
+    auto result = abi()->createCall(llvm_func, llvm_args, t.first, t.second, ftype->callingConvention(),
+                                    lpad ? lpad->GetInsertBlock() : nullptr);
+
+    if ( lpad ) {
+        // The call raised an exception. This mirrors what the normal path
+        // below does, plus the exception handling.
+        auto normal = builder();
+
+        pushBuilder(lpad);
+        llvmCreateLandingPad();
+
+        if ( ftype->mayTriggerSafepoint() )
+            llvmAdaptStackForSafepoint(false);
+
+        excpt_callback(this);
+
+        if ( _functions.back()->abort_on_excpt ) {
+            llvmBuildInstructionCleanup(false);
+            llvmCallC("__hlt_exception_print_uncaught_abort", { llvmCurrentException(), llvmExecutionContext() }, false, false);
+            builder()->CreateUnreachable();
+        }
+
+        else
+            llvmTriggerExceptionHandling(true);
+
+        pushBuilder(normal); // Leave on stack.
+    }
 
     // Back to normal
     if ( ftype->mayTriggerSafepoint() )
@@ -3383,7 +3606,7 @@ llvm::Value* CodeGen::llvmDoCall(llvm::Value* llvm_func, shared_ptr<Function> fu
         break;
 
      default:
-        if ( excpt_check && ! ftype->attributes().has(attribute::NOEXCEPTION) )
+        if ( excpt_check && ! lpad && ! ftype->attributes().has(attribute::NOEXCEPTION) )
             llvmCheckException();
         break;
     }
@@ -4283,7 +4506,16 @@ void CodeGen::llvmBlockingInstruction(statement::Instruction* i, try_func try_,
     pushBuilder(loop);
     auto result = try_(this, i);
 
-    auto blocked = llvmMatchException("Hilti::WouldBlock", llvmCurrentException());
+    // Usually the instruction doesn't raise anything at all, so check for
+    // that first before matching the exception's type.
+    auto excpt = llvmCurrentException();
+    auto is_null = llvmExpect(llvmCreateIsNull(excpt), llvmConstInt(1, 1));
+    auto match = newBuilder("blocking-match");
+    llvmCreateCondBr(is_null, done, match);
+    popBuilder();
+
+    pushBuilder(match);
+    auto blocked = llvmMatchException("Hilti::WouldBlock", excpt);
     llvmCreateCondBr(blocked, yield_, done);
     popBuilder();
 
@@ -3,6 +3,7 @@
 #define HILTI_CODEGEN_CODEGEN_H
 
 #include <list>
+#include <set>
 
 #include "common.h"
 #include "util.h"
@@ -18,6 +19,7 @@ class Variable;
 class LogComponent;
 class CompilerContext;
 class Options;
+struct FlowVariable;
 
 namespace statement { class Instruction; }
 namespace passes { class Collector; }
@@ -46,6 +48,9 @@ namespace symbols {
     static const char* MetaHookDecls    = "hlt.hook.decls";
     static const char* MetaHookImpls    = "hlt.hook.impls";
 
+    // Names of instruction meta data examined by the linker.
+    static const char* MetaHookGroupCheck = "hlt.hook.group.check";
+
     static const char* TypeGlobals      = "hlt.globals.type";
     static const char* FuncGlobalsBase  = "hlt.globals.base";
 
@@ -166,8 +171,12 @@ public:
    ///
    /// cc: The function's calling convetion; DEFAULT means "not further
    /// specified".
+   ///
+   /// unwind: If true, the function propagates exceptions by unwinding the
+   /// stack rather than returning to its caller; see unwindsExceptions().
    llvm::Function* pushFunction(llvm::Function* function, bool push_builder=true, bool abort_on_excpt=false,
-                                bool is_init_func=false, type::function::CallingConvention=type::function::DEFAULT);
+                                bool is_init_func=false, type::function::CallingConvention=type::function::DEFAULT,
+                                bool unwind=false);
 
    /// Removes the current LLVM function from the stack of function being
    /// generated. Calls to this function must match with those to
@@ -446,6 +455,35 @@ public:
    /// Returns: The function with the corresponding signature.
    llvm::Function* llvmFunctionHookRun(shared_ptr<Hook> hook);
 
+   /// Returns true if calls to a function propagate exceptions by unwinding
+   /// the stack instead of through the execution context. That's the case
+   /// with Options::unwind_exceptions for HILTI functions implemented in
+   /// the current module. Such a function's body is compiled into
+   /// llvmFunctionUnwind(), and llvmFunction() becomes a wrapper with the
+   /// standard calling protocol for everybody else.
+   ///
+   /// func: The function.
+   bool unwindsExceptions(shared_ptr<Function> func);
+
+   /// Returns the LLVM function holding the body of a function for which
+   /// unwindsExceptions() is true. It has the same signature as
+   /// llvmFunction(), but doesn't return to its caller if it raises an
+   /// exception; calls must use an \c invoke.
+   ///
+   /// func: The function.
+   ///
+   /// Returns: The LLVM function, which will be created if it doesn't
+   /// exist yet.
+   llvm::Function* llvmFunctionUnwind(shared_ptr<Function> func);
+
+   /// Builds the body of the wrapper that makes a function compiled for
+   /// unwinding callable through the standard protocol. The wrapper calls
+   /// the function and, if that raises an exception, returns with the
+   /// exception left in the execution context.
+   ///
+   /// func: The function, for which unwindsExceptions() must be true.
+   void llvmBuildUnwindWrapper(shared_ptr<Function> func);
+
    /// Returns the LLVM value for a HILTI expression.
    ///
    /// This method branches out the Loader to do its work.
@@ -1201,9 +1239,14 @@ public:
    ///
    /// cctor_callable: True if the callable should be returned at +1.
    ///
+   /// transfer_args: With *deep_copy_args*, the indices of arguments that
+   /// can be moved into the callable instead of being copied, because the
+   /// caller won't look at them anymore (see
+   /// hlt_clone_transfer_unaliased()).
+   ///
    /// Returns: The callable, which can be executed with llvmCallableRun().
    /// It will be returned at +0 or + 1, depending on cctor_callable.
-   llvm::Value* llvmCallableBind(shared_ptr<Function> func, shared_ptr<type::Function> ftype, const expr_list args, bool ref, bool excpt_check=true, bool deep_copy_args=false, bool cctor_callable = false);
+   llvm::Value* llvmCallableBind(shared_ptr<Function> func, shared_ptr<type::Function> ftype, const expr_list args, bool ref, bool excpt_check=true, bool deep_copy_args=false, bool cctor_callable = false, const std::set<int>& transfer_args = std::set<int>());
 
    /// Creates a new callable insance and binds a call to it. Arguments are
    /// the same as with the corresponding llvmCall() method.
@@ -1468,6 +1511,27 @@ public:
    /// Returns: The created call instruction.
    llvm::CallInst* llvmCreateCall(llvm::Value* callee, const llvm::Twine &name="");
 
+   /// Wrapper method to create an LLVM \c invoke instruction. Other than
+   /// llvmCreateCall(), this does not check the parameters.
+   ///
+   /// callee: The function to call.
+   ///
+   /// args: The function parameters.
+   ///
+   /// normal: The block to continue with if the call returns.
+   ///
+   /// unwind: The block to continue with if the callee unwinds the stack.
+   /// It must start with a landing pad; see llvmCreateLandingPad().
+   ///
+   /// name: The name LLVM will associate with the instruction.
+   ///
+   /// Returns: The created invoke instruction.
+   llvm::InvokeInst* llvmCreateInvoke(llvm::Value* callee, llvm::ArrayRef<llvm::Value *> args, llvm::BasicBlock* normal, llvm::BasicBlock* unwind, const llvm::Twine &name="");
+
+   /// Creates a cleanup landing pad at the beginning of the current block.
+   /// The landing pad uses libhilti's personality routine.
+   void llvmCreateLandingPad();
+
    /// Wrapper method to create an LLVM \c sotre instructions that first
    /// checks operands for compatibility. If not matching, it dumps out
    /// debugging outout and abort execution.
@@ -1628,8 +1692,14 @@ public:
    /// XXX Ref/unref locals for get ref counts correct.
    void llvmAdaptStackForSafepoint(bool pre);
 
+   /// Releases locals whose reference counts have been kept elevated
+   /// across a sequence of safepoints, as determined by the
+   /// passes::RefCountElision pass, once the current statement ends that
+   /// sequence. Called by the StatementBuilder after each statement.
+   void llvmReleaseLocalsCarriedOverSafepoints();
+
    /// XXX Returns all values currently live with theior types.
-   typedef std::tuple<llvm::Value*, shared_ptr<Type>, bool> live_value;
+   typedef std::tuple<llvm::Value*, shared_ptr<Type>, bool, shared_ptr<FlowVariable>> live_value;
    typedef std::list<live_value> live_list;
    live_list liveValues();
 
@@ -2288,7 +2358,7 @@ private:
    llvm::Value* llvmCurrentLocation(const string& addl="");
 
    // Helper that implements the llvmCallableBind() methods.
-   llvm::Value* llvmDoCallableBind(llvm::Value* llvm_func, shared_ptr<Function> func, shared_ptr<Hook> hook, shared_ptr<type::Function> ftype, const expr_list args, bool result_cctor, bool excpt_check=true, bool deep_copy_args=false, bool cctor_callable = false);
+   llvm::Value* llvmDoCallableBind(llvm::Value* llvm_func, shared_ptr<Function> func, shared_ptr<Hook> hook, shared_ptr<type::Function> ftype, const expr_list args, bool result_cctor, bool excpt_check=true, bool deep_copy_args=false, bool cctor_callable = false, const std::set<int>& transfer_args = std::set<int>());
 
    // Helpers for llvmCallableBind() that builds the hlt.callable.func
    // object.
@@ -2399,9 +2469,11 @@ private:
        llvm::Value* context;
        declaration::Function* leave_func = nullptr;
        std::list<shared_ptr<Expression>> locals_cleared_on_excpt;
+       std::map<string, live_value> locals_carried; // Indexed by FlowVariable name.
        handler_list catches;
        type::function::CallingConvention cc;
        int stackmap_id = 0;
+       bool unwind = false;
    };
 
    typedef std::list<std::unique_ptr<FunctionState>> function_list;
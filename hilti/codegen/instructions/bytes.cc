@@ -174,6 +174,38 @@ void StatementBuilder::visit(statement::instruction::bytes::FindAtIter* i)
     cg()->llvmStore(i, result);
 }
 
+void StatementBuilder::visit(statement::instruction::bytes::MatchAt* i)
+{
+    // If we have the constant right here, compare against its raw data
+    // directly rather than instantiating a bytes object first.
+    auto ctor = ast::tryCast<expression::Ctor>(i->op2());
+    auto bytes = ctor ? ast::tryCast<ctor::Bytes>(ctor->ctor()) : nullptr;
+
+    if ( bytes ) {
+        std::vector<llvm::Constant*> vec_data;
+
+        for ( auto c : bytes->value() )
+            vec_data.push_back(cg()->llvmConstInt(c, 8));
+
+        auto array = cg()->llvmConstArray(cg()->llvmTypeInt(8), vec_data);
+        llvm::Constant* data = cg()->llvmAddConst("bytes", array);
+        data = llvm::ConstantExpr::getBitCast(data, cg()->llvmTypePtr());
+
+        CodeGen::value_list args = { cg()->llvmValue(i->op1()), data, cg()->llvmConstInt(bytes->value().size(), 64) };
+        auto result = cg()->llvmCallC("hlt_bytes_match_raw_at", args, true, false);
+        cg()->llvmStore(i, result);
+        return;
+    }
+
+    CodeGen::expr_list args;
+    args.push_back(i->op1());
+    args.push_back(i->op2());
+
+    auto result = cg()->llvmCall("hlt::bytes_match_bytes_at", args);
+
+    cg()->llvmStore(i, result);
+}
+
 void StatementBuilder::visit(statement::instruction::bytes::Offset* i)
 {
     CodeGen::expr_list args;
@@ -16,10 +16,21 @@ void StatementBuilder::visit(statement::instruction::channel::New* i)
    if ( ! op2 )
        op2 = builder::integer::create(0);
 
+    // The validator makes sure that op3 is a constant if given.
+    bool spsc = false;
+
+    if ( i->op3() ) {
+        auto cexpr = ast::as<expression::Constant>(i->op3());
+        assert(cexpr);
+        auto cval = ast::as<constant::Bool>(cexpr->constant());
+        assert(cval);
+        spsc = cval->value();
+    }
+
     CodeGen::expr_list args;
     args.push_back(op1);
     args.push_back(op2);
-    auto result = cg()->llvmCall("hlt::channel_new", args);
+    auto result = cg()->llvmCall(spsc ? "hlt::channel_new_spsc" : "hlt::channel_new", args);
     cg()->llvmStore(i, result);
 }
 
@@ -51,6 +62,22 @@ void StatementBuilder::visit(statement::instruction::channel::ReadTry* i)
     _readFinish(cg(), i, val);
 }
 
+static llvm::Value* _readBatchTry(CodeGen* cg, statement::Instruction* i)
+{
+    CodeGen::expr_list args = { i->op1(), i->op2(), i->op3() };
+    return cg->llvmCall("hlt::channel_read_batch_try", args, false, false);
+}
+
+static void _batchFinish(CodeGen* cg, statement::Instruction* i, llvm::Value* result)
+{
+    cg->llvmStore(i, result);
+}
+
+void StatementBuilder::visit(statement::instruction::channel::ReadBatch* i)
+{
+    cg()->llvmBlockingInstruction(i, _readBatchTry, _batchFinish);
+}
+
 void StatementBuilder::visit(statement::instruction::channel::Size* i)
 {
     CodeGen::expr_list args;
@@ -88,3 +115,13 @@ void StatementBuilder::visit(statement::instruction::channel::WriteTry* i)
     _writeFinish(cg(), i, val);
 }
 
+static llvm::Value* _writeBatchTry(CodeGen* cg, statement::Instruction* i)
+{
+    CodeGen::expr_list args = { i->op1(), i->op2() };
+    return cg->llvmCall("hlt::channel_write_batch_try", args, false, false);
+}
+
+void StatementBuilder::visit(statement::instruction::channel::WriteBatch* i)
+{
+    cg()->llvmBlockingInstruction(i, _writeBatchTry, _batchFinish);
+}
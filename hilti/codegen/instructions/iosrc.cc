@@ -109,6 +109,14 @@ void StatementBuilder::visit(statement::instruction::ioSource::New* i)
         }
     ));
 
+    cases.push_back(CodeGen::SwitchCase(
+        "packet-ring",
+        cg()->llvmEnum("Hilti::IOSrc::PacketRing"),
+        [&] (CodeGen* cg) -> llvm::Value* {
+            return cg->llvmCall("hlt::iosrc_new_ring", args);
+        }
+    ));
+
     auto result = cg()->llvmSwitchEnumConst(cg()->llvmEnum(kind), cases, true, i->location());
     cg()->llvmStore(i, result);
 }
@@ -149,6 +157,20 @@ void StatementBuilder::visit(statement::instruction::ioSource::Read* i)
                                  );
 }
 
+static llvm::Value* _readBatchTry(CodeGen* cg, statement::Instruction* i)
+{
+    CodeGen::expr_list args = { i->op1(), i->op2(), i->op3(), builder::boolean::create(false) };
+    return cg->llvmCall("hlt::iosrc_read_batch_try", args, false, false);
+}
+
+void StatementBuilder::visit(statement::instruction::ioSource::ReadBatch* i)
+{
+    cg()->llvmBlockingInstruction(i,
+                                  [&] (CodeGen* cg, statement::Instruction* i) -> llvm::Value* { return _readBatchTry(cg, i); },
+                                  [&] (CodeGen* cg, statement::Instruction* i, llvm::Value* result) { cg->llvmStore(i, result); }
+                                 );
+}
+
 void StatementBuilder::visit(statement::instruction::iterIOSource::Begin* i)
 {
     cg()->llvmBlockingInstruction(i,
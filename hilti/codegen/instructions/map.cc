@@ -141,6 +141,16 @@ void StatementBuilder::visit(statement::instruction::map::Size* i)
     cg()->llvmStore(i, result);
 }
 
+void StatementBuilder::visit(statement::instruction::map::Changes* i)
+{
+    CodeGen::expr_list args;
+    args.push_back(i->op1());
+
+    auto result = cg()->llvmCall("hlt::map_changes", args);
+
+    cg()->llvmStore(i, result);
+}
+
 void StatementBuilder::visit(statement::instruction::map::Timeout* i)
 {
     CodeGen::expr_list args;
@@ -2,10 +2,19 @@
 #include <hilti/hilti-intern.h>
 
 #include "../stmt-builder.h"
+#include "../abi.h"
 
 using namespace hilti;
 using namespace codegen;
 
+// Returns the index of the overlay slot that records where the contiguous
+// data starting at the attach position ends. The slot is stored as an
+// iterator without a chunk, and isn't reference counted.
+static int _limitIndex(shared_ptr<type::Overlay> otype)
+{
+    return 1 + otype->numDependencies();
+}
+
 
 void StatementBuilder::visit(statement::instruction::overlay::Attach* i)
 {
@@ -26,14 +35,113 @@ void StatementBuilder::visit(statement::instruction::overlay::Attach* i)
     for ( int j = 1; j < 1 + otype->numDependencies(); ++j )
         ov = cg()->llvmInsertValue(ov, end, j);
 
+    // Record how far the attach position's chunk extends. Fields inside
+    // that range can then be read directly from memory. For a packet that's
+    // a single chunk, that covers all of them.
+    auto chunk = cg()->llvmExtractValue(iter, 0);
+    auto limit = cg()->llvmCallC("__hlt_bytes_chunk_end", { chunk }, false, false);
+    auto limit_iter = cg()->llvmInsertValue(cg()->llvmConstNull(cg()->llvmType(itype)), limit, 1);
+    ov = cg()->llvmInsertValue(ov, limit_iter, _limitIndex(otype));
+
     // Need to rewrite back into the original value.
     cg()->llvmStore(i->op1(), ov);
 }
 
+// Describes how to read a field directly from memory.
+struct DirectFormat {
+    int width = 0;                                 // Width of the raw value in bits; zero if we can't read it directly.
+    bool sign = false;                             // True if the raw value is a signed integer.
+    bool addr = false;                             // True if the raw value is an IPv4 address.
+    ABI::ByteOrder order = ABI::LittleEndian;      // Byte order of the raw value.
+};
+
+// Determines whether a field's format is one that we can read directly from
+// memory, which is the case for fixed-width integers and IPv4 addresses.
+static DirectFormat _directFormat(CodeGen* cg, shared_ptr<type::overlay::Field> field)
+{
+    DirectFormat df;
+
+    auto cexpr = ast::tryCast<expression::Constant>(field->format());
+
+    if ( ! cexpr )
+        return df;
+
+    auto cval = ast::tryCast<constant::Enum>(cexpr->constant());
+
+    if ( ! cval )
+        return df;
+
+    auto label = cval->value()->local();
+    auto order = cg->abi()->byteOrder();
+
+    if ( ::util::startsWith(label, "IPv4") ) {
+        if ( ! ast::isA<type::Address>(field->type()) )
+            return df;
+
+        auto suffix = label.substr(4);
+
+        if ( suffix == "Network" || suffix == "Big" )
+            order = ABI::BigEndian;
+
+        else if ( suffix == "Little" )
+            order = ABI::LittleEndian;
+
+        else if ( suffix.size() )
+            return df;
+
+        df.width = 32;
+        df.addr = true;
+        df.order = order;
+        return df;
+    }
+
+    if ( ! ast::isA<type::Integer>(field->type()) )
+        return df;
+
+    bool sign = true;
+    string rest;
+
+    if ( ::util::startsWith(label, "UInt") ) {
+        sign = false;
+        rest = label.substr(4);
+    }
+
+    else if ( ::util::startsWith(label, "Int") )
+        rest = label.substr(3);
+
+    else
+        return df;
+
+    for ( auto width : { 8, 16, 32, 64 } ) {
+        auto w = ::util::fmt("%d", width);
+
+        if ( ! ::util::startsWith(rest, w) )
+            continue;
+
+        auto suffix = rest.substr(w.size());
+
+        if ( suffix == "Big" )
+            order = ABI::BigEndian;
+
+        else if ( suffix == "Little" )
+            order = ABI::LittleEndian;
+
+        else if ( suffix.size() )
+            return df;
+
+        df.width = width;
+        df.sign = sign;
+        df.order = order;
+        return df;
+    }
+
+    return df;
+}
+
 // Generates the unpacking code for one field, assuming all dependencies are
 // already resolved. Returns tuple (new overlay, unpacked val) where val is
 // not ref'ed.
-static std::pair<llvm::Value*, llvm::Value*> _emitOne(CodeGen* cg, shared_ptr<type::Overlay> otype, llvm::Value* ov, shared_ptr<type::overlay::Field> field, llvm::Value* offset0, llvm::Value* b, const Location& l)
+static std::pair<llvm::Value*, llvm::Value*> _emitOneUnpack(CodeGen* cg, shared_ptr<type::Overlay> otype, llvm::Value* ov, shared_ptr<type::overlay::Field> field, llvm::Value* offset0, llvm::Value* b, const Location& l)
 {
     auto itype = builder::iterator::type(builder::bytes::type());
     auto btype = builder::reference::type(builder::bytes::type());
@@ -102,6 +210,104 @@ static std::pair<llvm::Value*, llvm::Value*> _emitOne(CodeGen* cg, shared_ptr<ty
     return std::make_pair(ov, val);
 }
 
+// Generates code for one field that reads it directly from memory if it's
+// inside the contiguous data recorded at attach time, and falls back to
+// _emitOneUnpack() otherwise. Arguments and result are as with that.
+static std::pair<llvm::Value*, llvm::Value*> _emitOneDirect(CodeGen* cg, shared_ptr<type::Overlay> otype, llvm::Value* ov, shared_ptr<type::overlay::Field> field, llvm::Value* offset0, const DirectFormat& df, const Location& l)
+{
+    auto block_direct = cg->newBuilder("direct");
+    auto block_unpack = cg->newBuilder("unpack");
+    auto block_done = cg->newBuilder("done");
+
+    auto limit = cg->llvmExtractValue(cg->llvmExtractValue(ov, _limitIndex(otype)), 1);
+    auto begin = cg->builder()->CreateGEP(cg->llvmExtractValue(offset0, 1), cg->llvmConstInt(field->startOffset(), 64));
+    auto end = cg->builder()->CreateGEP(begin, cg->llvmConstInt(df.width / 8, 64));
+    auto fits = cg->builder()->CreateICmpULE(end, limit);
+    cg->llvmCreateCondBr(cg->llvmExpect(fits, cg->llvmConstInt(1, 1)), block_direct, block_unpack);
+
+    cg->pushBuilder(block_direct);
+
+    auto itype = cg->llvmTypeInt(df.width);
+    auto ptr = cg->builder()->CreateBitCast(begin, cg->llvmTypePtr(itype));
+    llvm::Value* val = cg->builder()->CreateAlignedLoad(ptr, 1);
+
+    if ( df.width > 8 && df.order != cg->abi()->byteOrder() )
+        val = cg->llvmCallIntrinsic(llvm::Intrinsic::bswap, { itype }, { val });
+
+    if ( df.addr ) {
+        CodeGen::value_list vals = { cg->llvmConstInt(0, 64), cg->builder()->CreateZExt(val, cg->llvmTypeInt(64)) };
+        val = cg->llvmValueStruct(vals);
+    }
+
+    else {
+        auto twidth = ast::as<type::Integer>(field->type())->width();
+        auto ttype = cg->llvmTypeInt(twidth);
+
+        if ( df.width < twidth )
+            val = df.sign ? cg->builder()->CreateSExt(val, ttype) : cg->builder()->CreateZExt(val, ttype);
+
+        if ( df.width > twidth )
+            val = cg->builder()->CreateTrunc(val, ttype);
+
+        // Select subset of bits if requested.
+        if ( field->formatArg() ) {
+            auto arg = cg->llvmValue(field->formatArg());
+            auto arg_type = field->formatArg()->type();
+            auto low = cg->llvmTupleElement(arg_type, arg, 0, false);
+            auto high = cg->llvmTupleElement(arg_type, arg, 1, false);
+
+            low = cg->builder()->CreateZExtOrTrunc(low, ttype);
+            high = cg->builder()->CreateZExtOrTrunc(high, ttype);
+
+            val = cg->llvmExtractBits(val, low, high);
+        }
+    }
+
+    auto ov_direct = ov;
+
+    if ( field->depIndex() >= 0 )
+        ov_direct = cg->llvmInsertValue(ov, cg->llvmInsertValue(offset0, end, 1), field->depIndex());
+
+    auto direct_exit_block = cg->builder();
+    cg->llvmCreateBr(block_done);
+    cg->popBuilder();
+
+    cg->pushBuilder(block_unpack);
+    auto unpacked = _emitOneUnpack(cg, otype, ov, field, offset0, 0, l);
+    auto unpack_exit_block = cg->builder();
+    cg->llvmCreateBr(block_done);
+    cg->popBuilder();
+
+    cg->pushBuilder(block_done);
+
+    auto phi_ov = cg->builder()->CreatePHI(ov->getType(), 2);
+    phi_ov->addIncoming(ov_direct, direct_exit_block->GetInsertBlock());
+    phi_ov->addIncoming(unpacked.first, unpack_exit_block->GetInsertBlock());
+
+    auto phi_val = cg->builder()->CreatePHI(val->getType(), 2);
+    phi_val->addIncoming(val, direct_exit_block->GetInsertBlock());
+    phi_val->addIncoming(unpacked.second, unpack_exit_block->GetInsertBlock());
+
+    // Leave builder on stack.
+
+    return std::make_pair(phi_ov, phi_val);
+}
+
+// Generates the code for one field, assuming all dependencies are already
+// resolved. Returns tuple (new overlay, unpacked val) where val is not
+// ref'ed.
+static std::pair<llvm::Value*, llvm::Value*> _emitOne(CodeGen* cg, shared_ptr<type::Overlay> otype, llvm::Value* ov, shared_ptr<type::overlay::Field> field, llvm::Value* offset0, llvm::Value* b, const Location& l)
+{
+    if ( ! b && offset0 && field->startOffset() >= 0 ) {
+        auto df = _directFormat(cg, field);
+
+        if ( df.width )
+            return _emitOneDirect(cg, otype, ov, field, offset0, df, l);
+    }
+
+    return _emitOneUnpack(cg, otype, ov, field, offset0, b, l);
+}
+
 // Generate code for all depedencies. Returns new overlay.
 static llvm::Value* _makeDep(CodeGen* cg, shared_ptr<type::Overlay> otype, llvm::Value* ov, shared_ptr<type::overlay::Field> field, llvm::Value* offset0, const Location& l)
 {
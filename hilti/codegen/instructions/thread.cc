@@ -35,11 +35,14 @@ void StatementBuilder::visit(statement::instruction::thread::ThreadID* i)
 // Promotes thread context from a source scope to destination scope. The
 // validator has already ensured that this operation is to ok to do. Note
 // that we must never modify an existing context. We can directly reuse it
-// however if that does not require any modification.
+// however if that does not require any modification. If we build a new
+// one, it's returned at +1 and *fresh is set to true.
 llvm::Value* _promoteContext(CodeGen* cg, llvm::Value* tctx,
                              shared_ptr<type::Scope> src_scope, shared_ptr<type::Context> src_context,
-                             shared_ptr<type::Scope> dst_scope, shared_ptr<type::Context> dst_context)
+                             shared_ptr<type::Scope> dst_scope, shared_ptr<type::Context> dst_context,
+                             bool* fresh)
 {
+    *fresh = false;
 
     // If both scope and context match, we don't need to do anything.
 
@@ -48,7 +51,8 @@ llvm::Value* _promoteContext(CodeGen* cg, llvm::Value* tctx,
 
     // Build the destination context field by field.
 
-    auto new_tctx = cg->llvmStructNew(dst_context, false);
+    auto new_tctx = cg->llvmStructNew(dst_context, true);
+    *fresh = true;
 
     for ( auto f : dst_context->fields() ) {
         if ( ! dst_scope->hasField(f->id()) )
@@ -63,6 +67,159 @@ llvm::Value* _promoteContext(CodeGen* cg, llvm::Value* tctx,
     return new_tctx;
 }
 
+// Adds to *types* the types of the objects that a value of type *t* points
+// to directly, not counting anything they reference in turn. Returns false
+// if that could be anything.
+static bool _directTargets(shared_ptr<Type> t, std::list<shared_ptr<Type>>* types)
+{
+    if ( auto r = ast::tryCast<type::Reference>(t) ) {
+        if ( r->wildcard() )
+            return false;
+
+        types->push_back(r->argType());
+        return true;
+    }
+
+    if ( auto tt = ast::tryCast<type::Tuple>(t) ) {
+        for ( auto e : tt->typeList() ) {
+            if ( ! _directTargets(e, types) )
+                return false;
+        }
+
+        return true;
+    }
+
+    if ( ast::isA<type::iterator::Bytes>(t) ) {
+        types->push_back(std::make_shared<type::Bytes>());
+        return true;
+    }
+
+    if ( ast::isA<type::String>(t) ) {
+        types->push_back(t);
+        return true;
+    }
+
+    if ( ast::isA<type::Any>(t) || ast::isA<type::Union>(t) )
+        return false;
+
+    // Anything else either has no references at all, or only to objects
+    // that a transfer copies.
+    return true;
+}
+
+// Adds to *types* the types of the objects that hlt_clone_transfer_unaliased()
+// may move when transferring a value of type *t*. Returns false if that
+// could be anything.
+static bool _movableTargets(shared_ptr<Type> t, std::list<shared_ptr<Type>>* types)
+{
+    std::list<shared_ptr<Type>> direct;
+
+    if ( ! _directTargets(t, &direct) )
+        return false;
+
+    for ( auto d : direct ) {
+        if ( ! (ast::isA<type::Struct>(d) || ast::isA<type::Bytes>(d) || ast::isA<type::String>(d)) )
+            continue;
+
+        if ( std::find(types->begin(), types->end(), d) != types->end() )
+            continue;
+
+        types->push_back(d);
+
+        if ( auto stype = ast::tryCast<type::Struct>(d) ) {
+            for ( auto f : stype->fields() ) {
+                if ( ! _movableTargets(f->type(), types) )
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Returns true if a variable of type *holder* may point directly to one of
+// the objects in *targets*.
+static bool _mayAlias(shared_ptr<Type> holder, const std::list<shared_ptr<Type>>& targets)
+{
+    std::list<shared_ptr<Type>> direct;
+
+    if ( ! _directTargets(holder, &direct) )
+        return true;
+
+    for ( auto d : direct ) {
+        for ( auto t : targets ) {
+            if ( d->equal(t) )
+                return true;
+        }
+    }
+
+    return false;
+}
+
+// Returns the indices of the arguments of a thread.schedule that we can
+// transfer to the target thread with hlt_clone_transfer_unaliased() rather
+// than copying them. That's the case for a local that's not live anymore
+// afterwards if no other variable in reach may point to anything the
+// transfer could move: no live local, no other argument, and no parameter
+// of the current function, as the caller may still be holding on to the
+// value passed in. Locals don't hold references, so the runtime can't tell
+// them apart by itself; references held by anybody else show up in the
+// reference counts.
+static std::set<int> _transferableArgs(StatementBuilder* sb, CodeGen* cg, shared_ptr<Expression> args, shared_ptr<Function> func)
+{
+    std::set<int> transfer;
+
+    auto expr = ast::tryCast<expression::Constant>(args);
+
+    if ( ! (expr && expr->isConstant()) )
+        return transfer;
+
+    auto stmt = sb->currentStatement();
+    auto liveness = cg->hiltiModule()->liveness();
+    auto elems = ast::as<constant::Tuple>(expr->constant())->value();
+
+    int idx = 0;
+
+    for ( auto a : elems ) {
+        int i = idx++;
+
+        auto var = ast::tryCast<expression::Variable>(a);
+
+        if ( ! (var && ast::isA<variable::Local>(var->variable())) )
+            continue;
+
+        if ( liveness->liveOut(stmt, var) )
+            continue;
+
+        std::list<shared_ptr<Type>> targets;
+
+        if ( ! _movableTargets(var->type(), &targets) || targets.empty() )
+            continue;
+
+        bool alias = false;
+
+        for ( auto l : *sb->liveness().out ) {
+            if ( _mayAlias(l->expression->type(), targets) )
+                alias = true;
+        }
+
+        for ( auto p : func->type()->parameters() ) {
+            if ( _mayAlias(p->type(), targets) )
+                alias = true;
+        }
+
+        for ( auto o : elems ) {
+            if ( o != a && _mayAlias(o->type(), targets) )
+                alias = true;
+        }
+
+        if ( ! alias )
+            transfer.insert(i);
+    }
+
+    return transfer;
+}
+
 void StatementBuilder::visit(statement::instruction::thread::Schedule* i)
 {
     CodeGen::expr_list params;
@@ -80,7 +237,15 @@ void StatementBuilder::visit(statement::instruction::thread::Schedule* i)
     // We return a ref'ed object here so that the callable doesn't end up in
     // the nullbuffer of the current thread. We pass ownership to the target
     // threat below.
-    auto job = cg()->llvmCallableBind(func, ftype, params, false, false, deep_copy, true);
+    std::set<int> transfer;
+
+    if ( deep_copy ) {
+        auto decl = current<declaration::Function>();
+        assert(decl);
+        transfer = _transferableArgs(this, cg(), i->op2(), decl->function());
+    }
+
+    auto job = cg()->llvmCallableBind(func, ftype, params, false, false, deep_copy, true, transfer);
     auto mgr = cg()->llvmThreadMgr();
 
     if ( i->op3() ) {
@@ -130,11 +295,14 @@ void StatementBuilder::visit(statement::instruction::thread::Schedule* i)
         auto dst_scope = callee->scope();
         auto dst_context = callee->module()->executionContext();
 
-        tctx = _promoteContext(cg(), tctx, src_scope, src_context, dst_scope, dst_context);
+        bool fresh;
+        tctx = _promoteContext(cg(), tctx, src_scope, src_context, dst_scope, dst_context, &fresh);
         tctx = cg()->builder()->CreateBitCast(tctx, cg()->llvmTypePtr());
 
+        // A freshly promoted context is ours alone, so we can hand it over
+        // to the target thread rather than having it copied.
         auto ti = cg()->llvmRtti(dst_context);
         CodeGen::value_list vals = { mgr, ti, tctx, job };
-        cg()->llvmCallC("__hlt_thread_mgr_schedule_tcontext", vals, true, true);
+        cg()->llvmCallC(fresh ? "__hlt_thread_mgr_schedule_tcontext_transfer" : "__hlt_thread_mgr_schedule_tcontext", vals, true, true);
     }
 }
@@ -56,6 +56,20 @@ void StatementBuilder::visit(statement::instruction::vector::PushBack* i)
     cg()->llvmCall("hlt::vector_push_back", args);
 }
 
+void StatementBuilder::visit(statement::instruction::vector::PushBackUnpacked* i)
+{
+    auto iters = cg()->llvmValue(i->op2());
+    auto begin = cg()->llvmTupleElement(i->op2()->type(), iters, 0, false);
+    auto end = cg()->llvmTupleElement(i->op2()->type(), iters, 1, false);
+
+    CodeGen::expr_list args;
+    args.push_back(i->op1());
+    args.push_back(builder::codegen::create(builder::iterator::typeBytes(), begin));
+    args.push_back(builder::codegen::create(builder::iterator::typeBytes(), end));
+    args.push_back(i->op3());
+    cg()->llvmCall("hlt::vector_push_back_unpacked", args);
+}
+
 void StatementBuilder::visit(statement::instruction::vector::Reserve* i)
 {
     auto op2 = i->op2()->coerceTo(builder::integer::type(64));
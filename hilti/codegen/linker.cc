@@ -403,6 +403,54 @@ void Linker::joinFunctions(llvm::Module* dst, const char* new_func, const char*
     builder->CreateRetVoid();
 }
 
+// Returns all calls that directly target a given function.
+// Returns all calls to a function, including those going through pointer
+// casts of it. If other is given, sets it to true if the function is used
+// in any other way as well.
+static std::vector<llvm::CallInst*> _directCalls(llvm::Function* func, bool* other = nullptr)
+{
+    std::vector<llvm::CallInst*> calls;
+    std::vector<llvm::Value*> todo = { func };
+
+    while ( todo.size() ) {
+        llvm::Value* v = todo.back();
+        todo.pop_back();
+
+#ifdef HAVE_LLVM_35
+        for ( auto u : v->users() ) {
+#else
+        for ( auto i = v->use_begin(); i != v->use_end(); ++i ) {
+            auto u = *i;
+#endif
+            auto cast = llvm::dyn_cast<llvm::ConstantExpr>(u);
+
+            if ( cast && cast->isCast() ) {
+                todo.push_back(cast);
+                continue;
+            }
+
+            auto call = llvm::dyn_cast<llvm::CallInst>(u);
+
+            if ( call && call->getCalledValue() == v ) {
+                if ( std::find(calls.begin(), calls.end(), call) == calls.end() )
+                    calls.push_back(call);
+
+                for ( int i = 0; i < call->getNumArgOperands(); ++i ) {
+                    if ( call->getArgOperand(i) == v && other )
+                        *other = true;
+                }
+
+                continue;
+            }
+
+            if ( other )
+                *other = true;
+        }
+    }
+
+    return calls;
+}
+
 struct HookImpl {
     llvm::Value* func;
     int64_t priority;
@@ -547,6 +595,118 @@ void Linker::makeHooks(const std::list<string>& module_names, llvm::Module* modu
         stopped->CreateRet(true_);
         func->getBasicBlockList().push_back(stopped->GetInsertBlock());
     }
+
+    if ( ! (options().optimize && options().optimizing("hooks")) )
+        return;
+
+    // Hooks with at most one implementation don't need to go through the
+    // trampoline; call the implementation directly, or skip the call
+    // altogether if there's none. We leave the trampoline in place for
+    // any other references to it.
+    for ( auto h : hooks ) {
+        auto decl = h.second;
+
+        if ( decl.impls.size() > 1 )
+            continue;
+
+        auto func = llvm::cast<llvm::Function>(decl.func);
+
+        for ( auto call : _directCalls(func) ) {
+            if ( decl.impls.empty() ) {
+                if ( ! call->getType()->isVoidTy() )
+                    call->replaceAllUsesWith(llvm::Constant::getNullValue(call->getType()));
+
+                call->eraseFromParent();
+                continue;
+            }
+
+            auto ifunc = llvm::cast<llvm::Function>(decl.impls.front().func);
+
+            if ( call->getNumArgOperands() != ifunc->arg_size() ||
+                 ! (call->getType()->isVoidTy() || call->getType() == ifunc->getReturnType()) )
+                // Called through a cast that we don't know how to undo.
+                continue;
+
+            auto builder = util::newBuilder(ctx, call->getParent());
+            builder->SetInsertPoint(call);
+
+            std::vector<llvm::Value *> args;
+
+            auto pt = ifunc->arg_begin();
+            for ( int i = 0; i < call->getNumArgOperands(); ++i ) {
+                args.push_back(builder->CreateBitCast(call->getArgOperand(i), pt->getType()));
+                pt++;
+            }
+
+            auto result = util::checkedCreateCall(builder, "Linker::makeHooks", ifunc, args);
+
+            if ( ! call->getType()->isVoidTy() )
+                call->replaceAllUsesWith(result);
+
+            call->eraseFromParent();
+            delete builder;
+        }
+
+        debug(1, ::util::fmt("hook %s - calls devirtualized (%d implementations)", h.first.c_str(), (int)decl.impls.size()));
+    }
+
+    removeGroupChecks(module);
+}
+
+void Linker::removeGroupChecks(llvm::Module* module)
+{
+    // Each hook implementation checks first whether its group is enabled.
+    // If no code ever disables a group, that check can't fail. We look at
+    // all calls to hlt_hook_group_enable() to determine which groups may
+    // get disabled. If we can't tell, we leave everything alone. We only
+    // touch the checks the code generator marked as part of dispatching
+    // hooks; hook.group_enabled keeps asking the runtime.
+    std::set<int64_t> disabled;
+
+    if ( auto enable = module->getFunction("hlt_hook_group_enable") ) {
+        bool other = false;
+        auto calls = _directCalls(enable, &other);
+
+        if ( other )
+            // Function is referenced in other ways.
+            return;
+
+        for ( auto call : calls ) {
+            auto group = llvm::dyn_cast<llvm::ConstantInt>(call->getArgOperand(0));
+            auto enabled = llvm::dyn_cast<llvm::ConstantInt>(call->getArgOperand(1));
+
+            if ( ! group )
+                return;
+
+            if ( enabled && ! enabled->isZero() )
+                continue;
+
+            disabled.insert(group->getSExtValue());
+        }
+    }
+
+    auto is_enabled = module->getFunction("hlt_hook_group_is_enabled");
+
+    if ( ! is_enabled )
+        return;
+
+    int removed = 0;
+
+    for ( auto call : _directCalls(is_enabled) ) {
+        if ( ! call->getMetadata(symbols::MetaHookGroupCheck) )
+            continue;
+
+        auto group = llvm::dyn_cast<llvm::ConstantInt>(call->getArgOperand(0));
+
+        if ( ! group || disabled.find(group->getSExtValue()) != disabled.end() )
+            continue;
+
+        call->replaceAllUsesWith(llvm::ConstantInt::get(call->getType(), 1));
+        call->eraseFromParent();
+        ++removed;
+    }
+
+    debug(1, ::util::fmt("removed %d hook group checks, %d groups may be disabled", removed, (int)disabled.size()));
 }
 
 void Linker::addModuleInfo(llvm::Module* dst, const std::list<string>& module_names, llvm::Module* module)
@@ -70,6 +70,7 @@ private:
    void addGlobalsInfo(llvm::Module* dst, const std::list<string>& module_names, llvm::Module* module);
    void joinFunctions(llvm::Module* dst, const char* new_func, const char* meta, llvm::FunctionType* default_ftype, const std::list<string>& module_names, llvm::Module* module);
    void makeHooks(const std::list<string>& module_names, llvm::Module* module);
+   void removeGroupChecks(llvm::Module* module);
    void fatalError(const string& where, const string& file = "", const string& error = "");
 
    // These following three abort directly on error.
@@ -1,4 +1,9 @@
 
+#include <fstream>
+#include <sstream>
+
+#include <llvm/IR/MDBuilder.h>
+
 #include "optimizer.h"
 #include "util.h"
 #include "codegen.h"
@@ -33,6 +38,9 @@ bool Optimizer::optimize(llvm::Module* module, bool is_linked)
     out.close();
 #endif
 
+    if ( is_linked && options().pgo_use )
+        applyProfile(module);
+
     // Logic borrowed loosely from LLVM's opt.
 
     llvm::PassManager passes;
@@ -123,3 +131,232 @@ bool Optimizer::optimize(llvm::Module* module, bool is_linked)
     // Run module passes.
     return passes.run(*module);
 }
+
+bool Optimizer::instrument(llvm::Module* module, const std::set<string>& functions)
+{
+    llvm::LLVMContext& ctx = module->getContext();
+
+    auto i64 = llvm::Type::getIntNTy(ctx, 64);
+    auto zero = llvm::ConstantInt::get(i64, 0);
+    auto one = llvm::ConstantInt::get(i64, 1);
+
+    std::list<llvm::Function*> funcs;
+    uint64_t num_blocks = 0;
+
+    for ( auto f = module->begin(); f != module->end(); f++ ) {
+        if ( f->isDeclaration() || functions.find(f->getName()) == functions.end() )
+            continue;
+
+        funcs.push_back(&*f);
+        num_blocks += f->size();
+    }
+
+    auto init = module->getFunction(symbols::FunctionModulesInit);
+
+    if ( ! init || init->isDeclaration() ) {
+        warning("optimizer: no module initialization function, cannot instrument for profiling");
+        return true;
+    }
+
+    if ( ! num_blocks )
+        return true;
+
+    // One counter per block, laid out function by function in the order
+    // recorded in the table.
+    auto atype = llvm::ArrayType::get(i64, num_blocks);
+    auto counters = new llvm::GlobalVariable(*module, atype, false, llvm::GlobalValue::InternalLinkage,
+                                             llvm::ConstantAggregateZero::get(atype), "__hlt_pgo_counters");
+
+    string table;
+    uint64_t idx = 0;
+
+    for ( auto f : funcs ) {
+        table += ::util::fmt("%s\t%d\n", f->getName().str(), (int)f->size());
+
+        for ( auto b = f->begin(); b != f->end(); b++ ) {
+            auto builder = util::newBuilder(ctx, &*b, true);
+            std::vector<llvm::Value*> indices = { zero, llvm::ConstantInt::get(i64, idx++) };
+            auto addr = builder->CreateInBoundsGEP(counters, indices);
+            auto cnt = builder->CreateLoad(addr);
+            builder->CreateStore(builder->CreateAdd(cnt, one), addr);
+            delete builder;
+        }
+    }
+
+    // Register the counters at module initialization.
+    auto path = context()->profileDataFile(module->getModuleIdentifier());
+
+    auto builder = util::newBuilder(ctx, &init->getEntryBlock(), true);
+
+    auto voidp = builder->getInt8PtrTy();
+    std::vector<llvm::Type*> params = { llvm::PointerType::get(i64, 0), voidp, voidp };
+    auto ftype = llvm::FunctionType::get(llvm::Type::getVoidTy(ctx), params, false);
+    auto reg = module->getOrInsertFunction("__hlt_pgo_register", ftype);
+
+    std::vector<llvm::Value*> indices = { zero, zero };
+    std::vector<llvm::Value*> args = { builder->CreateInBoundsGEP(counters, indices),
+                                       builder->CreateGlobalStringPtr(table, "__hlt_pgo_table"),
+                                       builder->CreateGlobalStringPtr(path, "__hlt_pgo_path") };
+
+    util::checkedCreateCall(builder, "Optimizer::instrument", reg, args);
+    delete builder;
+
+    debug(1, ::util::fmt("instrumented %d blocks in %d functions, profile goes to %s", (int)num_blocks, (int)funcs.size(), path));
+    return true;
+}
+
+void Optimizer::applyProfile(llvm::Module* module)
+{
+    auto path = context()->profileDataFile(module->getModuleIdentifier());
+
+    std::ifstream in(path);
+
+    if ( ! in ) {
+        debug(1, ::util::fmt("no profile in %s", path));
+        return;
+    }
+
+    string line;
+
+    // Must match HLT_PGO_MAGIC in libhilti/pgo.h.
+    if ( ! std::getline(in, line) || line != "hilti-pgo 1" ) {
+        warning(::util::fmt("optimizer: %s is not a profile, ignoring it", path));
+        return;
+    }
+
+    std::map<string, std::vector<uint64_t>> profile;
+
+    while ( std::getline(in, line) ) {
+        std::istringstream fields(line);
+
+        string name;
+        uint64_t n;
+
+        if ( ! std::getline(fields, name, '\t') || ! (fields >> n) )
+            continue;
+
+        std::vector<uint64_t> counts;
+        uint64_t c;
+
+        while ( counts.size() < n && fields >> c )
+            counts.push_back(c);
+
+        if ( counts.size() == n )
+            profile.insert(std::make_pair(name, counts));
+    }
+
+    llvm::MDBuilder mdb(module->getContext());
+
+    std::list<std::pair<llvm::Function*, uint64_t>> entries;
+    uint64_t max_entry = 0;
+    int num_stale = 0;
+    int num_branches = 0;
+
+    for ( auto f = module->begin(); f != module->end(); f++ ) {
+        if ( f->isDeclaration() )
+            continue;
+
+        auto p = profile.find(f->getName());
+
+        if ( p == profile.end() )
+            continue;
+
+        auto& counts = p->second;
+
+        if ( counts.size() != f->size() ) {
+            // Function has changed since the profile was recorded.
+            ++num_stale;
+            continue;
+        }
+
+        std::map<llvm::BasicBlock*, uint64_t> bcounts;
+        auto c = counts.begin();
+
+        for ( auto b = f->begin(); b != f->end(); b++ )
+            bcounts[&*b] = *c++;
+
+        // We only know how often blocks executed, not edges. If a
+        // successor has no other predecessor, its count is exact for the
+        // edge leading to it; the others get whatever remains, capped by
+        // their own count.
+        for ( auto b = f->begin(); b != f->end(); b++ ) {
+            auto term = b->getTerminator();
+
+            if ( ! term || term->getNumSuccessors() < 2 || bcounts[&*b] == 0 )
+                continue;
+
+            if ( ! (llvm::isa<llvm::BranchInst>(term) || llvm::isa<llvm::SwitchInst>(term)) )
+                continue;
+
+            uint64_t remaining = bcounts[&*b];
+
+            for ( unsigned int i = 0; i < term->getNumSuccessors(); i++ ) {
+                auto succ = term->getSuccessor(i);
+
+                if ( succ->getSinglePredecessor() == &*b )
+                    remaining -= std::min(remaining, bcounts[succ]);
+            }
+
+            std::vector<uint64_t> edges;
+            uint64_t max = 0;
+
+            for ( unsigned int i = 0; i < term->getNumSuccessors(); i++ ) {
+                auto succ = term->getSuccessor(i);
+                auto e = (succ->getSinglePredecessor() == &*b) ? bcounts[succ] : std::min(remaining, bcounts[succ]);
+                edges.push_back(e);
+                max = std::max(max, e);
+            }
+
+            // Branch weights are 32-bit; scale down if necessary, and
+            // keep them non-zero so that no edge gets ruled out entirely.
+            uint64_t scale = (max >= UINT32_MAX) ? (max / (UINT32_MAX - 1) + 1) : 1;
+
+            std::vector<uint32_t> weights;
+
+            for ( auto e : edges )
+                weights.push_back(e / scale + 1);
+
+            term->setMetadata(llvm::LLVMContext::MD_prof, mdb.createBranchWeights(weights));
+            ++num_branches;
+        }
+
+        entries.push_back(std::make_pair(&*f, counts.front()));
+        max_entry = std::max(max_entry, counts.front());
+    }
+
+    // Functions called at least 1% as often as the hottest one get an
+    // inline hint and move to the front of the module, functions never
+    // called get marked cold and move to the back.
+    entries.sort([](const std::pair<llvm::Function*, uint64_t>& a, const std::pair<llvm::Function*, uint64_t>& b) {
+        return a.second < b.second;
+    });
+
+    auto& flist = module->getFunctionList();
+    int num_hot = 0;
+    int num_cold = 0;
+
+    for ( auto e : entries ) {
+        auto f = e.first;
+
+        if ( e.second == 0 ) {
+#ifdef HAVE_LLVM_33
+            f->addFnAttr(llvm::Attribute::OptimizeForSize);
+#else
+            f->addFnAttr(llvm::Attribute::Cold);
+#endif
+            flist.remove(f);
+            flist.push_back(f);
+            ++num_cold;
+        }
+
+        else if ( e.second * 100 >= max_entry ) {
+            f->addFnAttr(llvm::Attribute::InlineHint);
+            flist.remove(f);
+            flist.push_front(f);
+            ++num_hot;
+        }
+    }
+
+    debug(1, ::util::fmt("applied profile from %s: %d branches weighted, %d hot and %d cold functions, %d functions stale",
+                         path, num_branches, num_hot, num_cold, num_stale));
+}
@@ -2,6 +2,8 @@
 #ifndef HILTI_CODEGEN_OPTIMIZER_H
 #define HILTI_CODEGEN_OPTIMIZER_H
 
+#include <set>
+
 #include "common.h"
 
 namespace hilti {
@@ -37,7 +39,27 @@ public:
    /// Returns: True if successful.
    bool optimize(llvm::Module* module, bool is_linked);
 
+   /// Instruments a linked module for profile-guided optimization. This
+   /// adds a counter to each basic block of the given functions, and
+   /// registers the counters with the runtime so that it writes them into
+   /// CompilerContext::profileDataFile() on termination. When later
+   /// optimizing the same module with Options::pgo_use set, optimize()
+   /// picks the profile up again.
+   ///
+   /// module: The linked module to instrument.
+   ///
+   /// functions: The names of the functions to instrument.
+   ///
+   /// Returns: True if successful.
+   bool instrument(llvm::Module* module, const std::set<string>& functions);
+
 private:
+   /// Applies a profile recorded by an instrumented version of a linked
+   /// module. This sets branch weights from the block counts, marks hot and
+   /// never executed functions accordingly, and moves hot functions to the
+   /// front of the module and cold ones to the back.
+   void applyProfile(llvm::Module* module);
+
    CompilerContext* _ctx;
 
 };
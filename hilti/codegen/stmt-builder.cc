@@ -79,6 +79,7 @@ void StatementBuilder::postAccept(shared_ptr<ast::NodeBase> node)
     // earlier already themselves, in which case this becomes a noop. That's
     // usually the case for terminators.
     cg()->llvmBuildInstructionCleanup();
+    cg()->llvmReleaseLocalsCarriedOverSafepoints();
     _stmts.pop_back();
 }
 
@@ -285,9 +286,10 @@ void StatementBuilder::visit(declaration::Function* f)
         // No implementation, nothing to do here.
         return;
 
-    auto llvm_func = cg()->llvmFunction(func, (hook_decl != nullptr));
+    auto unwind = cg()->unwindsExceptions(func);
+    auto llvm_func = unwind ? cg()->llvmFunctionUnwind(func) : cg()->llvmFunction(func, (hook_decl != nullptr));
 
-    cg()->pushFunction(llvm_func, true, false, false, ftype->callingConvention());
+    cg()->pushFunction(llvm_func, true, false, false, ftype->callingConvention(), unwind);
 
     cg()->setLeaveFunc(f);
 
@@ -333,6 +335,10 @@ void StatementBuilder::visit(declaration::Function* f)
         CodeGen::expr_list args { builder::integer::create(ftype->attributes().getAsInt(attribute::GROUP, 0)) };
         auto cont2 = cg()->llvmCall("hlt::hook_group_is_enabled", args, false, false);
 
+        // Tells the linker that this check is ours to remove.
+        if ( auto call = llvm::dyn_cast<llvm::CallInst>(cont2) )
+            call->setMetadata(symbols::MetaHookGroupCheck, llvm::MDNode::get(cg()->llvmContext(), std::vector<llvm::Value*>()));
+
         auto disabled = cg()->pushBuilder("disabled");
         cg()->llvmReturn(0, cg()->llvmConstInt(0, 1)); // Return false.
         cg()->popBuilder();
@@ -352,6 +358,9 @@ void StatementBuilder::visit(declaration::Function* f)
 
     cg()->popFunction();
 
+    if ( unwind )
+        cg()->llvmBuildUnwindWrapper(func);
+
     if ( f->linkage() == Declaration::EXPORTED && func->type()->callingConvention() == type::function::HILTI )
         cg()->llvmBuildCWrapper(func);
 
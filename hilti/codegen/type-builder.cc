@@ -949,8 +949,12 @@ llvm::Function* TypeBuilder::_makeOverlayFuncHelper(CodeGen* cg, type::Overlay*
 
 void TypeBuilder::visit(type::Overlay* t)
 {
+    // The overlay stores the starting position, the end positions of all
+    // fields others depend on, and finally where the contiguous data
+    // starting at the attach position ends (see instructions/overlay.cc).
+    // The latter is not reference counted.
     auto itype = cg()->llvmType(builder::iterator::type(builder::bytes::type()));
-    auto atype = llvm::ArrayType::get(itype, 1 + t->numDependencies());
+    auto atype = llvm::ArrayType::get(itype, 2 + t->numDependencies());
 
     TypeInfo* ti = new TypeInfo(t);
     ti->id = HLT_TYPE_OVERLAY;
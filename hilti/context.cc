@@ -230,6 +230,7 @@ bool CompilerContext::_finalizeModule(shared_ptr<Module> module, bool verify)
     passes::ScopeBuilder          scope_builder(this);
     passes::OptimizeCtors         optimize_ctors;
     passes::OptimizePeepHole      optimize_peephole;
+    passes::OptimizeExceptions    optimize_exceptions;
 
     _beginPass(module, instruction_normalizer);
 
@@ -319,19 +320,27 @@ bool CompilerContext::_finalizeModule(shared_ptr<Module> module, bool verify)
 
     _endPass();
 
-    _beginPass(module, optimize_peephole);
+    auto optimize = [&](const string& label) { return options().optimize && options().optimizing(label); };
 
-    if ( ! optimize_peephole.run(module) )
-        return false;
+    if ( optimize("fold") ) {
+        _beginPass(module, optimize_peephole);
 
-    _endPass();
+        if ( ! optimize_peephole.run(module) )
+            return false;
 
-    _beginPass(module, optimize_ctors);
+        _endPass();
+    }
 
-    if ( ! optimize_ctors.run(module) )
-        return false;
+    // This one runs independent of whether we're optimizing, but can
+    // still be disabled individually.
+    if ( options().optimizing("ctors") ) {
+        _beginPass(module, optimize_ctors);
 
-    _endPass();
+        if ( ! optimize_ctors.run(module) )
+            return false;
+
+        _endPass();
+    }
 
     _beginPass(module, validator);
 
@@ -340,10 +349,23 @@ bool CompilerContext::_finalizeModule(shared_ptr<Module> module, bool verify)
 
     _endPass();
 
+    if ( optimize("exceptions") ) {
+        _beginPass(module, optimize_exceptions);
+
+        if ( ! optimize_exceptions.run(module) )
+            return false;
+
+        _endPass();
+    }
+
     auto cfg = std::make_shared<passes::CFG>(this);
     auto liveness = std::make_shared<passes::Liveness>(this, cfg);
+    shared_ptr<passes::RefCountElision> rce = nullptr;
+
+    if ( optimize("refcounts") )
+        rce = std::make_shared<passes::RefCountElision>(this, liveness);
 
-    module->setPasses(cfg, liveness);
+    module->setPasses(cfg, liveness, rce);
 
     _beginPass(module, *cfg);
 
@@ -359,6 +381,50 @@ bool CompilerContext::_finalizeModule(shared_ptr<Module> module, bool verify)
 
     _endPass();
 
+    if ( optimize("dead-code") ) {
+        passes::OptimizeDeadCode optimize_dead_code(this, liveness);
+
+        _beginPass(module, optimize_dead_code);
+
+        if ( ! optimize_dead_code.run(module) )
+            return false;
+
+        _endPass();
+
+        if ( optimize_dead_code.changed() ) {
+            // Data flow information is stale now, recompute.
+            cfg = std::make_shared<passes::CFG>(this);
+            liveness = std::make_shared<passes::Liveness>(this, cfg);
+
+            if ( rce )
+                rce = std::make_shared<passes::RefCountElision>(this, liveness);
+
+            module->setPasses(cfg, liveness, rce);
+
+            _beginPass(module, *cfg);
+
+            if ( ! cfg->run(module) )
+                return false;
+
+            _endPass();
+
+            _beginPass(module, *liveness);
+
+            if ( ! liveness->run(module) )
+                return false;
+
+            _endPass();
+        }
+    }
+
+    if ( rce ) {
+        _beginPass(module, *rce);
+
+        if ( ! rce->run(module) )
+            return false;
+
+        _endPass();
+    }
 
     return true;
 }
@@ -766,6 +832,19 @@ llvm::Module* CompilerContext::linkModules(string output, std::list<llvm::Module
         std::cerr << util::fmt("  Final set modules to link: %s ...", util::strjoin(names, ", ")) << std::endl;
     }
 
+    // Remember which functions we generated ourselves; these are the ones
+    // to instrument for profile-guided optimization.
+    std::set<string> generated;
+
+    if ( options().pgo_instrument ) {
+        for ( auto m : modules ) {
+            for ( auto f = m->begin(); f != m->end(); f++ ) {
+                if ( ! f->isDeclaration() )
+                    generated.insert(f->getName());
+            }
+        }
+    }
+
     _beginPass(output, linker);
 
     auto linked = linker.link(output, modules);
@@ -775,6 +854,17 @@ llvm::Module* CompilerContext::linkModules(string output, std::list<llvm::Module
 
     _endPass();
 
+    if ( options().pgo_instrument ) {
+        codegen::Optimizer optimizer(this);
+
+        _beginPass(output, "PGO-instrument");
+
+        if ( ! optimizer.instrument(linked, generated) )
+            return nullptr;
+
+        _endPass();
+    }
+
     if ( ! _optimize(linked, true) )
         return nullptr;
 
@@ -863,3 +953,9 @@ shared_ptr<util::cache::FileCache> CompilerContext::fileCache() const
 {
     return _cache;
 }
+
+string CompilerContext::profileDataFile(const string& module) const
+{
+    auto dir = options().module_cache.size() ? options().module_cache : string(".");
+    return ::util::fmt("%s/%s.pgo", dir, ::util::strreplace(module, "/", "_"));
+}
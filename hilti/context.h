@@ -318,6 +318,14 @@ public:
     /// a module's name.
     static std::string llvmGetModuleIdentifier(llvm::Module* module);
 
+    /// Returns the path of the file holding the profile recorded for a
+    /// linked module compiled with Options::pgo_instrument. The file is
+    /// located inside the module cache if one is configured, and in the
+    /// current directory otherwise.
+    ///
+    /// module: The name of the linked module.
+    string profileDataFile(const string& module) const;
+
 private:
     /// Optimizes an LLVM module according to the CompilerContext's options
     /// (including not at all if the options don't request optimization).
@@ -192,6 +192,11 @@ public:
    /// not show this instruction.
    bool hideInDebugTrace() const { return __hideInDebugTrace(); }
 
+   /// Returns true if the instruction has no side effects other than
+   /// setting its target, and never raises an exception. Optimizations may
+   /// remove such instructions if the target isn't used.
+   bool pure() const { return __pure(); }
+
    /// Returns the instructions successors blocks. For non-terminators, it
    /// will always returns an empty set.
    ///
@@ -452,6 +457,9 @@ protected:
 
    virtual bool __hideInDebugTrace() const { return false; }
 
+   // For internal use only. Will be overridden automagically via macros.
+   virtual bool __pure() const { return false; }
+
    // For internal use only. Will be overridden automagically via macros.
    virtual std::set<shared_ptr<Expression>> __successors(const hilti::instruction::Operands& ops) const { return std::set<shared_ptr<Expression>>(); }
 
@@ -11,6 +11,7 @@
 #include "define-instruction.h"
 
 iBegin(boolean, Equal, "equal")
+    iPure()
     iTarget(optype::boolean)
     iOp1(optype::boolean, true);
     iOp2(optype::boolean, true);
@@ -25,6 +26,7 @@ iBegin(boolean, Equal, "equal")
 iEnd
 
 iBegin(boolean, And, "bool.and")
+    iPure()
     iTarget(optype::boolean)
     iOp1(optype::boolean, true)
     iOp2(optype::boolean, true)
@@ -39,6 +41,7 @@ iBegin(boolean, And, "bool.and")
 iEnd
 
 iBegin(boolean, Not, "bool.not")
+    iPure()
     iTarget(optype::boolean)
     iOp1(optype::boolean, true)
 
@@ -52,6 +55,7 @@ iBegin(boolean, Not, "bool.not")
 iEnd
 
 iBegin(boolean, Or, "bool.or")
+    iPure()
     iTarget(optype::boolean)
     iOp1(optype::boolean, true)
     iOp2(optype::boolean, true)
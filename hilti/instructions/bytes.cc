@@ -170,6 +170,18 @@ iBeginCC(bytes)
 
 iEndCC
 
+iBeginCC(bytes)
+    iValidateCC(MatchAt) {
+    }
+
+    iDocCC(MatchAt, R"(
+        Matches *op2* against the data starting at position *op1*. Returns 1 if it matches, 0 if it doesn't,
+        and -1 if the data ends before that can be decided (i.e., more data would need to be appended to the
+        underlying bytes object). If *op2* is a constant, the comparison does not allocate any memory.
+    )")
+
+iEndCC
+
 iBeginCC(bytes)
     iValidateCC(Offset) {
     }
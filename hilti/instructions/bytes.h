@@ -108,6 +108,12 @@ iBeginH(bytes, FindAtIter, "bytes.find")
     iOp2(optype::refBytes, true);
 iEndH
 
+iBeginH(bytes, MatchAt, "bytes.match_at")
+    iTarget(optype::int8)
+    iOp1(optype::iterBytes, true);
+    iOp2(optype::refBytes, true);
+iEndH
+
 iBeginH(bytes, Offset, "bytes.offset")
     iTarget(optype::iterBytes);
     iOp1(optype::refBytes, true);
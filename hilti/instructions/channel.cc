@@ -7,13 +7,26 @@
 iBeginCC(channel)
     iValidateCC(New) {
         equalTypes(referencedType(target), typedType(op1));
+
+        if ( op3 ) {
+            if ( ! isConstant(op3) )
+                return;
+
+            if ( ! op2 )
+                error(op3, "a single-producer/single-consumer channel needs a capacity");
+        }
     }
 
     iDocCC(New, R"(
          Allocates a new instance of a channel storing elements of type *op1*.
          *op2* defines the channel's capacity, i.e., the maximal number of items it
          can store. The capacity defaults to zero, which creates a channel of
-         unbounded capacity.
+         unbounded capacity. If the constant *op3* is True, the channel is for
+         use by a single writer and a single reader only, which lets it store
+         its items in a lock-free ring buffer; such a channel requires a
+         positive capacity, and it is undefined what happens if more than one
+         thread writes to, or reads from, it. *op3* defaults to False.
+         Raises: ~~ValueError if *op3* is True and the capacity isn't positive.
     )")
 iEndCC
 
@@ -41,6 +54,22 @@ iBeginCC(channel)
     )")
 iEndCC
 
+iBeginCC(channel)
+    iValidateCC(ReadBatch) {
+        equalTypes(elementType(op2), argType(op1));
+    }
+
+    iDocCC(ReadBatch, R"(
+        Reads up to *op3* items from the channel referenced by *op1* into
+        vector *op2*, and returns the number of items read. Afterwards, *op2*
+        contains exactly those items, in the order they were read. If the
+        channel is empty, the instruction blocks until an item becomes
+        available. Compared to reading items one by one, a batch
+        synchronizes with the writer only once.
+        Raises: ~~ValueError if *op3* isn't positive.
+    )")
+iEndCC
+
 iBeginCC(channel)
     iValidateCC(Size) {
     }
@@ -72,3 +101,18 @@ iBeginCC(channel)
         full, the instruction raises a ``WouldBlock`` exception.
     )")
 iEndCC
+
+iBeginCC(channel)
+    iValidateCC(WriteBatch) {
+        equalTypes(elementType(op2), argType(op1));
+    }
+
+    iDocCC(WriteBatch, R"(
+        Writes the items of vector *op2* into the channel referenced by
+        *op1*, in order, and returns the number of items written. The
+        instruction writes as many items as the channel can currently
+        accomodate. If it can't write any, it blocks until a slot becomes
+        available. Compared to writing items one by one, a batch
+        synchronizes with the reader only once.
+    )")
+iEndCC
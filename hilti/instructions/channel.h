@@ -14,6 +14,10 @@
 ///         writable again. By default, channels are unbounded and can grow
 ///         arbitrarily large.
 ///
+/// * Concurrency. A channel created for a single writer and a single
+///         reader stores its items in a lock-free ring buffer. Such a
+///         channel must be bounded.
+///
 /// \cproto hlt_channel*
 ///
 
@@ -23,6 +27,7 @@ iBeginH(channel, New, "new")
     iTarget(optype::refChannel)
     iOp1(optype::typeChannel, true);
     iOp2(optype::optional(optype::int64), true);
+    iOp3(optype::optional(optype::boolean), true);
 iEndH
 
 iBeginH(channel, Read, "channel.read")
@@ -35,6 +40,13 @@ iBeginH(channel, ReadTry, "channel.read_try")
     iOp1(optype::refChannel, true)
 iEndH
 
+iBeginH(channel, ReadBatch, "channel.read_batch")
+    iTarget(optype::int64)
+    iOp1(optype::refChannel, true)
+    iOp2(optype::refVector, false)
+    iOp3(optype::int64, true)
+iEndH
+
 iBeginH(channel, Size, "channel.size")
     iTarget(optype::int64)
     iOp1(optype::refChannel, true)
@@ -50,3 +62,8 @@ iBeginH(channel, WriteTry, "channel.write_try")
     iOp2(optype::any, false)
 iEndH
 
+iBeginH(channel, WriteBatch, "channel.write_batch")
+    iTarget(optype::int64)
+    iOp1(optype::refChannel, false)
+    iOp2(optype::refVector, true)
+iEndH
@@ -158,6 +158,10 @@
 
 #define iHideInDebugTrace() bool __hideInDebugTrace() const override { return true; }
 
+/// Marks an instruction as having no side effects other than setting its
+/// target, and as never raising an exception.
+#define iPure() bool __pure() const override { return true; }
+
 /// Defines a default for an instruction's 1st operand.
 ///
 /// def: The default Expression for the operand.
@@ -32,6 +32,7 @@
 #include "define-instruction.h"
 
 iBegin(integer, Equal, "equal")
+    iPure()
     iTarget(optype::boolean)
     iOp1(optype::integer, true);
     iOp2(optype::integer, true);
@@ -46,6 +47,7 @@ iBegin(integer, Equal, "equal")
 iEnd
 
 iBegin(integer, Incr, "incr")
+    iPure()
     iTarget(optype::integer);
     iOp1(optype::integer, true);
 
@@ -59,6 +61,7 @@ iBegin(integer, Incr, "incr")
 iEnd
 
 iBegin(integer, IncrBy, "incr_by")
+    iPure()
     iTarget(optype::integer);
     iOp1(optype::integer, true);
     iOp2(optype::integer, true);
@@ -72,6 +75,7 @@ iBegin(integer, IncrBy, "incr_by")
 iEnd
 
 iBegin(integer, Decr, "decr")
+    iPure()
     iTarget(optype::integer);
     iOp1(optype::integer, true);
 
@@ -85,6 +89,7 @@ iBegin(integer, Decr, "decr")
 iEnd
 
 iBegin(integer, DecrBy, "decr_by")
+    iPure()
     iTarget(optype::integer);
     iOp1(optype::integer, true);
     iOp2(optype::integer, true);
@@ -98,6 +103,7 @@ iBegin(integer, DecrBy, "decr_by")
 iEnd
 
 iBegin(integer, Add, "int.add")
+    iPure()
     iTarget(optype::integer)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -116,6 +122,7 @@ iEnd
 
 
 iBegin(integer, Sub, "int.sub")
+    iPure()
     iTarget(optype::integer)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -162,6 +169,7 @@ iBegin(integer, Div, "int.div")
 iEnd
 
 iBegin(integer, Sleq, "int.sleq")
+    iPure()
     iTarget(optype::boolean)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -178,6 +186,7 @@ iBegin(integer, Sleq, "int.sleq")
 iEnd
 
 iBegin(integer, AsSDouble, "int.as_sdouble")
+    iPure()
     iTarget(optype::double_)
     iOp1(optype::integer, true)
 
@@ -207,6 +216,7 @@ iBegin(integer, Pow, "int.pow")
 iEnd
 
 iBegin(integer, SExt, "int.sext")
+    iPure()
     iTarget(optype::integer)
     iOp1(optype::integer, true)
 
@@ -226,6 +236,7 @@ iBegin(integer, SExt, "int.sext")
 iEnd
 
 iBegin(integer, Shr, "int.shr")
+    iPure()
     iTarget(optype::integer)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -244,6 +255,7 @@ iBegin(integer, Shr, "int.shr")
 iEnd
 
 iBegin(integer, Mul, "int.mul")
+    iPure()
     iTarget(optype::integer)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -261,6 +273,7 @@ iBegin(integer, Mul, "int.mul")
 iEnd
 
 iBegin(integer, Shl, "int.shl")
+    iPure()
     iTarget(optype::integer)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -279,6 +292,7 @@ iBegin(integer, Shl, "int.shl")
 iEnd
 
 iBegin(integer, Ult, "int.ult")
+    iPure()
     iTarget(optype::boolean)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -295,6 +309,7 @@ iBegin(integer, Ult, "int.ult")
 iEnd
 
 iBegin(integer, Uleq, "int.uleq")
+    iPure()
     iTarget(optype::boolean)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -311,6 +326,7 @@ iBegin(integer, Uleq, "int.uleq")
 iEnd
 
 iBegin(integer, Ashr, "int.ashr")
+    iPure()
     iTarget(optype::integer)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -330,6 +346,7 @@ iBegin(integer, Ashr, "int.ashr")
 iEnd
 
 iBegin(integer, Mask, "int.mask")
+    iPure()
     iTarget(optype::integer)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -375,6 +392,7 @@ iBegin(integer, Mod, "int.mod")
 iEnd
 
 iBegin(integer, Eq, "int.eq")
+    iPure()
     iTarget(optype::boolean)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -390,6 +408,7 @@ iBegin(integer, Eq, "int.eq")
 iEnd
 
 iBegin(integer, ZExt, "int.zext")
+    iPure()
     iTarget(optype::integer)
     iOp1(optype::integer, true)
 
@@ -422,6 +441,7 @@ iBegin(integer, AsTime, "int.as_time")
 iEnd
 
 iBegin(integer, Slt, "int.slt")
+    iPure()
     iTarget(optype::boolean)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -438,6 +458,7 @@ iBegin(integer, Slt, "int.slt")
 iEnd
 
 iBegin(integer, Trunc, "int.trunc")
+    iPure()
     iTarget(optype::integer)
     iOp1(optype::integer, true)
 
@@ -457,6 +478,7 @@ iBegin(integer, Trunc, "int.trunc")
 iEnd
 
 iBegin(integer, Sgeq, "int.sgeq")
+    iPure()
     iTarget(optype::boolean)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -473,6 +495,7 @@ iBegin(integer, Sgeq, "int.sgeq")
 iEnd
 
 iBegin(integer, AsUDouble, "int.as_udouble")
+    iPure()
     iTarget(optype::double_)
     iOp1(optype::integer, true)
 
@@ -486,6 +509,7 @@ iBegin(integer, AsUDouble, "int.as_udouble")
 iEnd
 
 iBegin(integer, Or, "int.or")
+    iPure()
     iTarget(optype::integer)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -503,6 +527,7 @@ iBegin(integer, Or, "int.or")
 iEnd
 
 iBegin(integer, Ugeq, "int.ugeq")
+    iPure()
     iTarget(optype::boolean)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -519,6 +544,7 @@ iBegin(integer, Ugeq, "int.ugeq")
 iEnd
 
 iBegin(integer, Sgt, "int.sgt")
+    iPure()
     iTarget(optype::boolean)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -548,6 +574,7 @@ iBegin(integer, AsInterval, "int.as_interval")
 iEnd
 
 iBegin(integer, Xor, "int.xor")
+    iPure()
     iTarget(optype::integer)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -565,6 +592,7 @@ iBegin(integer, Xor, "int.xor")
 iEnd
 
 iBegin(integer, And, "int.and")
+    iPure()
     iTarget(optype::integer)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -582,6 +610,7 @@ iBegin(integer, And, "int.and")
 iEnd
 
 iBegin(integer, Ugt, "int.ugt")
+    iPure()
     iTarget(optype::boolean)
     iOp1(optype::integer, true)
     iOp2(optype::integer, true)
@@ -626,6 +655,7 @@ iBegin(integer, FromHost, "int.from_host")
 iEnd     
 
 iBegin(integer, Flip, "int.flip")
+    iPure()
     iTarget(optype::integer)
     iOp1(optype::integer, true)
 
@@ -71,7 +71,12 @@ iBeginCC(ioSource)
         Instantiates a new *iosrc* instance, and initializes it for reading.
         The format of string *op2* is depending on the kind of ``iosrc``. For
         :hlt:glob:`PcapLive`, it is the name of the local interface to IOSourceen
-        on. For :hlt:glob:`PcapLive`, it is the name of the trace file.
+        on. For :hlt:glob:`PcapLive`, it is the name of the trace file. For
+        :hlt:glob:`PacketRing`, it is the name of the local interface,
+        optionally followed by ``@<n>`` to join the fanout group with ID
+        *n*; the kernel then spreads the interface's flows across all
+        sources in the group, such as one per virtual thread. Packet rings
+        are available only on Linux.
 
         Raises: :hlt:type:`IOSrcError` if the packet source cannot be opened.
     )")
@@ -104,3 +109,42 @@ iBeginCC(ioSource)
     )")
 
 iEndCC
+
+iBeginCC(ioSource)
+    iValidateCC(ReadBatch) {
+        auto ttype = ast::as<type::Tuple>(elementType(op2));
+
+        if ( ! ttype || ttype->typeList().size() != 2 ) {
+            error(op2, "vector must have elements of type tuple<time, ref<bytes>>");
+            return;
+        }
+
+        auto j = ttype->typeList().begin();
+        auto time = *j++;
+        auto rtype = ast::as<type::Reference>(*j++);
+
+        if ( ! ast::isA<type::Time>(time) || ! rtype || ! ast::isA<type::Bytes>(rtype->argType()) )
+            error(op2, "vector must have elements of type tuple<time, ref<bytes>>");
+    }
+
+    iDocCC(ReadBatch, R"(
+        Reads up to *op3* elements from the I/O source *op1* into vector
+        *op2*, and returns the number of elements read. Afterwards, *op2*
+        contains exactly those elements, in the order they were read, so
+        that one can then iterate over the batch with a ``for`` loop. If
+        currently no element is available, the instruction blocks until at
+        least one is. The instruction returns zero once the source has been
+        exhausted. When passed the same vector repeatedly, the instruction
+        reuses its storage, but each element gets a new ``bytes`` object, so
+        elements of earlier batches remain valid.
+        For a :hlt:glob:`PacketRing` source, a batch corresponds to (part
+        of) one of the kernel's ring blocks, and its elements reference the
+        ring's memory without copying. A block goes back to the kernel once
+        its packets are no longer in use. If a program holds on to packets
+        from too many blocks, those get copied, unless iterators point into
+        them; such packets keep their block until they go away.
+        Raises: ~~IOSrcError if there is any other problem with returning
+        the next elements; ~~ValueError if *op3* isn't positive.
+    )")
+
+iEndCC
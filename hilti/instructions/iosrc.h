@@ -58,3 +58,10 @@ iBeginH(ioSource, Read, "iosrc.read")
     iTarget(optype::tuple)
     iOp1(optype::refIOSource, false)
 iEndH
+
+iBeginH(ioSource, ReadBatch, "iosrc.read_batch")
+    iTarget(optype::int64)
+    iOp1(optype::refIOSource, false)
+    iOp2(optype::refVector, false)
+    iOp3(optype::int64, true)
+iEndH
@@ -280,3 +280,25 @@ iBegin(map, Timeout, "map.timeout")
 
 iEnd
 
+
+iBegin(map, Changes, "map.changes")
+    iTarget(optype::refSet)
+    iOp1(optype::refMap, false)
+
+    iValidate {
+        equalTypes(elementType(referencedType(target)), mapKeyType(referencedType(op1)));
+    }
+
+    iDoc(R"(
+        Returns a set of all keys that have been inserted, replaced, or
+        removed in map *op1* since the last time the instruction executed
+        for the same map, including keys of expired entries. The map starts
+        recording changes only with the first execution, which returns Null.
+        Once more keys have changed than the map holds, it stops recording
+        and the next execution returns Null again.
+        Modifications inside of values that the map holds by reference are
+        not recorded. This allows to keep a copy of a large map in sync
+        incrementally.
+    )")
+
+iEnd
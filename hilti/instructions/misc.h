@@ -2,6 +2,7 @@
 #include "define-instruction.h"
 
 iBeginH(Misc, Select, "select")
+    iPure()
     iTarget(optype::any)
     iOp1(optype::boolean, true)
     iOp2(optype::any, true)
@@ -16,4 +17,5 @@ iBeginH(Misc, SelectValue, "select.value")
 iEndH
 
 iBeginH(Misc, Nop, "nop")
+    iPure()
 iEndH
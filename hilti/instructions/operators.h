@@ -76,6 +76,7 @@ iBegin(operator_, Unequal, "unequal")
 iEnd
 
 iBegin(operator_, Assign, "assign")
+    iPure()
     iTarget(optype::any)
     iOp1(optype::any, false)
 
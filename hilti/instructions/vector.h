@@ -143,6 +143,28 @@ iBegin(vector, PushBack, "vector.push_back")
 
 iEnd
 
+iBegin(vector, PushBackUnpacked, "vector.push_back_unpacked")
+    iOp1(optype::refVector, false)
+    iOp2(optype::tuple, true)
+    iOp3(optype::enum_, true)
+
+    iValidate {
+        if ( ! ast::isA<type::Integer>(elementType(referencedType(op1))) )
+            error(op1, "vector must have elements of integer type");
+    }
+
+    iDoc(R"(    
+        Appends integers to vector *op1* that are unpacked from the binary
+        data enclosed by the iterator tuple *op2*, using byte order *op3* of
+        type ``Hilti::ByteOrder``. Each element occupies as many bytes as its
+        width; trailing bytes not forming a full element are ignored. The
+        result is the same as unpacking each element individually and adding
+        it with ``vector.push_back``, but much faster for long runs. All the
+        data must already be available.
+    )")
+
+iEnd
+
 iBegin(vector, Reserve, "vector.reserve")
     iOp1(optype::refVector, false)
     iOp2(optype::int64, true)
@@ -290,7 +290,7 @@ llvm::ExecutionEngine* JIT::jitModule(llvm::Module* module)
 
     llvm::TargetOptions Options;
 #ifdef HAVE_LLVM_33
-    Options.JITExceptionHandling = false;
+    Options.JITExceptionHandling = _ctx->options().unwind_exceptions;
 #endif
     Options.JITEmitDebugInfo = true;
     Options.JITEmitDebugInfoToDisk = false;
@@ -1,4 +1,6 @@
 
+#include <dlfcn.h>
+
 #include "libhilti-jit.h"
 #include "../context.h"
 
@@ -46,22 +48,25 @@ extern "C" {
 
 static struct __hlt_linker_functions _funcs;
 
-void hlt_init_jit(std::shared_ptr<hilti::CompilerContext> ctx, llvm::Module* module, llvm::ExecutionEngine* ee)
+// Shared initialization for JITed code and precompiled bundles; the two
+// differ only in how they look up the linker-generated functions.
+template<typename Lookup>
+static void _hlt_init_with(Lookup lookup)
 {
-    auto f = ctx->nativeFunction(module, ee, "__hlt_init_from_state");
+    auto f = lookup("__hlt_init_from_state");
     auto hlt_init_from_state = (void (*)(__hlt_global_state*))f;
     assert(hlt_init_from_state);
 
-    f = ctx->nativeFunction(module, ee, "__hlt_modules_init");
+    f = lookup("__hlt_modules_init");
     auto modules_init = (void (*)(void*))f;
 
-    f = ctx->nativeFunction(module, ee, "__hlt_globals_init");
+    f = lookup("__hlt_globals_init");
     auto globals_init = (void (*)(void*))f;
 
-    f = ctx->nativeFunction(module, ee, "__hlt_globals_dtor");
+    f = lookup("__hlt_globals_dtor");
     auto globals_dtor = (void (*)(void*))f;
 
-    f = ctx->nativeFunction(module, ee, "__hlt_globals_size");
+    f = lookup("__hlt_globals_size");
     auto globals_size = (int64_t (*)())f;
 
     _funcs.__hlt_modules_init = modules_init;
@@ -75,12 +80,32 @@ void hlt_init_jit(std::shared_ptr<hilti::CompilerContext> ctx, llvm::Module* mod
     hlt_init();
 }
 
-void binpac_init_jit(std::shared_ptr<hilti::CompilerContext> ctx, llvm::Module* module, llvm::ExecutionEngine* ee)
+template<typename Lookup>
+static void _binpac_init_with(Lookup lookup)
 {
-    auto f = ctx->nativeFunction(module, ee, "__binpac_init_from_state");
+    auto f = lookup("__binpac_init_from_state");
     auto binpac_init_from_state = (void (*)(__binpac_globals*))f;
 
     if ( binpac_init_from_state && __binpac_globals_get() )
         (*binpac_init_from_state)(__binpac_globals_get());
 }
 
+void hlt_init_jit(std::shared_ptr<hilti::CompilerContext> ctx, llvm::Module* module, llvm::ExecutionEngine* ee)
+{
+    _hlt_init_with([&](const char* name) { return ctx->nativeFunction(module, ee, name); });
+}
+
+void binpac_init_jit(std::shared_ptr<hilti::CompilerContext> ctx, llvm::Module* module, llvm::ExecutionEngine* ee)
+{
+    _binpac_init_with([&](const char* name) { return ctx->nativeFunction(module, ee, name); });
+}
+
+void hlt_init_bundle(void* handle)
+{
+    _hlt_init_with([&](const char* name) { return dlsym(handle, name); });
+}
+
+void binpac_init_bundle(void* handle)
+{
+    _binpac_init_with([&](const char* name) { return dlsym(handle, name); });
+}
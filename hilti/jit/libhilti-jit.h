@@ -41,4 +41,15 @@ namespace llvm {
 extern void hlt_init_jit(std::shared_ptr<hilti::CompilerContext> ctx, llvm::Module* module, llvm::ExecutionEngine* ee);
 extern void binpac_init_jit(std::shared_ptr<hilti::CompilerContext> ctx, llvm::Module* module, llvm::ExecutionEngine* ee);
 
+/// Initializes the HILTI run-time library for a precompiled bundle, i.e., a
+/// shared object built ahead of time from a linked module (see \c
+/// hilti-build --shared). This must be called instead of \a hlt_init_jit()
+/// when code comes from such a bundle rather than from the JIT; no LLVM
+/// machinery is involved. Like \a hlt_init_jit(), it also takes care of
+/// BinPAC++ if the counterpart \a binpac_init_bundle() is called.
+///
+/// handle: The handle that \c dlopen() returned for the bundle.
+extern void hlt_init_bundle(void* handle);
+extern void binpac_init_bundle(void* handle);
+
 #endif
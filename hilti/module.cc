@@ -59,8 +59,14 @@ shared_ptr<passes::Liveness> Module::liveness() const
     return _liveness;
 }
 
-void Module::setPasses(shared_ptr<passes::CFG> cfg, shared_ptr<passes::Liveness> liveness)
+shared_ptr<passes::RefCountElision> Module::refCountElision() const
+{
+    return _rce;
+}
+
+void Module::setPasses(shared_ptr<passes::CFG> cfg, shared_ptr<passes::Liveness> liveness, shared_ptr<passes::RefCountElision> rce)
 {
     _cfg = cfg;
     _liveness = liveness;
+    _rce = rce;
 }
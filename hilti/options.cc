@@ -32,7 +32,7 @@ Options::string_set Options::cgDebugLabels() const
 
 Options::string_set Options::optimizationLabels() const
 {
-    return string_set();
+    return { "ctors", "dead-code", "exceptions", "fold", "hooks", "refcounts" };
 }
 
 void Options::toCacheKey(::util::cache::FileCache::Key* key) const
@@ -41,6 +41,9 @@ void Options::toCacheKey(::util::cache::FileCache::Key* key) const
     key->options += (optimize ? "O" : "o");
     key->options += (profile ? ::util::fmt("P%d", profile) : "p");
     key->options += (verify ? "V" : "v");
+    key->options += (pgo_instrument ? "G" : "g");
+    key->options += (pgo_use ? "U" : "u");
+    key->options += (unwind_exceptions ? "E" : "e");
 
     for ( auto d : libdirs_hlt )
         key->dirs.insert(d);
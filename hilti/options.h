@@ -67,6 +67,26 @@ public:
     /// is disabled.
     string module_cache;
 
+    /// If true, instrument the final linked module for profile-guided
+    /// optimization. The generated code then counts how often each of its
+    /// basic blocks executes, and writes the counts out on termination into
+    /// a profile file next to the module cache (see
+    /// CompilerContext::profileDataFile()).
+    bool pgo_instrument = false;
+
+    /// If true, apply a profile previously recorded with \a pgo_instrument
+    /// when optimizing the final linked module. This has an effect only
+    /// with \a optimize set, and is ignored if no matching profile exists.
+    bool pgo_use = false;
+
+    /// If true, calls between HILTI functions of the same module propagate
+    /// exceptions through native stack unwinding rather than by checking
+    /// the execution context after each call. That removes the check from
+    /// the common case of no exception, at the expense of making a raised
+    /// exception more expensive. Calls across modules and from/to C keep
+    /// the checks. Ignored when profiling is enabled.
+    bool unwind_exceptions = false;
+
     /// Returns true if the given label is enabled in \a optimization. This
     /// is just a convinience method.
     bool optimizing(const string& label) const;
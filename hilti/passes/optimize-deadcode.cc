@@ -0,0 +1,118 @@
+
+#include "../statement.h"
+#include "../module.h"
+#include "../context.h"
+#include "../options.h"
+#include "../builder/nodes.h"
+
+#include "optimize-deadcode.h"
+#include "liveness.h"
+#include "hilti/autogen/instructions.h"
+
+using namespace hilti;
+using namespace passes;
+
+OptimizeDeadCode::OptimizeDeadCode(CompilerContext* context, shared_ptr<Liveness> liveness)
+    : Pass<>("hilti::OptimizeDeadCode", true)
+{
+    _context = context;
+    _liveness = liveness;
+}
+
+bool OptimizeDeadCode::run(shared_ptr<hilti::Node> module)
+{
+    _changed = false;
+    _num_stores = 0;
+    _num_blocks = 0;
+
+    if ( ! processAllPreOrder(module) )
+        return false;
+
+    if ( _context->options().cgDebugging("liveness") )
+        std::cerr << util::fmt("OptimizeDeadCode: removed %d dead stores and %d unreachable blocks", _num_stores, _num_blocks) << std::endl;
+
+    return true;
+}
+
+void OptimizeDeadCode::visit(declaration::Function* f)
+{
+    auto body = ast::tryCast<statement::Block>(f->function()->body());
+
+    if ( ! body )
+        return;
+
+    // After flattening, the body is a sequence of blocks. A block is
+    // reachable if the previous one falls through into it, or if some
+    // instruction refers to it. We iterate because removing one block may
+    // leave others unreferenced.
+    bool changed = true;
+
+    while ( changed ) {
+        changed = false;
+
+        std::set<statement::Block*> referenced;
+
+        for ( auto n : body->childs(true) ) {
+            if ( auto e = ast::tryCast<expression::Block>(n) )
+                referenced.insert(e->block().get());
+        }
+
+        statement::Block::stmt_list nstmts;
+        bool fallthrough = true;
+
+        for ( auto s : body->statements() ) {
+            auto b = ast::tryCast<statement::Block>(s);
+
+            if ( ! b ) {
+                auto i = ast::tryCast<statement::instruction::Resolved>(s);
+                fallthrough = ! (i && i->instruction()->terminator());
+                nstmts.push_back(s);
+                continue;
+            }
+
+            bool reachable = fallthrough || referenced.find(b.get()) != referenced.end();
+
+            if ( ! reachable && b->declarations().empty() ) {
+                ++_num_blocks;
+                changed = _changed = true;
+                continue;
+            }
+
+            fallthrough = ! b->terminated();
+            nstmts.push_back(s);
+        }
+
+        if ( changed )
+            body->setStatements(nstmts);
+    }
+}
+
+void OptimizeDeadCode::visit(statement::instruction::Resolved* s)
+{
+    if ( ! s->instruction()->pure() || ! s->target() )
+        return;
+
+    auto var = ast::tryCast<expression::Variable>(s->target());
+
+    if ( ! (var && ast::isA<variable::Local>(var->variable())) )
+        return;
+
+    auto stmt = s->sharedPtr<Statement>();
+
+    if ( ! _liveness->have(stmt) )
+        // Not reached by the data flow analysis.
+        return;
+
+    if ( _liveness->liveOut(stmt, var) )
+        return;
+
+    instruction::Operands ops = { nullptr, nullptr, nullptr, nullptr };
+    auto matches = InstructionRegistry::globalRegistry()->getMatching(std::make_shared<ID>("nop"), ops);
+    assert(matches.size() == 1);
+
+    auto nop = (*matches.front()->factory())(matches.front(), ops, s->location());
+    s->replace(nop);
+
+    ++_num_stores;
+    _changed = true;
+}
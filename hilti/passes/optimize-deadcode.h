@@ -0,0 +1,46 @@
+#ifndef HILTI_PASSES_OPTIMIZE_DEADCODE_H
+#define HILTI_PASSES_OPTIMIZE_DEADCODE_H
+
+#include "../pass.h"
+
+namespace hilti {
+
+class CompilerContext;
+
+namespace passes {
+
+class Liveness;
+
+/// Removes code that has no effect: blocks that control flow can never
+/// reach, and pure instructions (see Instruction::pure()) whose target is
+/// a local that isn't live afterwards. The latter relies on the liveness
+/// information having been computed already. If the pass changes
+/// anything, that information is no longer accurate and needs to be
+/// recomputed.
+class OptimizeDeadCode : public Pass<>
+{
+public:
+   /// Constructor.
+   OptimizeDeadCode(CompilerContext* context, shared_ptr<Liveness> liveness);
+
+   bool run(shared_ptr<hilti::Node> module);
+
+   /// Returns true if the last run() modified the module.
+   bool changed() const { return _changed; }
+
+protected:
+   virtual void visit(declaration::Function* f);
+   virtual void visit(statement::instruction::Resolved* s);
+
+private:
+   CompilerContext* _context;
+   shared_ptr<Liveness> _liveness;
+   bool _changed = false;
+   int _num_stores = 0;
+   int _num_blocks = 0;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,91 @@
+
+#include "../statement.h"
+#include "../module.h"
+#include "../function.h"
+
+#include "optimize-exceptions.h"
+#include "hilti/autogen/instructions.h"
+
+using namespace hilti;
+using namespace passes;
+
+OptimizeExceptions::OptimizeExceptions() : Pass<>("hilti::OptimizeExceptions", true)
+{
+}
+
+bool OptimizeExceptions::run(shared_ptr<hilti::Node> node)
+{
+    auto module = ast::checkedCast<Module>(node);
+
+    std::list<shared_ptr<Function>> candidates;
+
+    for ( auto d : module->body()->declarations() ) {
+        auto fdecl = ast::tryCast<declaration::Function>(d);
+
+        if ( ! fdecl || ast::isA<declaration::Hook>(fdecl) )
+            continue;
+
+        auto func = fdecl->function();
+        auto ftype = func->type();
+
+        if ( ! func->body() || ftype->callingConvention() != type::function::HILTI )
+            continue;
+
+        if ( ftype->attributes().has(attribute::NOEXCEPTION) )
+            continue;
+
+        candidates.push_back(func);
+    }
+
+    // Marking one function may qualify its callers, so iterate until
+    // nothing changes anymore.
+    bool changed = true;
+
+    while ( changed ) {
+        changed = false;
+
+        for ( auto i = candidates.begin(); i != candidates.end(); ) {
+            if ( mayThrow(*i) ) {
+                ++i;
+                continue;
+            }
+
+            (*i)->type()->attributes().add(attribute::NOEXCEPTION);
+            i = candidates.erase(i);
+            changed = true;
+        }
+    }
+
+    return true;
+}
+
+bool OptimizeExceptions::mayThrow(shared_ptr<Function> func) const
+{
+    for ( auto n : func->body()->childs(true) ) {
+        auto s = ast::tryCast<statement::instruction::Resolved>(n);
+
+        if ( ! s || s->instruction()->pure() )
+            continue;
+
+        if ( ast::isA<statement::instruction::flow::ReturnVoid>(s) ||
+             ast::isA<statement::instruction::flow::ReturnResult>(s) ||
+             ast::isA<statement::instruction::flow::BlockEnd>(s) ||
+             ast::isA<statement::instruction::flow::Jump>(s) ||
+             ast::isA<statement::instruction::flow::IfElse>(s) ||
+             ast::isA<statement::instruction::flow::Switch>(s) )
+            continue;
+
+        if ( ast::isA<statement::instruction::flow::CallVoid>(s) ||
+             ast::isA<statement::instruction::flow::CallResult>(s) ) {
+            auto ftype = ast::tryCast<type::Function>(s->op1()->type());
+
+            if ( ftype && ftype->callingConvention() != type::function::HOOK &&
+                 ftype->attributes().has(attribute::NOEXCEPTION) )
+                continue;
+        }
+
+        return true;
+    }
+
+    return false;
+}
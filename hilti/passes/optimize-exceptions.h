@@ -0,0 +1,28 @@
+#ifndef HILTI_PASSES_OPTIMIZE_EXCEPTIONS_H
+#define HILTI_PASSES_OPTIMIZE_EXCEPTIONS_H
+
+#include "../pass.h"
+
+namespace hilti {
+namespace passes {
+
+/// Marks HILTI functions as \c &noexception if they provably can't raise an
+/// exception, so that the code generator can skip checking for one after
+/// calls to them. A function qualifies if all its instructions are pure
+/// (see Instruction::pure()), transfer control locally, or call other
+/// functions marked \c &noexception.
+class OptimizeExceptions : public Pass<>
+{
+public:
+   OptimizeExceptions();
+
+   bool run(shared_ptr<hilti::Node> module);
+
+private:
+   bool mayThrow(shared_ptr<Function> func) const;
+};
+
+}
+}
+
+#endif
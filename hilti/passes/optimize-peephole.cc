@@ -10,6 +10,60 @@
 using namespace hilti;
 using namespace passes;
 
+// Returns the value of an integer constant operand, truncated to the
+// given width, or false if the operand isn't one.
+static bool _intConstant(shared_ptr<Expression> op, int width, uint64_t* result)
+{
+    auto e = ast::tryCast<expression::Constant>(op);
+
+    if ( ! e )
+        return false;
+
+    auto c = ast::tryCast<constant::Integer>(e->constant());
+
+    if ( ! c )
+        return false;
+
+    uint64_t v = (uint64_t)c->value();
+
+    if ( width < 64 )
+        v &= ((uint64_t)1 << width) - 1;
+
+    *result = v;
+    return true;
+}
+
+static int _intWidth(shared_ptr<Expression> op)
+{
+    auto t = ast::tryCast<type::Integer>(op->type());
+    return t ? t->width() : 0;
+}
+
+static int64_t _signExtend(uint64_t v, int width)
+{
+    if ( width >= 64 )
+        return (int64_t)v;
+
+    uint64_t sign = (uint64_t)1 << (width - 1);
+    return (int64_t)((v ^ sign) - sign);
+}
+
+static bool _boolConstant(shared_ptr<Expression> op, bool* result)
+{
+    auto e = ast::tryCast<expression::Constant>(op);
+
+    if ( ! e )
+        return false;
+
+    auto c = ast::tryCast<constant::Bool>(e->constant());
+
+    if ( ! c )
+        return false;
+
+    *result = c->value();
+    return true;
+}
+
 OptimizePeepHole::OptimizePeepHole() : Pass<>("hilti::OptimizePeepHole", true)
 {
 }
@@ -18,3 +72,198 @@ bool OptimizePeepHole::run(shared_ptr<hilti::Node> module)
 {
     return processAllPreOrder(module);
 }
+
+void OptimizePeepHole::replaceWith(statement::instruction::Resolved* i, const string& name, shared_ptr<Expression> op1)
+{
+    instruction::Operands ops = { i->target(), op1, nullptr, nullptr };
+    auto matches = InstructionRegistry::globalRegistry()->getMatching(std::make_shared<ID>(name), ops);
+
+    if ( matches.size() != 1 )
+        // Leave it alone, the instruction will do the right thing.
+        return;
+
+    auto nstmt = (*matches.front()->factory())(matches.front(), ops, i->location());
+    i->replace(nstmt);
+}
+
+void OptimizePeepHole::foldInteger(statement::instruction::Resolved* i, int_op op)
+{
+    int width = _intWidth(i->target());
+
+    if ( ! width )
+        return;
+
+    uint64_t a, b;
+
+    if ( ! (_intConstant(i->op1(), width, &a) && _intConstant(i->op2(), width, &b)) )
+        return;
+
+    uint64_t v = op(a, b, width);
+
+    if ( width < 64 )
+        v &= ((uint64_t)1 << width) - 1;
+
+    auto c = std::make_shared<constant::Integer>(_signExtend(v, width), width, i->location());
+    replaceWith(i, "assign", std::make_shared<expression::Constant>(c, i->location()));
+}
+
+void OptimizePeepHole::foldComparision(statement::instruction::Resolved* i, int_cmp cmp)
+{
+    // Both operands get coerced to the wider of the two types.
+    int width = std::max(_intWidth(i->op1()), _intWidth(i->op2()));
+
+    if ( ! width )
+        return;
+
+    uint64_t a, b;
+
+    if ( ! (_intConstant(i->op1(), width, &a) && _intConstant(i->op2(), width, &b)) )
+        return;
+
+    auto result = cmp(_signExtend(a, width), _signExtend(b, width), a, b);
+    replaceWith(i, "assign", builder::boolean::create(result, i->location()));
+}
+
+void OptimizePeepHole::foldBool(statement::instruction::Resolved* i, bool_op op)
+{
+    bool a, b = false;
+
+    if ( ! _boolConstant(i->op1(), &a) )
+        return;
+
+    if ( i->op2() && ! _boolConstant(i->op2(), &b) )
+        return;
+
+    replaceWith(i, "assign", builder::boolean::create(op(a, b), i->location()));
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::Add* i)
+{
+    foldInteger(i, [](uint64_t a, uint64_t b, int w) { return a + b; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::Sub* i)
+{
+    foldInteger(i, [](uint64_t a, uint64_t b, int w) { return a - b; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::Mul* i)
+{
+    foldInteger(i, [](uint64_t a, uint64_t b, int w) { return a * b; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::And* i)
+{
+    foldInteger(i, [](uint64_t a, uint64_t b, int w) { return a & b; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::Or* i)
+{
+    foldInteger(i, [](uint64_t a, uint64_t b, int w) { return a | b; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::Xor* i)
+{
+    foldInteger(i, [](uint64_t a, uint64_t b, int w) { return a ^ b; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::Shl* i)
+{
+    uint64_t n;
+
+    // Shifting by the width or more is undefined, so leave that as is.
+    if ( ! _intConstant(i->op2(), 64, &n) || n >= (uint64_t)_intWidth(i->target()) )
+        return;
+
+    foldInteger(i, [](uint64_t a, uint64_t b, int w) { return a << b; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::Shr* i)
+{
+    uint64_t n;
+
+    if ( ! _intConstant(i->op2(), 64, &n) || n >= (uint64_t)_intWidth(i->target()) )
+        return;
+
+    foldInteger(i, [](uint64_t a, uint64_t b, int w) { return a >> b; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::Eq* i)
+{
+    foldComparision(i, [](int64_t a, int64_t b, uint64_t ua, uint64_t ub) { return ua == ub; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::Equal* i)
+{
+    foldComparision(i, [](int64_t a, int64_t b, uint64_t ua, uint64_t ub) { return ua == ub; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::Slt* i)
+{
+    foldComparision(i, [](int64_t a, int64_t b, uint64_t ua, uint64_t ub) { return a < b; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::Sleq* i)
+{
+    foldComparision(i, [](int64_t a, int64_t b, uint64_t ua, uint64_t ub) { return a <= b; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::Sgt* i)
+{
+    foldComparision(i, [](int64_t a, int64_t b, uint64_t ua, uint64_t ub) { return a > b; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::Sgeq* i)
+{
+    foldComparision(i, [](int64_t a, int64_t b, uint64_t ua, uint64_t ub) { return a >= b; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::Ult* i)
+{
+    foldComparision(i, [](int64_t a, int64_t b, uint64_t ua, uint64_t ub) { return ua < ub; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::Uleq* i)
+{
+    foldComparision(i, [](int64_t a, int64_t b, uint64_t ua, uint64_t ub) { return ua <= ub; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::Ugt* i)
+{
+    foldComparision(i, [](int64_t a, int64_t b, uint64_t ua, uint64_t ub) { return ua > ub; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::integer::Ugeq* i)
+{
+    foldComparision(i, [](int64_t a, int64_t b, uint64_t ua, uint64_t ub) { return ua >= ub; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::boolean::And* i)
+{
+    foldBool(i, [](bool a, bool b) { return a && b; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::boolean::Or* i)
+{
+    foldBool(i, [](bool a, bool b) { return a || b; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::boolean::Not* i)
+{
+    foldBool(i, [](bool a, bool b) { return ! a; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::boolean::Equal* i)
+{
+    foldBool(i, [](bool a, bool b) { return a == b; });
+}
+
+void OptimizePeepHole::visit(statement::instruction::flow::IfElse* i)
+{
+    bool cond;
+
+    if ( ! _boolConstant(i->op1(), &cond) )
+        return;
+
+    replaceWith(i, "jump", cond ? i->op2() : i->op3());
+}
@@ -1,7 +1,8 @@
-
 #ifndef HILTI_PASSES_OPTIMIZE_PEEPHOLE_H
 #define HILTI_PASSES_OPTIMIZE_PEEPHOLE_H
 
+#include <functional>
+
 #include "../pass.h"
 
 namespace hilti {
@@ -9,6 +10,10 @@ namespace passes {
 
 /// Bundles a set of small peep-hole optimizations that act locally on
 /// individual instructions without needing further global context.
+///
+/// Currently, this folds integer and boolean instructions that have only
+/// constant operands into assignments of the result, and turns conditional
+/// branches on constants into unconditional jumps.
 class OptimizePeepHole : public Pass<>
 {
 public:
@@ -17,7 +22,39 @@ public:
    bool run(shared_ptr<hilti::Node> module);
 
 protected:
-
+   virtual void visit(statement::instruction::integer::Add* i);
+   virtual void visit(statement::instruction::integer::Sub* i);
+   virtual void visit(statement::instruction::integer::Mul* i);
+   virtual void visit(statement::instruction::integer::And* i);
+   virtual void visit(statement::instruction::integer::Or* i);
+   virtual void visit(statement::instruction::integer::Xor* i);
+   virtual void visit(statement::instruction::integer::Shl* i);
+   virtual void visit(statement::instruction::integer::Shr* i);
+   virtual void visit(statement::instruction::integer::Eq* i);
+   virtual void visit(statement::instruction::integer::Equal* i);
+   virtual void visit(statement::instruction::integer::Slt* i);
+   virtual void visit(statement::instruction::integer::Sleq* i);
+   virtual void visit(statement::instruction::integer::Sgt* i);
+   virtual void visit(statement::instruction::integer::Sgeq* i);
+   virtual void visit(statement::instruction::integer::Ult* i);
+   virtual void visit(statement::instruction::integer::Uleq* i);
+   virtual void visit(statement::instruction::integer::Ugt* i);
+   virtual void visit(statement::instruction::integer::Ugeq* i);
+   virtual void visit(statement::instruction::boolean::And* i);
+   virtual void visit(statement::instruction::boolean::Or* i);
+   virtual void visit(statement::instruction::boolean::Not* i);
+   virtual void visit(statement::instruction::boolean::Equal* i);
+   virtual void visit(statement::instruction::flow::IfElse* i);
+
+private:
+   typedef std::function<uint64_t (uint64_t a, uint64_t b, int width)> int_op;
+   typedef std::function<bool (int64_t a, int64_t b, uint64_t ua, uint64_t ub)> int_cmp;
+   typedef std::function<bool (bool a, bool b)> bool_op;
+
+   void foldInteger(statement::instruction::Resolved* i, int_op op);
+   void foldComparision(statement::instruction::Resolved* i, int_cmp cmp);
+   void foldBool(statement::instruction::Resolved* i, bool_op op);
+   void replaceWith(statement::instruction::Resolved* i, const string& name, shared_ptr<Expression> op1);
 };
 
 }
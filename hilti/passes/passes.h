@@ -15,6 +15,9 @@
 #include "cfg.h"
 #include "liveness.h"
 #include "optimize-ctors.h"
+#include "optimize-deadcode.h"
+#include "optimize-exceptions.h"
 #include "optimize-peephole.h"
+#include "refcount-elision.h"
 
 #endif
@@ -0,0 +1,143 @@
+
+#include "hilti/hilti-intern.h"
+#include "hilti/autogen/instructions.h"
+
+#include "refcount-elision.h"
+
+using namespace hilti;
+using namespace hilti::passes;
+
+RefCountElision::RefCountElision(CompilerContext* context, shared_ptr<Liveness> liveness)
+    : Pass<>("hilti::RefCountElision")
+{
+    _context = context;
+    _liveness = liveness;
+}
+
+RefCountElision::~RefCountElision()
+{
+}
+
+bool RefCountElision::run(shared_ptr<Node> module)
+{
+    _carry_out.clear();
+    _release.clear();
+    _num_elided = 0;
+
+    if ( ! processAllPreOrder(module) )
+        return false;
+
+    if ( _context->options().cgDebugging("liveness") )
+        std::cerr << util::fmt("RefCountElision: %d ref/unref pairs elided", _num_elided) << std::endl;
+
+    return (errors() == 0);
+}
+
+RefCountElision::variable_set RefCountElision::carryOut(shared_ptr<Statement> stmt) const
+{
+    auto i = _carry_out.find(stmt);
+    return i != _carry_out.end() ? i->second : variable_set();
+}
+
+RefCountElision::variable_set RefCountElision::release(shared_ptr<Statement> stmt) const
+{
+    auto i = _release.find(stmt);
+    return i != _release.end() ? i->second : variable_set();
+}
+
+bool RefCountElision::isSafepointCall(shared_ptr<Statement> stmt) const
+{
+    // We limit this to direct calls, for which the code generator adapts
+    // the stack on a straight-line path.
+    if ( ! (ast::isA<statement::instruction::flow::CallResult>(stmt) ||
+            ast::isA<statement::instruction::flow::CallVoid>(stmt)) )
+        return false;
+
+    auto instr = ast::checkedCast<statement::Instruction>(stmt);
+    auto ftype = ast::tryCast<type::Function>(instr->op1()->type());
+
+    return ftype && ftype->mayTriggerSafepoint();
+}
+
+RefCountElision::variable_set RefCountElision::protectedLocals(shared_ptr<Statement> stmt) const
+{
+    // This must match what CodeGen::liveValues() considers.
+    auto ln = _liveness->liveness(stmt);
+
+    variable_set result;
+
+    for ( auto v : *ln.in ) {
+        if ( ln.dead->find(v) != ln.dead->end() )
+            continue;
+
+        if ( v->expression->hoisted() )
+            continue;
+
+        result.insert(v);
+    }
+
+    return result;
+}
+
+RefCountElision::variable_set RefCountElision::written(shared_ptr<Statement> stmt) const
+{
+    auto fi = stmt->flowInfo();
+    return util::set_union(util::set_union(fi.defined, fi.cleared), fi.modified);
+}
+
+void RefCountElision::visit(statement::Block* b)
+{
+    std::vector<shared_ptr<Statement>> stmts;
+
+    for ( auto s : b->statements() )
+        stmts.push_back(s);
+
+    for ( size_t i = 0; i < stmts.size(); i++ ) {
+        auto first = stmts[i];
+
+        if ( ! isSafepointCall(first) )
+            continue;
+
+        // Find the next safepoint call in straight-line code, tracking
+        // what gets written on the way. The first call's own writes happen
+        // after it has adapted the stack, so they count too; likewise for
+        // the second one as we release only after it has executed.
+        auto clobbered = written(first);
+        shared_ptr<Statement> second = nullptr;
+
+        for ( size_t j = i + 1; j < stmts.size(); j++ ) {
+            auto s = stmts[j];
+            auto instr = ast::tryCast<statement::instruction::Resolved>(s);
+
+            if ( ! instr || instr->instruction()->terminator() )
+                break;
+
+            if ( ast::isA<statement::instruction::exception::__BeginHandler>(s) ||
+                 ast::isA<statement::instruction::exception::__EndHandler>(s) )
+                break;
+
+            clobbered = util::set_union(clobbered, written(s));
+
+            if ( isSafepointCall(s) ) {
+                second = s;
+                break;
+            }
+        }
+
+        if ( ! second )
+            continue;
+
+        auto carried = util::set_intersection(protectedLocals(first), protectedLocals(second));
+        carried = util::set_difference(carried, clobbered);
+
+        if ( carried.empty() )
+            continue;
+
+        for ( auto v : carried ) {
+            _carry_out[first].insert(v);
+            _release[second].insert(v);
+        }
+
+        _num_elided += carried.size();
+    }
+}
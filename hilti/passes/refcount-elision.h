@@ -0,0 +1,79 @@
+
+#ifndef HILTI_PASSES_REFCOUNT_ELISION_H
+#define HILTI_PASSES_REFCOUNT_ELISION_H
+
+#include <unordered_map>
+
+#include "../pass.h"
+
+namespace hilti {
+
+class CompilerContext;
+
+namespace passes {
+
+class Liveness;
+
+/// Determines where the code generator can skip reference count adjustments
+/// for locals around calls that may trigger a safepoint.
+///
+/// Before such a call, the code generator increments the reference count of
+/// all live locals (so that the safepoint won't delete what they point to),
+/// and decrements them again afterwards. If the same local is live across
+/// two such calls in a straight-line sequence of instructions, and nothing
+/// writes to it in between, the decrement after the first call and the
+/// increment before the second cancel out. This pass computes these ranges
+/// so that the code generator can keep the count elevated across them
+/// instead. It relies on the liveness information having been computed
+/// already.
+class RefCountElision : public Pass<>
+{
+public:
+    typedef Statement::variable_set variable_set;
+
+    /// Constructor.
+    RefCountElision(CompilerContext* context, shared_ptr<Liveness> liveness);
+    virtual ~RefCountElision();
+
+    /// Computes the elision information for a module.
+    ///
+    /// Returns: True if no error occured.
+    bool run(shared_ptr<Node> module) override;
+
+    /// Returns the locals that remain counted after a statement's calls
+    /// return, to be released later by a statement returned by
+    /// release(). Must only be called after run() has executed.
+    variable_set carryOut(shared_ptr<Statement> stmt) const;
+
+    /// Returns the locals that were counted by an earlier statement (see
+    /// carryOut()) and need to be released once this statement has
+    /// executed (unless they are also in its own carryOut() set). Must only
+    /// be called after run() has executed.
+    variable_set release(shared_ptr<Statement> stmt) const;
+
+    /// Returns the number of reference count operation pairs that the pass
+    /// found to be redundant, statically. For debugging and statistics.
+    int numElided() const { return _num_elided; }
+
+protected:
+    void visit(statement::Block* b) override;
+
+private:
+    bool isSafepointCall(shared_ptr<Statement> stmt) const;
+    variable_set protectedLocals(shared_ptr<Statement> stmt) const;
+    variable_set written(shared_ptr<Statement> stmt) const;
+
+    typedef std::unordered_map<shared_ptr<Statement>, variable_set> statement_map;
+
+    CompilerContext* _context;
+    shared_ptr<Liveness> _liveness;
+    statement_map _carry_out;
+    statement_map _release;
+    int _num_elided = 0;
+};
+
+}
+
+}
+
+#endif
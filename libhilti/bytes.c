@@ -25,6 +25,23 @@ static const int _BYTES_FLAG_FROZEN = 1;
 // object aren't valid in this case, and set to null.
 static const int _BYTES_FLAG_OBJECT = 2;
 
+// Other bytes objects reference this node's data through their owner field.
+// The data must then stay in place until the node itself goes away.
+static const int _BYTES_FLAG_SHARED = 4;
+
+// Node lives on the stack (see hlt_bytes_new_hoisted()). Its data must not
+// be shared.
+static const int _BYTES_FLAG_HOISTED = 8;
+
+// Node's data is owned by somebody else (see __hlt_bytes_new_external()) and
+// must not be shared.
+static const int _BYTES_FLAG_EXTERNAL = 16;
+
+// Iterators have been handed out into the node's external data. As they
+// keep raw pointers, the data must then stay in place until the node goes
+// away.
+static const int _BYTES_FLAG_PINNED = 32;
+
 // Layout here must match libhilti.ll!
 struct __hlt_bytes {
     __hlt_gchdr __gchdr;       // Header for memory management.
@@ -37,6 +54,8 @@ struct __hlt_bytes {
     int8_t* reserved;          // Pointer to one after the last data byte available.
     int8_t* to_free;           // Need to free data pointed to when dtoring.
     hlt_bytes_size* marks;     // If non-null, array of offsets of marks within this chunk. Terminated by -1. Must be freed.
+    struct __hlt_bytes* owner; // If non-null, the node whose data start/end point into. Ref counted.
+    struct __hlt_bytes** slot; // For external data, the owner's pointer to the node; cleared when the node lets go of the data.
     int8_t data[0];            // Inline data starts here if free is zero.
 };
 
@@ -60,6 +79,7 @@ static hlt_iterator_bytes GenericEndPos = { 0, 0 };
 
 static hlt_bytes* _hlt_bytes_new(const int8_t* data, hlt_bytes_size len, hlt_bytes_size reserve, hlt_execution_context* ctx);
 static void __add_chunk(hlt_bytes* tail, hlt_bytes* c, hlt_execution_context* ctx);
+static int8_t __hlt_bytes_match_raw(hlt_bytes** c, int8_t** cur, const int8_t* data, hlt_bytes_size len);
 
 static inline hlt_bytes_size min(hlt_bytes_size a, hlt_bytes_size b)
 {
@@ -190,6 +210,16 @@ static inline hlt_bytes* __pred(hlt_bytes* b, hlt_bytes* p)
     return b;
 }
 
+// Iterators keep raw pointers into the data, which would be left dangling
+// if the owner of external data had us copy it. We hence pin external data
+// once we hand out iterators into it. External data can only be in the
+// first chunk, see __is_shareable().
+static inline void __prepare_iterators(hlt_bytes* b)
+{
+    if ( b && (b->flags & _BYTES_FLAG_EXTERNAL) )
+        b->flags |= _BYTES_FLAG_PINNED;
+}
+
 // Does not ref the iterator.
 static inline hlt_iterator_bytes __create_iterator(hlt_bytes* bytes, int8_t* cur)
 {
@@ -361,6 +391,7 @@ static inline void _hlt_bytes_init(hlt_bytes* b, const int8_t* data, hlt_bytes_s
     b->reserved = b->start + reserve;
     b->to_free = 0;
     b->marks = 0;
+    b->owner = 0;
 
     hlt_thread_mgr_blockable_init(&b->blockable);
 
@@ -378,6 +409,7 @@ static inline void _hlt_bytes_init_reuse(hlt_bytes* b, int8_t* data, hlt_bytes_s
     b->reserved = data + len;
     b->to_free = data;
     b->marks = 0;
+    b->owner = 0;
 
     hlt_thread_mgr_blockable_init(&b->blockable);
 }
@@ -388,6 +420,7 @@ static void _hlt_bytes_init_object(__hlt_bytes_object* b, const hlt_type_info* t
     b->b.flags = _BYTES_FLAG_OBJECT;
     b->b.offset = 0;
     b->b.marks = 0;
+    b->b.owner = 0;
     b->type = type;
 
     hlt_thread_mgr_blockable_init(&b->b.blockable);
@@ -425,11 +458,12 @@ static inline void _hlt_bytes_init_hoisted(__hlt_bytes_hoisted* dst, const int8_
         b->to_free = b->start;
     }
 
-    b->flags = 0;
+    b->flags = _BYTES_FLAG_HOISTED;
     b->offset = 0;
     b->next = 0;
     b->end = b->start + len;
     b->marks = 0;
+    b->owner = 0;
 
     hlt_thread_mgr_blockable_init(&b->blockable);
 
@@ -471,6 +505,36 @@ static hlt_bytes* _hlt_bytes_new_reuse_ref(int8_t* data, hlt_bytes_size len, hlt
     return b;
 }
 
+// Returns true if other bytes objects may reference the node's data
+// directly rather than copying it.
+static inline int8_t __is_shareable(const hlt_bytes* b)
+{
+    return ! (b->flags & (_BYTES_FLAG_OBJECT | _BYTES_FLAG_HOISTED | _BYTES_FLAG_EXTERNAL));
+}
+
+// Creates a bytes object referencing the data range [start, end) of a
+// shareable chunk instead of copying it. The caller needs to copy over any
+// marks. Neither side ever modifies data
+// in place that the other one can see: appends go beyond the chunk's
+// current end or into new chunks, and trimming only moves the start
+// pointer (see hlt_bytes_trim() for the one exception).
+static hlt_bytes* _hlt_bytes_new_shared(hlt_bytes* chunk, int8_t* start, int8_t* end, hlt_execution_context* ctx)
+{
+    assert(__is_shareable(chunk));
+
+    hlt_bytes* owner = chunk->owner ? chunk->owner : chunk;
+
+    hlt_bytes* b = GC_NEW_NO_INIT(hlt_bytes, ctx);
+    _hlt_bytes_init_reuse(b, start, end - start, ctx);
+    b->to_free = 0;
+    b->owner = owner;
+    GC_CCTOR(b->owner, hlt_bytes, ctx);
+
+    owner->flags |= _BYTES_FLAG_SHARED;
+
+    return b;
+}
+
 static hlt_bytes* _hlt_bytes_new_object(const hlt_type_info* type, void* obj, hlt_execution_context* ctx)
 {
     __hlt_bytes_object* b = GC_NEW_CUSTOM_SIZE_NO_INIT(hlt_bytes, sizeof(__hlt_bytes_object) + type->size, ctx);
@@ -487,8 +551,13 @@ static hlt_bytes* _hlt_bytes_new_object_ref(const hlt_type_info* type, void* obj
 
 void hlt_bytes_dtor(hlt_type_info* ti, hlt_bytes* b, hlt_execution_context* ctx)
 {
+    if ( b->flags & _BYTES_FLAG_EXTERNAL )
+        // Tell the owner that nobody can look at the data anymore.
+        *b->slot = 0;
+
     b->start = b->end = 0;
     GC_CLEAR(b->next, hlt_bytes, ctx);
+    GC_CLEAR(b->owner, hlt_bytes, ctx);
 
     __hlt_bytes_object* obj = __get_object(b);
 
@@ -559,7 +628,7 @@ void hlt_bytes_clone_init(void* dstp, const hlt_type_info* ti, void* srcp, __hlt
 
     assert(src && dst);
 
-    dst->flags = src->flags;
+    dst->flags = src->flags & (_BYTES_FLAG_FROZEN | _BYTES_FLAG_OBJECT);
     dst->offset = src->offset;
     dst->marks = 0;
 
@@ -796,6 +865,8 @@ hlt_iterator_bytes hlt_bytes_find_byte(hlt_bytes* b, int8_t chr, hlt_exception**
         return GenericEndPos;
     }
 
+    __prepare_iterators(b);
+
     hlt_iterator_bytes p;
     __hlt_bytes_find_byte(&p, b, chr, excpt, ctx);
     return p;
@@ -945,7 +1016,7 @@ void __hlt_bytes_find_byte_from(hlt_iterator_bytes* p, hlt_iterator_bytes i, int
     if ( ! c ) {
         // Subsequent chunks.
         for ( b = i.bytes->next; b && ! __get_object(b); b = b->next ) {
-            int8_t* c = memchr(b->start, chr, b->end - b->start);
+            c = memchr(b->start, chr, b->end - b->start);
 
             if ( c )
                 break;
@@ -958,48 +1029,113 @@ void __hlt_bytes_find_byte_from(hlt_iterator_bytes* p, hlt_iterator_bytes i, int
         __hlt_bytes_end(p, i.bytes, excpt, ctx);
 }
 
-int8_t __hlt_bytes_find_bytes(hlt_iterator_bytes* p, hlt_bytes* b, hlt_bytes* other, hlt_exception** excpt, hlt_execution_context* ctx)
+// Returns the data of a non-empty bytes object as one contiguous block. If
+// it's spread across several chunks, the data gets copied into *buffer if
+// that's large enough, or into newly allocated memory otherwise; *to_free
+// is then set to what the caller needs to release.
+static const int8_t* __flatten(hlt_bytes* b, int8_t* buffer, hlt_bytes_size buffer_size, hlt_bytes_size* len, int8_t** to_free)
 {
-    if ( __is_empty(other, false) ) {
-        // Empty pattern returns start position.
-        __hlt_bytes_begin(p, b, excpt, ctx);
-        return 1;
+    *to_free = 0;
+
+    if ( ! b->next || __get_object(b->next) ) {
+        *len = b->end - b->start;
+        return b->start;
     }
 
-    hlt_iterator_bytes begin;
-    hlt_iterator_bytes end;
-    __hlt_bytes_begin(&begin, other, excpt, ctx);
-    __hlt_bytes_end(&end, other, excpt, ctx);
+    *len = __hlt_bytes_len(b);
 
+    int8_t* dst = buffer;
 
-    int8_t chr = *begin.cur;
+    if ( *len > buffer_size )
+        dst = *to_free = hlt_malloc_no_init(*len);
 
-    hlt_iterator_bytes i;
-    __hlt_bytes_begin(&i, b, excpt, ctx);
+    int8_t* p = dst;
 
-    while ( 1 ) {
-        __hlt_bytes_find_byte_from(p, i, chr, excpt, ctx);
+    for ( ; b && ! __get_object(b); b = b->next ) {
+        memcpy(p, b->start, b->end - b->start);
+        p += (b->end - b->start);
+    }
 
-        if ( __is_end(*p) ) {
-            // Not found.
-            break;
+    return dst;
+}
+
+// Searches a needle, starting at the given position and working through
+// the input chunk by chunk. Matches entirely inside a chunk are left to
+// memmem(); for the ones straddling into subsequent chunks, we check each
+// candidate start among the chunk's last len - 1 bytes.
+//
+// Returns 1 if found, with *p set to the match's start. If partial is true
+// and the input runs out while a candidate still matches, returns -1 with
+// *p set to that candidate. Otherwise returns 0 and leaves *p alone.
+static int8_t __find_raw(hlt_iterator_bytes* p, hlt_bytes* c, int8_t* cur, const int8_t* needle, hlt_bytes_size len, int8_t partial)
+{
+    for ( ; c && ! __get_object(c); c = c->next, cur = (c ? c->start : 0) ) {
+        hlt_bytes_size avail = c->end - cur;
+        int8_t* s = cur;
+
+        if ( avail >= len ) {
+            int8_t* m = memmem(cur, avail, needle, len);
+
+            if ( m ) {
+                *p = __create_iterator(c, m);
+                return 1;
+            }
+
+            s = c->end - len + 1;
         }
 
-        if ( hlt_bytes_match_at(*p, other, excpt, ctx) )
-            // Found.
-            return 1;
+        while ( s < c->end ) {
+            s = memchr(s, needle[0], c->end - s);
 
-        __hlt_iterator_bytes_incr(&i, excpt, ctx, 0);
+            if ( ! s )
+                break;
 
-        if ( __is_end(i) )
-            // Not found.
-            break;
+            hlt_bytes* mc = c;
+            int8_t* mcur = s;
+            int8_t rc = __hlt_bytes_match_raw(&mc, &mcur, needle, len);
+
+            if ( rc == 1 || (rc == -1 && partial) ) {
+                *p = __create_iterator(c, s);
+                return rc;
+            }
+
+            if ( rc == -1 )
+                // Any later candidate runs out of input as well.
+                return 0;
+
+            ++s;
+        }
     }
 
-    __hlt_bytes_end(p, b, excpt, ctx);
     return 0;
 }
 
+int8_t __hlt_bytes_find_bytes(hlt_iterator_bytes* p, hlt_bytes* b, hlt_bytes* other, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    if ( __is_empty(other, false) ) {
+        // Empty pattern returns start position.
+        __hlt_bytes_begin(p, b, excpt, ctx);
+        return 1;
+    }
+
+    hlt_iterator_bytes i;
+    __hlt_bytes_begin(&i, b, excpt, ctx);
+
+    int8_t buffer[64];
+    int8_t* to_free;
+    hlt_bytes_size len;
+    const int8_t* needle = __flatten(other, buffer, sizeof(buffer), &len, &to_free);
+
+    int8_t found = __find_raw(p, i.bytes, i.cur, needle, len, 0);
+
+    hlt_free(to_free);
+
+    if ( ! found )
+        __hlt_bytes_end(p, b, excpt, ctx);
+
+    return found;
+}
+
 int8_t hlt_bytes_contains_bytes(hlt_bytes* b, hlt_bytes* other, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     if ( ! (b && other) ) {
@@ -1018,6 +1154,8 @@ hlt_iterator_bytes hlt_bytes_find_bytes(hlt_bytes* b, hlt_bytes* other, hlt_exce
         return GenericEndPos;
     }
 
+    __prepare_iterators(b);
+
     hlt_iterator_bytes p;
     __hlt_bytes_find_bytes(&p, b, other, excpt, ctx);
     return p;
@@ -1080,45 +1218,30 @@ hlt_bytes_find_at_iter_result hlt_bytes_find_bytes_at_iter(hlt_iterator_bytes i,
         return r;
     }
 
-    hlt_iterator_bytes nbegin;
-    __hlt_bytes_begin(&nbegin, needle, excpt, ctx);
-    int8_t chr = *nbegin.cur;
-
     __normalize_iter(&r.iter);
 
-    while ( 1 ) {
-        __hlt_bytes_find_byte_from(&r.iter, r.iter, chr, excpt, ctx);
-
-        if ( __is_end(r.iter) ) {
-            // Not found. Leave r.iter at end.
-            r.success = 0;
-            break;
-        }
-
-        int rc = __hlt_bytes_match_at(r.iter, needle, excpt, ctx);
+    if ( __is_end(r.iter) ) {
+        // Not found. Leave r.iter at end.
+        r.success = 0;
+        return r;
+    }
 
-        if ( rc > 0 ) {
-            // Found. Leave r.iter at start position.
-            r.success = 1;
-            break;
-        }
+    int8_t buffer[64];
+    int8_t* to_free;
+    hlt_bytes_size len;
+    const int8_t* data = __flatten(needle, buffer, sizeof(buffer), &len, &to_free);
 
-        if ( rc == -1 ) {
-            // Out of input, may still match. Leave r.iter at start position.
-            r.success = 0;
-            break;
-        }
+    int8_t rc = __find_raw(&r.iter, r.iter.bytes, r.iter.cur, data, len, 1);
 
-        // Not found, advance.
+    hlt_free(to_free);
 
-        __hlt_iterator_bytes_incr(&r.iter, excpt, ctx, 0);
+    // If found, leave r.iter at start position. If out of input while it
+    // may still match, leave it at the candidate's start as well.
+    r.success = (rc == 1);
 
-        if ( __is_end(r.iter) ) {
-            // Not found. Leave r.iter at end.
-            r.success = 0;
-            break;
-        }
-    }
+    if ( ! rc )
+        // Not found. Leave r.iter at end.
+        __hlt_bytes_end(&r.iter, r.iter.bytes, excpt, ctx);
 
     return r;
 }
@@ -1155,6 +1278,13 @@ hlt_bytes* hlt_bytes_copy(hlt_bytes* b, hlt_exception** excpt, hlt_execution_con
         return 0;
     }
 
+    if ( ! b->next && __is_shareable(b) && b->end > b->start ) {
+        // Single chunk, reference it.
+        hlt_bytes* dst = _hlt_bytes_new_shared(b, b->start, b->end, ctx);
+        __hlt_bytes_copy_marks(&dst->marks, b, 0, 0, 0);
+        return dst;
+    }
+
     hlt_bytes_size len = hlt_bytes_len(b, excpt, ctx);
     hlt_bytes* dst = _hlt_bytes_new(0, len, 0, ctx);
 
@@ -1269,6 +1399,23 @@ hlt_bytes* hlt_bytes_sub(hlt_iterator_bytes p1, hlt_iterator_bytes p2, hlt_excep
     __normalize_iter(&p2);
 
     hlt_bytes_size len = __hlt_iterator_bytes_diff(p1, p2, excpt, ctx);
+
+    // If the range lies within a single chunk, reference its data.
+    hlt_bytes* c = p1.bytes;
+    int8_t* last = 0;
+
+    if ( c && c == p2.bytes )
+        last = p2.cur;
+
+    else if ( c && ! p2.bytes && ! c->next )
+        last = c->end;
+
+    if ( len && last && __is_shareable(c) && p1.cur + len == last ) {
+        hlt_bytes* dst = _hlt_bytes_new_shared(c, p1.cur, last, ctx);
+        __hlt_bytes_copy_marks(&dst->marks, c, p1.cur, p2.bytes ? p2.cur : 0, (c->start - p1.cur));
+        return dst;
+    }
+
     hlt_bytes* dst = _hlt_bytes_new(0, len, 0, ctx);
 
     if ( ! len )
@@ -1306,6 +1453,75 @@ int8_t hlt_bytes_match_at(hlt_iterator_bytes p, hlt_bytes* b, hlt_exception** ex
     return __hlt_bytes_match_at(p, b, excpt, ctx) > 0;
 }
 
+// Compares data against the input at (*c, *cur), chunk by chunk, and
+// advances the position accordingly. Returns 1 on match, 0 on mismatch, and
+// -1 if running out of input first.
+static int8_t __hlt_bytes_match_raw(hlt_bytes** c, int8_t** cur, const int8_t* data, hlt_bytes_size len)
+{
+    while ( len > 0 ) {
+        if ( ! *c )
+            return -1;
+
+        if ( __get_object(*c) )
+            // Data never matches a separator object.
+            return 0;
+
+        if ( *cur < (*c)->end ) {
+            hlt_bytes_size n = min((*c)->end - *cur, len);
+
+            if ( memcmp(*cur, data, n) != 0 )
+                return 0;
+
+            *cur += n;
+            data += n;
+            len -= n;
+
+            if ( *cur < (*c)->end )
+                break;
+        }
+
+        *c = (*c)->next;
+        *cur = *c ? (*c)->start : 0;
+    }
+
+    return 1;
+}
+
+int8_t hlt_bytes_match_raw_at(hlt_iterator_bytes p, const int8_t* data, hlt_bytes_size len, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    __normalize_iter(&p);
+
+    hlt_bytes* c = p.bytes;
+    int8_t* cur = p.cur;
+
+    return __hlt_bytes_match_raw(&c, &cur, data, len);
+}
+
+int8_t hlt_bytes_match_bytes_at(hlt_iterator_bytes p, hlt_bytes* b, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    if ( ! b ) {
+        hlt_set_exception(excpt, &hlt_exception_null_reference, 0, ctx);
+        return 0;
+    }
+
+    __normalize_iter(&p);
+
+    hlt_bytes* c = p.bytes;
+    int8_t* cur = p.cur;
+
+    for ( ; b; b = b->next ) {
+        if ( __get_object(b) )
+            return 0;
+
+        int8_t rc = __hlt_bytes_match_raw(&c, &cur, b->start, b->end - b->start);
+
+        if ( rc != 1 )
+            return rc;
+    }
+
+    return 1;
+}
+
 int8_t* hlt_bytes_to_raw(int8_t* dst, size_t dst_len, hlt_bytes* b, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     if ( ! b ) {
@@ -1353,6 +1569,79 @@ int8_t __hlt_bytes_extract_one(hlt_iterator_bytes* p, hlt_iterator_bytes end, hl
     return __hlt_bytes_extract_one_slowpath(p, end, excpt, ctx);
 }
 
+int8_t* __hlt_bytes_chunk_end(hlt_bytes* chunk)
+{
+    if ( ! chunk || __get_object(chunk) )
+        return 0;
+
+    return chunk->end;
+}
+
+int8_t __hlt_bytes_can_move(const hlt_bytes* b)
+{
+    const hlt_bytes* head = b;
+
+    for ( ; b; b = b->next ) {
+        if ( b->flags & (_BYTES_FLAG_OBJECT | _BYTES_FLAG_HOISTED | _BYTES_FLAG_EXTERNAL | _BYTES_FLAG_SHARED) )
+            return 0;
+
+        if ( b->owner )
+            // The data belongs to a node that stays with the current thread.
+            return 0;
+
+        if ( b != head && __atomic_load_n(&b->__gchdr.ref_cnt, __ATOMIC_SEQ_CST) != 1 )
+            // Somebody other than the predecessor holds on to the chunk,
+            // such as an iterator.
+            return 0;
+    }
+
+    return 1;
+}
+
+void __hlt_bytes_move(hlt_bytes* b, hlt_execution_context* ctx)
+{
+    // The caller takes care of the first chunk.
+    for ( b = b->next; b; b = b->next )
+        __hlt_memory_nullbuffer_remove(ctx->nullbuffer, b);
+}
+
+hlt_bytes* __hlt_bytes_new_external(const int8_t* data, hlt_bytes_size len, hlt_bytes** slot, hlt_execution_context* ctx)
+{
+    hlt_bytes* b = _hlt_bytes_new_reuse((int8_t*)data, len, ctx);
+    b->to_free = 0;
+    b->flags |= _BYTES_FLAG_EXTERNAL;
+    b->slot = slot;
+    *slot = b;
+    return b;
+}
+
+int8_t __hlt_bytes_detach(hlt_bytes* b, hlt_execution_context* ctx)
+{
+    if ( b->flags & _BYTES_FLAG_PINNED )
+        return 0;
+
+    hlt_bytes_size len = b->end - b->start;
+    int8_t* data = hlt_malloc(len);
+    memcpy(data, b->start, len);
+
+    b->start = data;
+    b->end = data + len;
+    b->reserved = data + len;
+    b->to_free = data;
+    b->flags &= ~_BYTES_FLAG_EXTERNAL;
+
+    *b->slot = 0;
+    b->slot = 0;
+    return 1;
+}
+
+void __hlt_bytes_abandon(hlt_bytes* b, hlt_execution_context* ctx)
+{
+    b->flags &= ~_BYTES_FLAG_EXTERNAL;
+    *b->slot = 0;
+    b->slot = 0;
+}
+
 hlt_iterator_bytes hlt_bytes_offset(hlt_bytes* b, hlt_bytes_size p, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     if ( ! b ) {
@@ -1360,6 +1649,8 @@ hlt_iterator_bytes hlt_bytes_offset(hlt_bytes* b, hlt_bytes_size p, hlt_exceptio
         return GenericEndPos;
     }
 
+    __prepare_iterators(b);
+
     if ( ! p )
         return hlt_bytes_begin(b, excpt, ctx);
 
@@ -1401,6 +1692,8 @@ hlt_iterator_bytes hlt_bytes_begin(hlt_bytes* b, hlt_exception** excpt, hlt_exec
         return GenericEndPos;
     }
 
+    __prepare_iterators(b);
+
     hlt_iterator_bytes p;
     __hlt_bytes_begin(&p, b, excpt, ctx);
     return p;
@@ -1413,6 +1706,8 @@ hlt_iterator_bytes hlt_bytes_end(hlt_bytes* b, hlt_exception** excpt, hlt_execut
         return GenericEndPos;
     }
 
+    __prepare_iterators(b);
+
     hlt_iterator_bytes p;
     __hlt_bytes_end(&p, b, excpt, ctx);
     return p;
@@ -1479,7 +1774,8 @@ void hlt_bytes_trim(hlt_bytes* b, hlt_iterator_bytes p, hlt_exception** excpt, h
         GC_DTOR_GENERIC(&o->object, o->type, ctx);
     }
 
-    else if ( b->to_free ) {
+    else if ( b->to_free && ! (b->flags & _BYTES_FLAG_SHARED) ) {
+        // If shared, the data stays around until the node goes away.
         hlt_free(b->to_free);
         b->to_free = 0;
 
@@ -1650,24 +1946,28 @@ hlt_hash hlt_bytes_hash(const hlt_type_info* type, const void* obj, hlt_exceptio
 {
     hlt_bytes* b = *((hlt_bytes**)obj);
 
-    hlt_hash hash = 0;
+    // Hash incrementally so that the result doesn't depend on how the
+    // data is split into chunks.
+    hlt_hash_state state;
+    hlt_hash_bytes_begin(&state);
 
     for ( ; b; b = b->next ) {
 
         __hlt_bytes_object* o = __get_object(b);
 
         if ( o ) {
-            hash += (o->type->hash)(o->type, &o->object, 0, 0);
+            hlt_hash ohash = (o->type->hash)(o->type, &o->object, 0, 0);
+            hlt_hash_bytes_update(&state, (const int8_t*)&ohash, sizeof(ohash));
             continue;
         }
 
         hlt_bytes_size n = (b->end - b->start);
 
         if ( n )
-            hash = hlt_hash_bytes(b->start, n, hash);
+            hlt_hash_bytes_update(&state, b->start, n);
     }
 
-    return hash;
+    return hlt_hash_bytes_end(&state);
 }
 
 int8_t hlt_bytes_equal(const hlt_type_info* type1, const void* obj1, const hlt_type_info* type2, const void* obj2, hlt_exception** excpt, hlt_execution_context* ctx)
@@ -1978,6 +2278,47 @@ int8_t hlt_bytes_starts_with(hlt_bytes* b, hlt_bytes* s, hlt_exception** excpt,
     return 1;
 }
 
+// A set of byte values, for scanning across spans of bytes that are (or
+// aren't) part of it.
+typedef struct {
+    uint8_t member[256];
+} __byte_class;
+
+// The bytes isspace() accepts in the C locale.
+static const __byte_class __whitespace = {
+    .member = { ['\t'] = 1, ['\n'] = 1, ['\v'] = 1, ['\f'] = 1, ['\r'] = 1, [' '] = 1 }
+};
+
+static void __byte_class_init(__byte_class* cls, hlt_bytes* pat)
+{
+    memset(cls->member, 0, sizeof(cls->member));
+
+    for ( hlt_bytes* c = pat; c && ! __get_object(c); c = c->next ) {
+        for ( int8_t* p = c->start; p < c->end; p++ )
+            cls->member[(uint8_t)*p] = 1;
+    }
+}
+
+// Returns the first position in [p, end) with a byte whose membership in
+// the class differs from in, or end if there's none.
+static inline int8_t* __span(const __byte_class* cls, int8_t* p, int8_t* end, uint8_t in)
+{
+    while ( p < end && cls->member[(uint8_t)*p] == in )
+        ++p;
+
+    return p;
+}
+
+// Returns the first position in [start, end) from which on all bytes'
+// membership in the class equals in.
+static inline int8_t* __rspan(const __byte_class* cls, int8_t* start, int8_t* end, uint8_t in)
+{
+    while ( end > start && cls->member[(uint8_t)end[-1]] == in )
+        --end;
+
+    return end;
+}
+
 static int8_t split1(hlt_bytes_pair* result, hlt_bytes* b, hlt_bytes* sep, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     hlt_bytes_size sep_len = hlt_bytes_len(sep, excpt, ctx);
@@ -2003,24 +2344,28 @@ static int8_t split1(hlt_bytes_pair* result, hlt_bytes* b, hlt_bytes* sep, hlt_e
 
         // Special-case: empty separator, split at white-space.
         for ( hlt_bytes* c = b; c && ! __get_object(c); c = c->next ) {
-            for ( int8_t* p = c->start; p < c->end; p++ ) {
-                if ( looking_for_ws ) {
-                    if ( isspace(*p) ) {
-                        i.bytes = c;
-                        i.cur = p;
-                        j = i;
-                        __hlt_iterator_bytes_incr(&j, excpt, ctx, 0);
-                        looking_for_ws = 0;
-                    }
-                }
-
-                else {
-                    if ( ! isspace(*p) ) {
-                        j.bytes = c;
-                        j.cur = p;
-                        goto done;
-                    }
-                }
+            int8_t* p = c->start;
+
+            if ( looking_for_ws ) {
+                p = __span(&__whitespace, p, c->end, 0);
+
+                if ( p == c->end )
+                    continue;
+
+                i.bytes = c;
+                i.cur = p;
+                j = i;
+                __hlt_iterator_bytes_incr(&j, excpt, ctx, 0);
+                looking_for_ws = 0;
+                ++p;
+            }
+
+            p = __span(&__whitespace, p, c->end, 1);
+
+            if ( p < c->end ) {
+                j.bytes = c;
+                j.cur = p;
+                goto done;
             }
         }
 
@@ -2075,32 +2420,27 @@ hlt_vector* hlt_bytes_split(hlt_bytes* b, hlt_bytes* sep, hlt_exception** excpt,
     return v;
 }
 
-static inline int strip_it(int8_t ch, hlt_bytes* pat)
-{
-    if ( ! pat )
-        return isspace(ch);
-
-    for ( hlt_bytes* c = pat; c && ! __get_object(c); c = c->next ) {
-        if ( memchr(c->start, ch, c->end - c->start) )
-            return 1;
-    }
-
-    return 0;
-}
-
 static void _hlt_bytes_strip_calc_iters(hlt_iterator_bytes* start, hlt_iterator_bytes* end, hlt_bytes* b, hlt_enum side, hlt_bytes* pat, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     hlt_bytes* c = 0;
     int8_t* p = 0;
 
+    __byte_class pat_class;
+    const __byte_class* strip = &__whitespace;
+
+    if ( pat ) {
+        __byte_class_init(&pat_class, pat);
+        strip = &pat_class;
+    }
+
     if ( hlt_enum_equal(side, Hilti_Side_Left, excpt, ctx) ||
          hlt_enum_equal(side, Hilti_Side_Both, excpt, ctx) ) {
 
         for ( c = b; c && ! __get_object(c); c = c->next ) {
-            for ( p = c->start; p < c->end; p++ ) {
-                if ( ! strip_it(*p, pat) )
-                    goto end_loop1;
-            }
+            p = __span(strip, c->start, c->end, 1);
+
+            if ( p < c->end )
+                goto end_loop1;
         }
 
 end_loop1:
@@ -2114,12 +2454,10 @@ end_loop1:
          hlt_enum_equal(side, Hilti_Side_Both, excpt, ctx) ) {
 
         for ( c = __tail(b, false); c && ! __get_object(c); c = __pred(b, c) ) {
-            for ( p = c->end - 1; p >= c->start; --p ) {
-                if ( ! strip_it(*p, pat) ) {
-                    ++p;
-                    goto end_loop2;
-                }
-            }
+            p = __rspan(strip, c->start, c->end, 1);
+
+            if ( p > c->start )
+                goto end_loop2;
         }
 
 end_loop2:
@@ -221,6 +221,29 @@ extern hlt_bytes_find_at_iter_result hlt_bytes_find_bytes_at_iter(hlt_iterator_b
 /// Returns: True if bytes a position *pos* start with b.
 extern int8_t hlt_bytes_match_at(hlt_iterator_bytes pos, hlt_bytes* b, hlt_exception** excpt, hlt_execution_context* ctx);
 
+/// Matches raw data against the sequence started by an iterator, without
+/// needing to create a bytes object for it first.
+///
+/// pos: The position where to match *data* against.
+/// data: The data to match.
+/// len: The length of *data*.
+/// \hlt_c
+///
+/// Returns: 1 if the bytes at position *pos* start with *data*; 0 if they
+/// don't; and -1 if the input ends before that can be decided.
+extern int8_t hlt_bytes_match_raw_at(hlt_iterator_bytes pos, const int8_t* data, hlt_bytes_size len, hlt_exception** excpt, hlt_execution_context* ctx);
+
+/// Matches a bytes objects against the sequence started by an interator,
+/// distinguishing a mismatch from running out of input.
+///
+/// pos: The position where to match *b* againt.
+/// b: The bytes to match.
+/// \hlt_c
+///
+/// Returns: 1 if the bytes at position *pos* start with *b*; 0 if they
+/// don't; and -1 if the input ends before that can be decided.
+extern int8_t hlt_bytes_match_bytes_at(hlt_iterator_bytes pos, hlt_bytes* b, hlt_exception** excpt, hlt_execution_context* ctx);
+
 /// Returns a subsequence of a bytes object.
 ///
 /// start: The start of the subsequence.
@@ -299,6 +322,68 @@ extern int8_t* hlt_bytes_to_raw(int8_t* dst, size_t dst_len, hlt_bytes* b, hlt_e
 /// should be optimized away. Check that.
 extern int8_t __hlt_bytes_extract_one(hlt_iterator_bytes* pos, hlt_iterator_bytes end, hlt_exception** excpt, hlt_execution_context* ctx);
 
+/// Returns the end of the data stored in a single chunk of a bytes object.
+/// Generated code uses this to read data directly from memory as long as it
+/// stays within that range.
+///
+/// chunk: The chunk, as referenced by an iterator. Can be null for the end
+/// position.
+///
+/// Returns: A pointer to one after the chunk's last data byte, or null if
+/// the chunk doesn't store raw data.
+extern int8_t* __hlt_bytes_chunk_end(hlt_bytes* chunk);
+
+/// Returns true if a bytes object can be handed over to another thread
+/// without copying, assuming nobody else can reach it anymore. That's the
+/// case if it only consists of raw data that it doesn't share with any other
+/// bytes object, and that it doesn't reference from outside of the runtime;
+/// and if nothing but the object itself references its further chunks.
+///
+/// b: The object.
+extern int8_t __hlt_bytes_can_move(const hlt_bytes* b);
+
+/// Prepares a bytes object for being moved to another thread after
+/// __hlt_bytes_can_move() has confirmed that's possible. It makes sure that
+/// the current thread won't release any of the object's chunks anymore. The
+/// caller is responsible for the object itself.
+///
+/// b: The object.
+///
+/// ctx: The current thread's context.
+extern void __hlt_bytes_move(hlt_bytes* b, hlt_execution_context* ctx);
+
+/// Creates a bytes object that references data owned by somebody else,
+/// without copying it. The object clears the owner's *slot* once nobody can
+/// look at the data anymore, which is when the object goes away or
+/// __hlt_bytes_detach() copies the data. Until then the data must stay in
+/// place.
+///
+/// data: The data.
+///
+/// len: The number of bytes at *data*.
+///
+/// slot: The owner's pointer to the object, which the function sets.
+///
+/// Returns: The new bytes object.
+extern hlt_bytes* __hlt_bytes_new_external(const int8_t* data, hlt_bytes_size len, hlt_bytes** slot, hlt_execution_context* ctx);
+
+/// Copies the data of a bytes object created by __hlt_bytes_new_external()
+/// into memory the object owns itself, so that the owner can take its data
+/// back. That's not possible anymore once iterators point into the data.
+///
+/// b: The object.
+///
+/// Returns: True if the object has its own copy now and cleared the
+/// owner's slot.
+extern int8_t __hlt_bytes_detach(hlt_bytes* b, hlt_execution_context* ctx);
+
+/// Tells a bytes object created by __hlt_bytes_new_external() that its
+/// owner goes away while leaving the data in place for good. The object
+/// clears the owner's slot and won't touch it anymore.
+///
+/// b: The object.
+extern void __hlt_bytes_abandon(hlt_bytes* b, hlt_execution_context* ctx);
+
 /// Creates a new position object representing a specific offset.
 ///
 /// b: The bytes object to create the position for.
@@ -21,6 +21,7 @@ typedef struct {
     void (*dtor)(hlt_callable* callable, hlt_execution_context* ctx); // Dtor function.
     void (*clone_init)(hlt_callable* dst, hlt_callable* src, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx); // Clone init function.
     int64_t object_size; // Total size of the __hlt_callable object.
+    int8_t may_yield;    // True if the function may yield; if not, it can run without a fiber.
 } __hlt_callable_func;
 
 // Definition of a callable.
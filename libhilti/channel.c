@@ -9,15 +9,18 @@
  *   performed on different chunks, there is no need to lock the entire channel
  *   for read and write operations.
  * - Substitute the Monitor design (locks and condititions) with a wait-free
- *   implementation based on atomics. This would also obviate the need for a
- *   channel destructor if we can get rid of the pthread code.
+ *   implementation based on atomics for channels with more than one reader
+ *   or writer as well. Single-producer/single-consumer channels already use
+ *   a lock-free ring buffer.
  */
 
 #include <string.h>
 #include <stdio.h>
 #include <pthread.h>
+#include <sched.h>
 
 #include "channel.h"
+#include "vector.h"
 #include "string_.h"
 #include "clone.h"
 
@@ -48,6 +51,13 @@ typedef struct {
 
     uint64_t ref_cnt;               /* Self-managed ref count for the shared state. */
 
+    int8_t spsc;                    /* True if using the lock-free ring below rather than the chunks. */
+    void* ring;                     /* Ring buffer for single-producer/single-consumer channels. */
+    uint64_t mask;                  /* Number of ring slots minus one; a power of two. */
+    void* item;                     /* The reader's copy of the last item read from the ring. */
+    volatile uint64_t wpos __attribute__((aligned(64))); /* Number of items written, updated only by the writer. */
+    volatile uint64_t rpos __attribute__((aligned(64))); /* Number of items read, updated only by the reader. */
+
     pthread_mutex_t mutex;          /* Synchronizes access to the channel. */
     pthread_cond_t empty_cv;        /* Condition variable for an empty channel. */
     pthread_cond_t full_cv;         /* Condition variable for a full channel. */
@@ -59,6 +69,7 @@ struct __hlt_channel {
 };
 
 static void* _hlt_channel_read_item(hlt_channel* ch, hlt_execution_context* ctx);
+static void* _hlt_ring_read_item(__hlt_channel_shared* shared, hlt_execution_context* ctx);
 
 void hlt_channel_dtor(hlt_type_info* ti, hlt_channel* ch, hlt_execution_context* ctx)
 {
@@ -75,6 +86,17 @@ void hlt_channel_dtor(hlt_type_info* ti, hlt_channel* ch, hlt_execution_context*
 
     pthread_mutex_unlock(&shared->mutex);
 
+    if ( shared->spsc ) {
+        while ( shared->rpos != shared->wpos )
+            _hlt_ring_read_item(shared, ctx);
+
+        hlt_free(shared->ring);
+        hlt_free(shared->item);
+        pthread_mutex_destroy(&shared->mutex);
+        hlt_free(shared);
+        return;
+    }
+
     while ( shared->size )
         _hlt_channel_read_item(ch, ctx);
 
@@ -176,6 +198,75 @@ static inline int _hlt_channel_write_item(hlt_channel* ch, void* data, hlt_excep
     return 0;
 }
 
+// Returns the number of items in a ring. Either side can call this, and
+// the result is current as of the time of the call.
+static inline uint64_t _hlt_ring_size(__hlt_channel_shared* shared)
+{
+    uint64_t rpos = __atomic_load_n(&shared->rpos, __ATOMIC_ACQUIRE);
+    uint64_t wpos = __atomic_load_n(&shared->wpos, __ATOMIC_ACQUIRE);
+    return wpos - rpos;
+}
+
+// Returns the ring slot for a given read or write position.
+static inline void* _hlt_ring_slot(__hlt_channel_shared* shared, uint64_t pos)
+{
+    return shared->ring + (pos & shared->mask) * shared->type->size;
+}
+
+// Internal helper function copying an item into the ring slot at a given
+// position. Must only be called by the writer, and only for a slot it owns.
+// The item becomes visible to the reader only once wpos moves past it.
+static inline void _hlt_ring_copy_in(__hlt_channel_shared* shared, uint64_t pos, void* data, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    void* slot = _hlt_ring_slot(shared, pos);
+
+#ifdef HLT_DEEP_COPY_VALUES_ACROSS_THREADS
+    hlt_clone_deep(slot, shared->type, data, excpt, ctx);
+#else
+    memcpy(slot, data, shared->type->size);
+    GC_CCTOR_GENERIC(slot, shared->type, ctx);
+#endif
+}
+
+// Internal helper function reading from a ring. Must only be called by the
+// reader, and only if the ring isn't empty.
+static inline void* _hlt_ring_read_item(__hlt_channel_shared* shared, hlt_execution_context* ctx)
+{
+    uint64_t rpos = shared->rpos;
+
+    // Copy the item out before releasing the slot to the writer.
+    memcpy(shared->item, _hlt_ring_slot(shared, rpos), shared->type->size);
+    __atomic_store_n(&shared->rpos, rpos + 1, __ATOMIC_RELEASE);
+
+    GC_DTOR_GENERIC(shared->item, shared->type, ctx);
+
+    return shared->item;
+}
+
+// Internal helper function writing into a ring. Must only be called by the
+// writer, and only if the ring isn't full.
+static inline void _hlt_ring_write_item(__hlt_channel_shared* shared, void* data, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    uint64_t wpos = shared->wpos;
+
+    _hlt_ring_copy_in(shared, wpos, data, excpt, ctx);
+
+    // Publish the item to the reader.
+    __atomic_store_n(&shared->wpos, wpos + 1, __ATOMIC_RELEASE);
+}
+
+static inline int _hlt_ring_full(__hlt_channel_shared* shared)
+{
+    uint64_t rpos = __atomic_load_n(&shared->rpos, __ATOMIC_ACQUIRE);
+    return shared->wpos - rpos >= shared->capacity;
+}
+
+static inline int _hlt_ring_empty(__hlt_channel_shared* shared)
+{
+    uint64_t wpos = __atomic_load_n(&shared->wpos, __ATOMIC_ACQUIRE);
+    return wpos == shared->rpos;
+}
+
 void* hlt_channel_clone_alloc(const hlt_type_info* ti, void* srcp, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     return GC_NEW_REF(hlt_channel, ctx);
@@ -196,15 +287,33 @@ void hlt_channel_clone_init(void* dstp, const hlt_type_info* ti, void* srcp, __h
     pthread_mutex_unlock(&shared->mutex);
 }
 
-static inline void _hlt_channel_init(hlt_channel* ch, const hlt_type_info* item_type, hlt_channel_capacity capacity, hlt_exception** excpt, hlt_execution_context* ctx)
+static inline void _hlt_channel_init(hlt_channel* ch, const hlt_type_info* item_type, hlt_channel_capacity capacity, int8_t spsc, hlt_exception** excpt, hlt_execution_context* ctx)
 {
-    __hlt_channel_shared* shared = hlt_malloc(sizeof(__hlt_channel_shared));
+    // The ring's positions are padded onto cache lines of their own,
+    // which holds only if the block itself starts on one.
+    __hlt_channel_shared* shared = hlt_malloc_aligned(64, sizeof(__hlt_channel_shared));
     ch->shared = shared;
 
     shared->ref_cnt = 1;
     shared->type = item_type;
     shared->capacity = capacity;
     shared->size = 0;
+    shared->spsc = spsc;
+
+    if ( spsc ) {
+        uint64_t slots = 1;
+
+        while ( slots < capacity )
+            slots <<= 1;
+
+        shared->ring = hlt_malloc(slots * item_type->size);
+        shared->mask = slots - 1;
+        shared->item = hlt_malloc(item_type->size);
+        shared->rpos = shared->wpos = 0;
+        shared->rc = shared->wc = 0;
+        pthread_mutex_init(&shared->mutex, NULL);
+        return;
+    }
 
     shared->chunk_cap = INITIAL_CHUNK_SIZE;
     shared->rc = shared->wc = _hlt_chunk_create(shared->chunk_cap, shared->type->size, excpt, ctx);
@@ -223,7 +332,19 @@ static inline void _hlt_channel_init(hlt_channel* ch, const hlt_type_info* item_
 hlt_channel* hlt_channel_new(const hlt_type_info* item_type, hlt_channel_capacity capacity, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     hlt_channel *ch = GC_NEW(hlt_channel, ctx);
-    _hlt_channel_init(ch, item_type, capacity, excpt, ctx);
+    _hlt_channel_init(ch, item_type, capacity, 0, excpt, ctx);
+    return ch;
+}
+
+hlt_channel* hlt_channel_new_spsc(const hlt_type_info* item_type, hlt_channel_capacity capacity, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    if ( capacity <= 0 ) {
+        hlt_set_exception(excpt, &hlt_exception_value_error, 0, ctx);
+        return 0;
+    }
+
+    hlt_channel *ch = GC_NEW(hlt_channel, ctx);
+    _hlt_channel_init(ch, item_type, capacity, 1, excpt, ctx);
     return ch;
 }
 
@@ -231,6 +352,15 @@ void hlt_channel_write(hlt_channel* ch, const hlt_type_info* type, void* data, h
 {
     __hlt_channel_shared* shared = ch->shared;
 
+    if ( shared->spsc ) {
+        // We can't yield from here, so we just give up our time slice.
+        while ( _hlt_ring_full(shared) )
+            sched_yield();
+
+        _hlt_ring_write_item(shared, data, excpt, ctx);
+        return;
+    }
+
     pthread_mutex_lock(&shared->mutex);
 
     if ( _hlt_channel_write_item(ch, data, excpt, ctx) )
@@ -247,6 +377,16 @@ void hlt_channel_write_try(hlt_channel* ch, const hlt_type_info* type, void* dat
 {
     __hlt_channel_shared* shared = ch->shared;
 
+    if ( shared->spsc ) {
+        if ( _hlt_ring_full(shared) ) {
+            hlt_set_exception(excpt, &hlt_exception_would_block, 0, ctx);
+            return;
+        }
+
+        _hlt_ring_write_item(shared, data, excpt, ctx);
+        return;
+    }
+
     pthread_mutex_lock(&shared->mutex);
 
     if ( shared->capacity && shared->size == shared->capacity ) {
@@ -268,6 +408,14 @@ void* hlt_channel_read(hlt_channel* ch, hlt_exception** excpt, hlt_execution_con
 {
     __hlt_channel_shared* shared = ch->shared;
 
+    if ( shared->spsc ) {
+        // We can't yield from here, so we just give up our time slice.
+        while ( _hlt_ring_empty(shared) )
+            sched_yield();
+
+        return _hlt_ring_read_item(shared, ctx);
+    }
+
     pthread_mutex_lock(&shared->mutex);
 
     while ( shared->size == 0 )
@@ -285,6 +433,15 @@ void* hlt_channel_read_try(hlt_channel* ch, hlt_exception** excpt, hlt_execution
 {
     __hlt_channel_shared* shared = ch->shared;
 
+    if ( shared->spsc ) {
+        if ( _hlt_ring_empty(shared) ) {
+            hlt_set_exception(excpt, &hlt_exception_would_block, 0, ctx);
+            return 0;
+        }
+
+        return _hlt_ring_read_item(shared, ctx);
+    }
+
     pthread_mutex_lock(&shared->mutex);
 
     void *item = 0;
@@ -303,10 +460,125 @@ unlock_exit:
     return item;
 }
 
+int64_t hlt_channel_read_batch_try(hlt_channel* ch, hlt_vector* items, int64_t max, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    __hlt_channel_shared* shared = ch->shared;
+
+    if ( max <= 0 ) {
+        hlt_set_exception(excpt, &hlt_exception_value_error, 0, ctx);
+        return 0;
+    }
+
+    int64_t n = 0;
+
+    if ( shared->spsc ) {
+        // We are the only reader, so rpos can't change under us; we
+        // synchronize with the writer once for the whole batch.
+        uint64_t rpos = shared->rpos;
+        uint64_t avail = __atomic_load_n(&shared->wpos, __ATOMIC_ACQUIRE) - rpos;
+
+        if ( ! avail ) {
+            hlt_set_exception(excpt, &hlt_exception_would_block, 0, ctx);
+            return 0;
+        }
+
+        n = (avail < max ? avail : max);
+
+        __hlt_vector_resize(items, 0, excpt, ctx);
+        hlt_vector_reserve(items, n, excpt, ctx);
+
+        for ( int64_t i = 0; i < n; i++ ) {
+            void* slot = _hlt_ring_slot(shared, rpos + i);
+            hlt_vector_push_back(items, shared->type, slot, excpt, ctx);
+            GC_DTOR_GENERIC(slot, shared->type, ctx);
+        }
+
+        // Release all the slots to the writer at once.
+        __atomic_store_n(&shared->rpos, rpos + n, __ATOMIC_RELEASE);
+
+        return n;
+    }
+
+    pthread_mutex_lock(&shared->mutex);
+
+    if ( shared->size == 0 ) {
+        hlt_set_exception(excpt, &hlt_exception_would_block, 0, ctx);
+        goto unlock_exit;
+    }
+
+    n = (shared->size < max ? shared->size : max);
+
+    __hlt_vector_resize(items, 0, excpt, ctx);
+    hlt_vector_reserve(items, n, excpt, ctx);
+
+    for ( int64_t i = 0; i < n; i++ )
+        hlt_vector_push_back(items, shared->type, _hlt_channel_read_item(ch, ctx), excpt, ctx);
+
+    pthread_cond_signal(&shared->full_cv);
+
+unlock_exit:
+    pthread_mutex_unlock(&shared->mutex);
+    return n;
+}
+
+int64_t hlt_channel_write_batch_try(hlt_channel* ch, hlt_vector* items, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    __hlt_channel_shared* shared = ch->shared;
+
+    int64_t size = hlt_vector_size(items, excpt, ctx);
+    int64_t n = 0;
+
+    if ( ! size )
+        return 0;
+
+    if ( shared->spsc ) {
+        // We are the only writer, so wpos can't change under us; we
+        // synchronize with the reader once for the whole batch.
+        uint64_t wpos = shared->wpos;
+        uint64_t space = shared->capacity - (wpos - __atomic_load_n(&shared->rpos, __ATOMIC_ACQUIRE));
+
+        n = (space < (uint64_t)size ? space : size);
+
+        if ( ! n ) {
+            hlt_set_exception(excpt, &hlt_exception_would_block, 0, ctx);
+            return 0;
+        }
+
+        for ( int64_t i = 0; i < n; i++ )
+            _hlt_ring_copy_in(shared, wpos + i, hlt_vector_get(items, i, excpt, ctx), excpt, ctx);
+
+        // Publish all the items to the reader at once.
+        __atomic_store_n(&shared->wpos, wpos + n, __ATOMIC_RELEASE);
+
+        return n;
+    }
+
+    pthread_mutex_lock(&shared->mutex);
+
+    while ( n < size && ! (shared->capacity && shared->size == shared->capacity) ) {
+        if ( _hlt_channel_write_item(ch, hlt_vector_get(items, n, excpt, ctx), excpt, ctx) )
+            goto unlock_exit;
+
+        ++n;
+    }
+
+    if ( n )
+        pthread_cond_signal(&shared->empty_cv);
+    else
+        hlt_set_exception(excpt, &hlt_exception_would_block, 0, ctx);
+
+unlock_exit:
+    pthread_mutex_unlock(&shared->mutex);
+    return n;
+}
+
 hlt_channel_capacity hlt_channel_size(hlt_channel* ch, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     __hlt_channel_shared* shared = ch->shared;
 
+    if ( shared->spsc )
+        return _hlt_ring_size(shared);
+
     return shared->size;
 }
 
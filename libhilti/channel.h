@@ -9,6 +9,7 @@
 
 #include "types.h"
 #include "exceptions.h"
+#include "vector.h"
 
 /// Type for current size and capacity of a channel.
 typedef int64_t hlt_channel_capacity;
@@ -26,6 +27,22 @@ typedef struct __hlt_channel hlt_channel;
 /// Returns: The new channel.
 extern hlt_channel* hlt_channel_new(const hlt_type_info* item_type, hlt_channel_capacity capacity, hlt_exception** excpt, hlt_execution_context* ctx);
 
+/// Creates a new channel for a single writer and a single reader. Such a
+/// channel stores its items in a lock-free ring buffer, and hence neither
+/// side ever waits for a lock. It is undefined what happens if more than
+/// one thread writes to, or reads from, the channel.
+///
+/// item_type: The type of the items written into the channel.
+///
+/// capacity: The maximum capacity of the channel, which must be positive.
+///
+/// excpt: &
+///
+/// Returns: The new channel.
+///
+/// Raises: ValueError if the capacity isn't positive.
+extern hlt_channel* hlt_channel_new_spsc(const hlt_type_info* item_type, hlt_channel_capacity capacity, hlt_exception** excpt, hlt_execution_context* ctx);
+
 /// Write an item into a channel. If the channel has already reached its
 /// capacity, the function blocks until an item is read from the channel.
 ///
@@ -72,6 +89,37 @@ extern void* hlt_channel_read(hlt_channel* ch, hlt_exception** excpt, hlt_execut
 /// Returns: A pointer to the read item.
 extern void* hlt_channel_read_try(hlt_channel* ch, hlt_exception** excpt, hlt_execution_context* ctx);
 
+/// Attempts to read a batch of items from a channel. If the channel is
+/// empty, a WouldBlock exception is thrown.
+///
+/// ch: The channel to read from.
+///
+/// items: A vector that receives the items. Its previous content is
+/// replaced with exactly the items read, in order.
+///
+/// max: The maximum number of items to read, which must be positive.
+///
+/// excpt: &
+///
+/// Returns: The number of items read.
+///
+/// Raises: ValueError if *max* isn't positive.
+extern int64_t hlt_channel_read_batch_try(hlt_channel* ch, hlt_vector* items, int64_t max, hlt_exception** excpt, hlt_execution_context* ctx);
+
+/// Attempts to write a batch of items into a channel. The function writes
+/// as many of the items as the channel can accomodate, starting with the
+/// first. If it can't write any of them, a WouldBlock exception is thrown.
+///
+/// ch: The channel to write into.
+///
+/// items: A vector with the items to write.
+///
+/// excpt: &
+///
+/// Returns: The number of items written, which may be less than the size
+/// of the vector.
+extern int64_t hlt_channel_write_batch_try(hlt_channel* ch, hlt_vector* items, hlt_exception** excpt, hlt_execution_context* ctx);
+
 /// Returns the current channel size, i.e., the number of items in the
 /// channel.
 ///
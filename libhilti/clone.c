@@ -6,6 +6,11 @@
 #include "rtti.h"
 #include "string_.h"
 #include "exceptions.h"
+#include "memory_.h"
+#include "bytes.h"
+#include "context.h"
+#include "struct.h"
+#include "tuple.h"
 
 // When cloning, copy only the first level and keep all contained references
 // the same.
@@ -18,6 +23,12 @@
 static int8_t _fastpath_clone(void* dst, const hlt_type_info* ti, const void* srcp);
 static void _slowpath_clone(void* dst, const hlt_type_info* ti, const void* srcp, int16_t type, hlt_vthread_id vid, hlt_exception** excpt, hlt_execution_context* ctx);
 static void _slowpath_clone_recursive(void* dst, const hlt_type_info* ti, const void* srcp, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx);
+static void _init_state(__hlt_clone_state* cstate, int16_t type, hlt_vthread_id vid);
+static void _destroy_state(__hlt_clone_state* cstate);
+#ifdef DEBUG
+static void _transfer_validate(void* objp, const hlt_type_info* ti, int8_t owned, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx);
+static void _transfer_validate_contained(void* objp, const hlt_type_info* ti, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx);
+#endif
 
 void hlt_clone_deep(void* dstp, const hlt_type_info* ti, const void* srcp, hlt_exception** excpt, hlt_execution_context* ctx)
 {
@@ -43,6 +54,200 @@ void hlt_clone_for_thread(void* dstp, const hlt_type_info* ti, const void* srcp,
     _slowpath_clone(dstp, ti, srcp, __HLT_CLONE_DEEP, vid, excpt, ctx);
 }
 
+static void _transfer(void* objp, const hlt_type_info* ti, int8_t owned, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx);
+
+void hlt_clone_transfer(void* dstp, const hlt_type_info* ti, const void* srcp, hlt_vthread_id vid, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    if ( _fastpath_clone(dstp, ti, srcp) )
+        return;
+
+    __hlt_clone_state cstate;
+    _init_state(&cstate, __HLT_CLONE_DEEP, vid);
+
+    // Take over the caller's reference, then fix up in place whatever can't
+    // be moved.
+    memcpy(dstp, srcp, ti->size);
+    _transfer(dstp, ti, 1, &cstate, excpt, ctx);
+
+#ifdef DEBUG
+    if ( ! hlt_check_exception(excpt) )
+        _transfer_validate(dstp, ti, 1, &cstate, excpt, ctx);
+#endif
+
+    _destroy_state(&cstate);
+}
+
+void hlt_clone_transfer_unaliased(void* dstp, const hlt_type_info* ti, const void* srcp, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    if ( _fastpath_clone(dstp, ti, srcp) )
+        return;
+
+    __hlt_clone_state cstate;
+    _init_state(&cstate, __HLT_CLONE_DEEP, ctx->vid);
+    cstate.unaliased = 1;
+
+    // Take a reference of our own. If that turns out to be the only one,
+    // the value is ours to move.
+    memcpy(dstp, srcp, ti->size);
+    GC_CCTOR_GENERIC(dstp, ti, ctx);
+    _transfer(dstp, ti, 0, &cstate, excpt, ctx);
+
+#ifdef DEBUG
+    if ( ! hlt_check_exception(excpt) )
+        _transfer_validate(dstp, ti, 0, &cstate, excpt, ctx);
+#endif
+
+    _destroy_state(&cstate);
+}
+
+// Returns the current reference count of a garbage collected object.
+static inline int64_t _ref_cnt(const void* obj)
+{
+    return __atomic_load_n(&((__hlt_gchdr*)obj)->ref_cnt, __ATOMIC_SEQ_CST);
+}
+
+// Returns true if a value's storage can be handed over to another thread as
+// is. Contained values still need to be looked at separately.
+//
+// Locals don't hold references, so a reference count of one doesn't mean
+// nobody else is looking at an object. We hence need the caller to rule
+// that out: either *owned* is true, meaning nothing can reach the value
+// anymore at all (see hlt_clone_transfer()); or the clone state is marked
+// as unaliased, meaning no local will look at the value or anything it
+// contains anymore (see hlt_clone_transfer_unaliased()). With that, the
+// reference we're handing over being the only one proves that the object
+// is ours to move.
+static int8_t _transfer_can_move(const hlt_type_info* ti, const void* objp, int8_t owned, __hlt_clone_state* cstate)
+{
+    if ( ti->atomic )
+        return 1;
+
+    if ( ti->type == HLT_TYPE_TUPLE )
+        // Value type, the storage is the caller's.
+        return 1;
+
+    if ( ! ti->gc )
+        return 0;
+
+    const void* obj = *(const void**)objp;
+
+    if ( ! obj )
+        return 1;
+
+#ifndef HLT_DEEP_COPY_VALUES_ACROSS_THREADS
+    if ( ti->type == HLT_TYPE_STRING )
+        // Immutable, and reference counting is atomic.
+        return 1;
+#endif
+
+    if ( ! (owned || cstate->unaliased) )
+        return 0;
+
+    if ( _ref_cnt(obj) != 1 )
+        return 0;
+
+    // Limit moving to types we know how to recurse into; everything else
+    // may hold on to further objects shared with the current thread.
+    switch ( ti->type ) {
+     case HLT_TYPE_STRUCT:
+     case HLT_TYPE_STRING:
+        return 1;
+
+     case HLT_TYPE_BYTES:
+        return __hlt_bytes_can_move((hlt_bytes*)obj);
+
+     default:
+        return 0;
+    }
+}
+
+static void _transfer(void* objp, const hlt_type_info* ti, int8_t owned, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    if ( ti->atomic )
+        return;
+
+    if ( _transfer_can_move(ti, objp, owned, cstate) ) {
+        if ( ti->gc && *(void**)objp )
+            // Make sure the current thread doesn't release it anymore once
+            // we're done with it.
+            __hlt_memory_nullbuffer_remove(ctx->nullbuffer, *(void**)objp);
+
+        if ( ti->type == HLT_TYPE_BYTES && *(void**)objp )
+            __hlt_bytes_move(*(hlt_bytes**)objp, ctx);
+
+        else if ( ti->type == HLT_TYPE_STRUCT )
+            __hlt_struct_transfer(ti, objp, __hlt_clone_transfer, cstate, excpt, ctx);
+
+        else if ( ti->type == HLT_TYPE_TUPLE )
+            __hlt_tuple_transfer(ti, objp, __hlt_clone_transfer, cstate, excpt, ctx);
+
+        return;
+    }
+
+    // Possibly shared, replace with a copy.
+    int8_t copy[ti->size];
+    __hlt_clone(copy, ti, objp, cstate, excpt, ctx);
+
+    if ( hlt_check_exception(excpt) )
+        return;
+
+#ifdef DEBUG
+    if ( ti->gc )
+        __hlt_pointer_map_insert(&cstate->copies, *(void**)copy, *(void**)copy);
+#endif
+
+    GC_DTOR_GENERIC(objp, ti, ctx);
+    memcpy(objp, copy, ti->size);
+}
+
+void __hlt_clone_transfer(void* objp, const hlt_type_info* ti, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    _transfer(objp, ti, 0, cstate, excpt, ctx);
+}
+
+#ifdef DEBUG
+
+// Makes sure that a transferred value doesn't share anything mutable with
+// the current thread anymore. Objects contained in the value must have been
+// copied unless they're immutable or the transfer was unaliased.
+static void _transfer_validate(void* objp, const hlt_type_info* ti, int8_t owned, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    if ( ti->atomic )
+        return;
+
+    if ( ti->gc ) {
+        void* obj = *(void**)objp;
+
+        if ( ! obj || __hlt_pointer_map_lookup(&cstate->copies, obj) )
+            return;
+
+#ifndef HLT_DEEP_COPY_VALUES_ACROSS_THREADS
+        if ( ti->type == HLT_TYPE_STRING )
+            return;
+#endif
+
+        if ( ! (owned || cstate->unaliased) || __hlt_memory_nullbuffer_contains(ctx->nullbuffer, obj) ||
+             (ti->type == HLT_TYPE_BYTES && ! __hlt_bytes_can_move((hlt_bytes*)obj)) ) {
+            hlt_string msg = hlt_string_from_asciiz("transferred object still shared with source thread", excpt, ctx);
+            hlt_set_exception(excpt, &hlt_exception_internal_error, msg, ctx);
+            return;
+        }
+    }
+
+    if ( ti->type == HLT_TYPE_STRUCT )
+        __hlt_struct_transfer(ti, objp, _transfer_validate_contained, cstate, excpt, ctx);
+
+    else if ( ti->type == HLT_TYPE_TUPLE )
+        __hlt_tuple_transfer(ti, objp, _transfer_validate_contained, cstate, excpt, ctx);
+}
+
+static void _transfer_validate_contained(void* objp, const hlt_type_info* ti, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    _transfer_validate(objp, ti, 0, cstate, excpt, ctx);
+}
+
+#endif
+
 void __hlt_clone(void* dstp, const hlt_type_info* ti, const void* srcp, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     if ( _fastpath_clone(dstp, ti, srcp) )
@@ -84,17 +289,34 @@ int8_t _fastpath_clone(void* dstp, const hlt_type_info* ti, const void* srcp)
     return 0;
 }
 
+static void _init_state(__hlt_clone_state* cstate, int16_t type, hlt_vthread_id vid)
+{
+    __hlt_pointer_map_init(&cstate->objs);
+#ifdef DEBUG
+    __hlt_pointer_map_init(&cstate->copies);
+#endif
+    cstate->type = type;
+    cstate->vid = vid;
+    cstate->level = -1;
+    cstate->unaliased = 0;
+}
+
+static void _destroy_state(__hlt_clone_state* cstate)
+{
+    __hlt_pointer_map_destroy(&cstate->objs);
+#ifdef DEBUG
+    __hlt_pointer_map_destroy(&cstate->copies);
+#endif
+}
+
 static void _slowpath_clone(void* dstp, const hlt_type_info* ti, const void* srcp, int16_t type, hlt_vthread_id vid, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     __hlt_clone_state cstate;
-    __hlt_pointer_map_init(&cstate.objs);
-    cstate.type = type;
-    cstate.vid = vid;
-    cstate.level = -1;
+    _init_state(&cstate, type, vid);
 
     _slowpath_clone_recursive(dstp, ti, srcp, &cstate, excpt, ctx);
 
-    __hlt_pointer_map_destroy(&cstate.objs);
+    _destroy_state(&cstate);
 }
 
 static void _slowpath_clone_recursive(void* dstp, const hlt_type_info* ti, const void* srcp, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx)
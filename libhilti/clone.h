@@ -11,6 +11,10 @@ struct __hlt_clone_state {
     int32_t level;           // Current recursion level.
     hlt_vthread_id vid;      // Thread hint.
     __hlt_pointer_map objs;  // Cache of objects seen already.
+    int8_t unaliased;        // True for hlt_clone_transfer_unaliased().
+#ifdef DEBUG
+    __hlt_pointer_map copies; // Objects created by a transfer rather than moved.
+#endif
 };
 
 /// Deep-copies a HILTI value for use within the same thread.
@@ -72,6 +76,76 @@ extern void hlt_clone_shallow(void* dstp, const hlt_type_info* ti, const void* s
 /// ctx: & 
 extern void hlt_clone_for_thread(void* dstp, const hlt_type_info* ti, const void* srcp, hlt_vthread_id vid, hlt_exception** excpt, hlt_execution_context* ctx);
 
+/// Transfers a HILTI value to a different thread, moving it over instead of
+/// copying where that's safe. The caller must guarantee that nothing else
+/// can reach the source value anymore, not even through a local; the code
+/// generator uses this for objects it has just built itself. The value is
+/// then moved if it's a struct, or a bytes object consisting only of data
+/// of its own (see __hlt_bytes_can_move()). Values contained in a moved
+/// struct or tuple may still be reachable from elsewhere, as a reference
+/// count of one doesn't prove otherwise. They are hence moved only if
+/// they're immutable and reference counting is thread-safe; everything else
+/// gets deep-copied as with hlt_clone_for_thread(). In debug builds, the
+/// result is validated to not share any mutable object with the current
+/// thread anymore.
+///
+/// Different from the other clone functions, this *consumes* the caller's
+/// reference to the source. On return, the source must not be used anymore.
+///
+/// dstp: A pointer to where the transferred version is to be stored. For
+/// garbage collected types, this is where a *pointer* to the object will be
+/// stored. For all other types, it's where the object itself will be placed,
+/// and it must provide sufficient space for at least as many bytes as \c
+/// ti->size specifies. The result is at +1, with ownership passed to the
+/// caller for handing over to the target thread.
+///
+/// ti: The type information for the object to be transferred.
+///
+/// srcp: The source object to be transferred, at +1. For garbage collected
+/// types this can be null, in which case the result will be so too.
+///
+/// vid: The thread which will take ownership of the object.
+///
+/// excpt: &
+/// ctx: &
+extern void hlt_clone_transfer(void* dstp, const hlt_type_info* ti, const void* srcp, hlt_vthread_id vid, hlt_exception** excpt, hlt_execution_context* ctx);
+
+/// Transfers a HILTI value to a different thread like hlt_clone_transfer(),
+/// but for a value that the caller may still be able to reach. Instead, the
+/// caller guarantees that no local variable referencing the value, or
+/// anything it contains, will be used again; the code generator uses this
+/// for arguments of thread.schedule that aren't live anymore afterwards.
+/// References held elsewhere are visible in the reference counts, so any
+/// object that only the value itself references is moved, recursively. That
+/// includes the chunks of a bytes object contained in a struct. Everything
+/// else gets deep-copied as with hlt_clone_for_thread().
+///
+/// Different from hlt_clone_transfer(), the source is taken at +0. The
+/// caller must not use it anymore after this returns.
+///
+/// dstp: A pointer to where the transferred version is to be stored. The
+/// result is at +1, with ownership passed to the caller for handing over to
+/// the target thread.
+///
+/// ti: The type information for the object to be transferred.
+///
+/// srcp: The source object to be transferred. For garbage collected types
+/// this can be null, in which case the result will be so too.
+///
+/// excpt: &
+/// ctx: &
+extern void hlt_clone_transfer_unaliased(void* dstp, const hlt_type_info* ti, const void* srcp, hlt_exception** excpt, hlt_execution_context* ctx);
+
+typedef void (*__hlt_transfer_callback)(void* objp, const hlt_type_info* ti, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx);
+
+/// Internal version of hlt_clone_transfer() for values contained in an
+/// object that's being moved. The value at *objp* is updated in place if it
+/// needs to be copied.
+///
+/// Arguments are the same as with hlt_clone_transfer() except for the clone
+/// state parameter, which must be passed through.
+extern void __hlt_clone_transfer(void* objp, const hlt_type_info* ti, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx);
+
 /// Internal version of the clone method that must be used by type-specific
 /// clone implementations when cloning values recursively that they contain.
 /// This must be called independent of what clone type is in use (deep or
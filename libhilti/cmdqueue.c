@@ -8,6 +8,7 @@
 
 #include "cmdqueue.h"
 #include "config.h"
+#include "file.h"
 #include "context.h"
 #include "debug.h"
 #include "globals.h"
@@ -87,7 +88,7 @@ void __hlt_cmd_queue_init()
     DBG_LOG(DBG_STREAM_QUEUE, "starting command queue manager thread");
 
     __hlt_globals()->cmd_queue = hlt_thread_queue_new(hlt_config_get()->num_workers + 1, 1000, 0); // Slot 0 is main thread.
-    __hlt_globals()->cmd_context = __hlt_execution_context_new_ref(HLT_VID_CMDQUEUE, 0);
+    __hlt_globals()->cmd_context = __hlt_execution_context_new_ref(HLT_VID_CMDQUEUE, 0, 0);
 
     if ( ! __hlt_globals()->cmd_queue )
         fatal_error("cannot create command queue data structure");
@@ -106,6 +107,9 @@ void __hlt_cmd_worker_terminating(int worker)
 
 void __hlt_cmd_queue_done()
 {
+    // Get out what the main thread still has buffered.
+    __hlt_files_flush(0, 0, hlt_global_execution_context());
+
     if ( ! hlt_is_multi_threaded() )
         return;
 
@@ -140,6 +144,11 @@ void __hlt_cmdqueue_init_cmd(__hlt_cmd *cmd, uint16_t type)
 }
 
 void __hlt_cmdqueue_push(__hlt_cmd *cmd, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    __hlt_cmdqueue_push_writer(cmd, ctx->worker ? ctx->worker->id : 0, excpt, ctx);
+}
+
+void __hlt_cmdqueue_push_writer(__hlt_cmd *cmd, int writer, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     if ( ! hlt_is_multi_threaded() ) {
         DBG_LOG(DBG_STREAM_QUEUE, "directly executing cmd %p of type %d", cmd, cmd->type);
@@ -148,7 +157,7 @@ void __hlt_cmdqueue_push(__hlt_cmd *cmd, hlt_exception** excpt, hlt_execution_co
 
     else {
         DBG_LOG(DBG_STREAM_QUEUE, "queuing cmd %p of type %d", cmd, cmd->type);
-        hlt_thread_queue_write(__hlt_globals()->cmd_queue, ctx->worker ? ctx->worker->id : 0, cmd);
+        hlt_thread_queue_write(__hlt_globals()->cmd_queue, writer, cmd);
     }
 }
 
@@ -57,6 +57,11 @@ void __hlt_cmdqueue_init_cmd(__hlt_cmd *cmd, uint16_t type);
 // command and return only after it has finished.
 extern void __hlt_cmdqueue_push(__hlt_cmd *cmd, hlt_exception** excpt, hlt_execution_context* ctx);
 
+// Like __hlt_cmdqueue_push(), but with an explicit writer slot rather than
+// deriving it from the context. Slot 0 is the main thread, and 1..n are
+// the worker threads.
+extern void __hlt_cmdqueue_push_writer(__hlt_cmd *cmd, int writer, hlt_exception** excpt, hlt_execution_context* ctx);
+
 // Signals that a worker thread is about to terminate.
 extern void __hlt_cmd_worker_terminating(int worker);
 
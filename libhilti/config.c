@@ -21,6 +21,7 @@ hlt_config* __hlt_default_config()
         dbg = "";
 
     const char* profile = getenv("HILTI_PROFILE");
+    const char* seed = getenv("HILTI_HASH_SEED");
 
     // Set defaults.
     cfg->num_workers = 2;
@@ -35,6 +36,11 @@ hlt_config* __hlt_default_config()
     cfg->vid_schedule_min = 1;
     cfg->vid_schedule_max = 101;
     cfg->core_affinity = "DEFAULT";
+    cfg->file_buffer_size = 65536;
+    cfg->file_flush_interval = 1.0;
+    cfg->file_direct_write = 0;
+    cfg->vthread_idle_timeout = 0;
+    cfg->hash_seed = seed ? strtoull(seed, 0, 10) : 0;
 
     return cfg;
 }
@@ -54,6 +54,33 @@ struct __hlt_config
     /// itself.
     const char* core_affinity;
 
+    /// Number of bytes a thread buffers per file before handing them over
+    /// for writing. Zero disables buffering. Default is 64K.
+    size_t file_buffer_size;
+
+    /// Seconds a thread's buffered output to a file may be pending before
+    /// it's handed over for writing. Default is 1.
+    double file_flush_interval;
+
+    /// 1 to let a thread that is the only one writing to a file do its
+    /// writes directly, rather than going through the command queue.
+    /// Default is off.
+    int8_t file_direct_write;
+
+    /// Seconds of global time after which a worker deletes the execution
+    /// context of a virtual thread that hasn't run a job since, and has
+    /// neither timers nor blocked jobs pending. The context gets recreated
+    /// if another job comes in, with its thread-local globals reset. Zero
+    /// keeps contexts around forever, which is the default.
+    double vthread_idle_timeout;
+
+    /// Seed for keying the hash functions used by maps and sets. Zero picks
+    /// a random seed for each process, which is the default unless the
+    /// environment variable ``HILTI_HASH_SEED`` is set. A fixed seed makes
+    /// iteration order reproducible, but also lets anybody knowing it craft
+    /// colliding input.
+    uint64_t hash_seed;
+
 };
 
 /// Returns the current configuration. The returned value cannot be directly
@@ -11,7 +11,7 @@
 #include "linker.h"
 #include "timer.h"
 
-hlt_execution_context* __hlt_execution_context_new_ref(hlt_vthread_id vid, int8_t run_module_init)
+hlt_execution_context* __hlt_execution_context_new_ref(hlt_vthread_id vid, struct __hlt_worker_thread* worker, int8_t run_module_init)
 {
     hlt_execution_context* ctx = (hlt_execution_context*)
         hlt_malloc(sizeof(hlt_execution_context) + __hlt_globals_size());
@@ -20,8 +20,9 @@ hlt_execution_context* __hlt_execution_context_new_ref(hlt_vthread_id vid, int8_
     ctx->nullbuffer = __hlt_memory_nullbuffer_new(); // init first 
     ctx->excpt = 0;
     ctx->fiber = 0;
-    ctx->fiber_pool = __hlt_fiber_pool_new();
-    ctx->worker = 0;
+    ctx->worker = worker;
+    // Fibers always come from the worker's pool if there's one.
+    ctx->fiber_pool = worker ? 0 : __hlt_fiber_pool_new();
     ctx->tcontext = 0;
     ctx->tcontext_type = 0;
     ctx->pstate = 0;
@@ -62,7 +63,8 @@ void hlt_execution_context_delete(hlt_execution_context* ctx)
         GC_DTOR_GENERIC(&ctx->tcontext, ctx->tcontext_type, ctx);
     }
 
-    __hlt_fiber_pool_delete(ctx->fiber_pool);
+    if ( ctx->fiber_pool )
+        __hlt_fiber_pool_delete(ctx->fiber_pool);
 
     if ( ctx->nullbuffer )
         __hlt_memory_nullbuffer_delete(ctx->nullbuffer, ctx);
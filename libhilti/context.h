@@ -50,10 +50,14 @@ struct __hlt_execution_context {
 /// vid: The ID of the virtual thread the context will belong to.
 /// ~~HLT_VID_MAIN for the main (non-worker) thread.
 ///
+/// worker: The worker thread the virtual thread is mapped to, or null if
+/// none. A worker's contexts share its fiber pool rather than getting their
+/// own.
+///
 /// run_module_init: Whether to run the modules' init functions.
 ///
 /// Returns: The new context at +1.
-extern hlt_execution_context* __hlt_execution_context_new_ref(hlt_vthread_id vid, int8_t run_module_init);
+extern hlt_execution_context* __hlt_execution_context_new_ref(hlt_vthread_id vid, struct __hlt_worker_thread* worker, int8_t run_module_init);
 
 /// Deletes an execution context.
 ///
@@ -15,6 +15,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <inttypes.h>
+#include <unwind.h>
 
 // The mother of all exceptions.
 hlt_exception_type hlt_exception_unspecified = { "Unspecified", 0, 0 };
@@ -236,6 +237,50 @@ void __hlt_exception_print_uncaught_abort(hlt_exception* exception, hlt_executio
     hlt_abort();
 }
 
+// Exception class identifying our unwinds to the unwinder.
+static const _Unwind_Exception_Class __hlt_unwind_class = 0x484c54004c4e5700ULL; // "HLT\0UNW\0"
+
+// The unwinder's object for an exception in flight. The HILTI exception
+// itself stays in the execution context, and the landing pads never look at
+// this, so one per thread is all we need.
+static __thread struct _Unwind_Exception __hlt_unwind_excpt;
+
+extern _Unwind_Reason_Code __gcc_personality_v0(int version, _Unwind_Action actions, _Unwind_Exception_Class cls, struct _Unwind_Exception* uexcpt, struct _Unwind_Context* uctx);
+
+static _Unwind_Reason_Code __hlt_unwind_stop(int version, _Unwind_Action actions, _Unwind_Exception_Class cls, struct _Unwind_Exception* uexcpt, struct _Unwind_Context* uctx, void* cookie)
+{
+    if ( actions & _UA_END_OF_STACK ) {
+        // No landing pad took it; the code generator should never let
+        // that happen.
+        hlt_execution_context* ctx = (hlt_execution_context*)cookie;
+        __hlt_exception_print_uncaught_abort(ctx->excpt, ctx);
+    }
+
+    return _URC_NO_REASON;
+}
+
+void __hlt_exception_unwind(hlt_execution_context* ctx)
+{
+    struct _Unwind_Exception* uexcpt = &__hlt_unwind_excpt;
+    uexcpt->exception_class = __hlt_unwind_class;
+    uexcpt->exception_cleanup = 0;
+
+    // We force the unwind as all our landing pads are cleanups that decide
+    // themselves whether to catch the exception. That also saves the
+    // search phase.
+    _Unwind_ForcedUnwind(uexcpt, __hlt_unwind_stop, ctx);
+
+    // Only returns on error.
+    __hlt_exception_print_uncaught_abort(ctx->excpt, ctx);
+}
+
+_Unwind_Reason_Code __hlt_personality(int version, _Unwind_Action actions, _Unwind_Exception_Class cls, struct _Unwind_Exception* uexcpt, struct _Unwind_Context* uctx)
+{
+    // Our landing pads are all cleanups, which is exactly what the C
+    // personality routine supports.
+    return __gcc_personality_v0(version, actions, cls, uexcpt, uctx);
+}
+
 hlt_string hlt_exception_to_string(const hlt_type_info* type, const void* obj, int32_t options, __hlt_pointer_stack* seen, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     const hlt_exception* e = *((const hlt_exception**)obj);
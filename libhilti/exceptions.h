@@ -78,6 +78,16 @@ extern int8_t hlt_exception_is_yield(hlt_exception* excpt);
 /// Returns true if the given exception is a \a termination exception.
 extern int8_t hlt_exception_is_termination(hlt_exception* excpt);
 
+/// Internal function that propagates the exception currently set in an
+/// execution context by unwinding the native stack. Generated code uses
+/// this with Options::unwind_exceptions, and it must make sure that a
+/// landing pad catches the unwind before it leaves the HILTI code; the
+/// landing pad then finds the exception in the context. The function does
+/// not return.
+///
+/// ctx: The current execution context, with the exception set.
+extern void __hlt_exception_unwind(hlt_execution_context* ctx) __attribute__((noreturn));
+
 /// Internal function that generates the output shown to the user when an
 /// exception is not caught, and then aborts processing. This function is
 /// intended for use outside of threads.
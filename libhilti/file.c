@@ -4,19 +4,40 @@
 #include <errno.h>
 #include <ctype.h>
 #include <unistd.h>
+#include <limits.h>
 #include <pthread.h>
+#include <time.h>
+#include <sys/uio.h>
 
 #include "file.h"
 #include "memory_.h"
 #include "globals.h"
+#include "config.h"
+#include "threading.h"
 #include "autogen/hilti-hlt.h"
 
+// Size of the blocks that write buffers are made of.
+#define BUFFER_CHUNK_SIZE 16384
+
+// Output that one writer thread has buffered for a file. Only that thread
+// accesses its buffer, so there's no locking needed.
+typedef struct __hlt_file_buffer {
+    struct iovec* iov;  // The buffered blocks, each allocated with BUFFER_CHUNK_SIZE bytes.
+    int iovcnt;         // Number of blocks in use.
+    int iovcap;         // Number of entries allocated for iov.
+    size_t len;         // Total number of bytes buffered.
+    double first;       // Time when the oldest buffered data was written.
+} __hlt_file_buffer;
+
 // This struct describes one currently open file. We memory-manage this ourselves.
 struct __hlt_file_info {
     hlt_string path;    // The path of the file.
     int fd;             // The file descriptor.
     int writers;        // The number of file objects having the file open from the OS perspective.
     bool error;         // True if we run into an error.
+    bool append;        // True if opened in append mode.
+    int owner;          // With direct writes, the writer slot writing directly, -1 if none yet, -2 if shared.
+    __hlt_file_buffer* buffers; // Output buffers, one per writer slot (see _writer_slot()).
 
     struct __hlt_file_info* next; // We keep them in a list.
     struct __hlt_file_info* prev;
@@ -36,9 +57,9 @@ struct __hlt_file {
 typedef struct __hlt_cmd_file {
     __hlt_cmd cmd;             // The common header for all commands.
     __hlt_file_info* info;     // The file to write to.
-    int type;                  // 1 for writing data; 1 if it's a close command; and 2 for a change in parameters.
-    char* data;                // Bytes to write.
-    int len;                   // Number of bytes to write.
+    int type;                  // 1 for opening; 2 for writing data; 3 for closing.
+    struct iovec* iov;         // For type 2: Blocks to write, taken over from a writer's buffer.
+    int iovcnt;                // For type 2: Number of blocks.
 
     hlt_enum param_type;       // For type 0: The type.
     hlt_enum param_mode;       // For type 0: The mode.
@@ -77,6 +98,280 @@ static inline void release_lock(int i)
     hlt_pthread_setcancelstate(i, NULL);
 }
 
+static inline int _writer_slot(hlt_execution_context* ctx)
+{
+    // Same numbering as the command queue's writers; 0 is the main thread.
+    return ctx->worker ? ctx->worker->id : 0;
+}
+
+static inline int _num_writer_slots()
+{
+    return hlt_is_multi_threaded() ? hlt_config_get()->num_workers + 1 : 1;
+}
+
+static inline double _current_time()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void _buffer_append(__hlt_file_buffer* buf, const int8_t* data, size_t len)
+{
+    if ( ! buf->len )
+        buf->first = _current_time();
+
+    buf->len += len;
+
+    while ( len ) {
+        struct iovec* last = buf->iovcnt ? &buf->iov[buf->iovcnt - 1] : 0;
+
+        if ( ! last || last->iov_len == BUFFER_CHUNK_SIZE ) {
+            if ( buf->iovcnt == buf->iovcap ) {
+                int old_cap = buf->iovcap;
+                buf->iovcap = old_cap ? old_cap * 2 : 8;
+                buf->iov = hlt_realloc(buf->iov, buf->iovcap * sizeof(struct iovec), old_cap * sizeof(struct iovec));
+            }
+
+            last = &buf->iov[buf->iovcnt++];
+            last->iov_base = hlt_malloc_no_init(BUFFER_CHUNK_SIZE);
+            last->iov_len = 0;
+        }
+
+        size_t n = BUFFER_CHUNK_SIZE - last->iov_len;
+
+        if ( n > len )
+            n = len;
+
+        memcpy((char*)last->iov_base + last->iov_len, data, n);
+        last->iov_len += n;
+        data += n;
+        len -= n;
+    }
+}
+
+static void _free_iov(struct iovec* iov, int iovcnt)
+{
+    int i;
+
+    for ( i = 0; i < iovcnt; i++ )
+        hlt_free(iov[i].iov_base);
+
+    hlt_free(iov);
+}
+
+// Writes out all blocks, restarting on partial writes and EINTR. Returns
+// false on error.
+static int8_t _writev_all(int fd, struct iovec* iov, int iovcnt)
+{
+    while ( iovcnt ) {
+        ssize_t n = writev(fd, iov, iovcnt < IOV_MAX ? iovcnt : IOV_MAX);
+
+        if ( n < 0 ) {
+            if ( errno == EINTR )
+                continue;
+
+            return 0;
+        }
+
+        // Skip what's been written completely, and adjust a partial one.
+        while ( iovcnt && (size_t)n >= iov->iov_len ) {
+            n -= iov->iov_len;
+            ++iov;
+            --iovcnt;
+        }
+
+        if ( iovcnt ) {
+            iov->iov_base = (char*)iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+
+    return 1;
+}
+
+// Records that we ran into an error with the file. Must be called without
+// the lock held.
+static void _set_error(__hlt_file_info* info)
+{
+    int s = 0;
+    acqire_lock(&s);
+    info->error = 1;
+    release_lock(s);
+}
+
+// Writes out and releases what all writers still have buffered for the
+// file. Must be called with the lock held, and only once no file object has
+// the file open anymore.
+static void _write_out_buffers(__hlt_file_info* info)
+{
+    int i;
+    for ( i = 0; i < _num_writer_slots(); i++ ) {
+        __hlt_file_buffer* buf = &info->buffers[i];
+
+        if ( ! buf->iov )
+            continue;
+
+        if ( info->fd >= 0 && ! info->error && ! _writev_all(info->fd, buf->iov, buf->iovcnt) )
+            info->error = 1;
+
+        _free_iov(buf->iov, buf->iovcnt);
+        buf->iov = 0;
+        buf->iovcnt = buf->iovcap = 0;
+        buf->len = 0;
+    }
+}
+
+// Opens the file if that hasn't happened yet. Must be called with the lock
+// held.
+static void _open_file(__hlt_file_info* info, hlt_execution_context* ctx)
+{
+    if ( info->fd >= 0 || info->error )
+        return;
+
+    hlt_exception* excpt = 0;
+    char* fn = hlt_string_to_native(info->path, &excpt, ctx);
+
+    if ( excpt ) {
+        GC_DTOR(excpt, hlt_exception, ctx);
+        info->error = 1;
+        return;
+    }
+
+    int oflags = O_CREAT | O_WRONLY | (info->append ? O_APPEND : O_TRUNC);
+    int fd = open(fn, oflags, 0666);
+
+    hlt_free(fn);
+
+    if ( fd < 0 ) {
+        // TODO: We don't have a good way to report errors unfortunately.
+        info->error = 1;
+        return;
+    }
+
+    info->fd = fd;
+}
+
+// Hands a writer's buffered output over for writing. Normally that means
+// sending it to the command queue. With direct writes enabled, and if
+// nobody else has written to the file so far, we write it ourselves
+// instead. Once a second thread shows up, all writes go through the queue
+// again; because the direct ones have completed by then, a thread's writes
+// still reach the file in order.
+static void _flush_buffer(__hlt_file_info* info, int slot, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    __hlt_file_buffer* buf = &info->buffers[slot];
+
+    if ( ! buf->len )
+        return;
+
+    struct iovec* iov = buf->iov;
+    int iovcnt = buf->iovcnt;
+
+    buf->iov = 0;
+    buf->iovcnt = buf->iovcap = 0;
+    buf->len = 0;
+
+    if ( hlt_is_multi_threaded() && hlt_config_get()->file_direct_write ) {
+        int s = 0;
+        acqire_lock(&s);
+
+        if ( info->owner == -1 )
+            info->owner = slot;
+
+        else if ( info->owner != slot )
+            info->owner = -2;
+
+        int direct = (info->owner == slot);
+        int fd = -1;
+
+        if ( direct ) {
+            _open_file(info, ctx);
+            fd = info->error ? -1 : info->fd;
+        }
+
+        release_lock(s);
+
+        if ( direct ) {
+            if ( fd >= 0 && ! _writev_all(fd, iov, iovcnt) )
+                _set_error(info);
+
+            _free_iov(iov, iovcnt);
+            return;
+        }
+    }
+
+    __hlt_cmd_file* cmd = hlt_malloc(sizeof(__hlt_cmd_file));
+    __hlt_cmdqueue_init_cmd((__hlt_cmd*) cmd, __HLT_CMD_FILE);
+    cmd->info = info;
+    cmd->type = 2; // Write.
+    cmd->iov = iov;
+    cmd->iovcnt = iovcnt;
+    __hlt_cmdqueue_push_writer((__hlt_cmd*) cmd, slot, excpt, ctx);
+}
+
+void __hlt_files_flush(int slot, int8_t expired_only, hlt_execution_context* ctx)
+{
+    double now = expired_only ? _current_time() : 0;
+    double interval = hlt_config_get()->file_flush_interval;
+
+    hlt_exception* excpt = 0;
+
+    // Collect first, we can't hold the lock while flushing.
+    int s = 0;
+    acqire_lock(&s);
+
+    int n = 0;
+    __hlt_file_info* info;
+    double pending = 0;
+
+    for ( info = __hlt_globals()->files; info; info = info->next ) {
+        __hlt_file_buffer* buf = &info->buffers[slot];
+
+        if ( ! buf->len )
+            continue;
+
+        if ( ! expired_only || now - buf->first >= interval )
+            ++n;
+
+        else if ( ! pending || buf->first < pending )
+            pending = buf->first;
+    }
+
+    if ( slot == 0 )
+        // Remember when what stays buffered will be due, see
+        // __hlt_files_flush_main().
+        __hlt_globals()->files_main_first = pending;
+
+    __hlt_file_info* infos[n ? n : 1];
+    int i = 0;
+
+    for ( info = __hlt_globals()->files; info && i < n; info = info->next ) {
+        __hlt_file_buffer* buf = &info->buffers[slot];
+
+        if ( buf->len && (! expired_only || now - buf->first >= interval) )
+            infos[i++] = info;
+    }
+
+    release_lock(s);
+
+    for ( i = 0; i < n; i++ )
+        _flush_buffer(infos[i], slot, &excpt, ctx);
+
+    if ( excpt )
+        GC_DTOR(excpt, hlt_exception, ctx);
+}
+
+void __hlt_files_flush_main(hlt_execution_context* ctx)
+{
+    double first = __hlt_globals()->files_main_first;
+
+    if ( ! first || _current_time() - first < hlt_config_get()->file_flush_interval )
+        return;
+
+    __hlt_files_flush(0, 1, ctx);
+}
+
 void __hlt_files_init()
 {
     if ( hlt_is_multi_threaded() && pthread_mutex_init(&__hlt_globals()->files_lock, 0) != 0 )
@@ -88,7 +383,13 @@ void __hlt_files_done()
     __hlt_file_info* info = __hlt_globals()->files;
 
     while ( info ) {
-        close(info->fd);
+        // All writers are gone, so we can write out whatever is left.
+        _write_out_buffers(info);
+
+        if ( info->fd >= 0 )
+            close(info->fd);
+
+        hlt_free(info->buffers);
 
         GC_DTOR(info->path, hlt_string, hlt_global_execution_context());
 
@@ -175,6 +476,9 @@ void hlt_file_open(hlt_file* file, hlt_string path, hlt_enum type, hlt_enum mode
     info->path = hlt_string_copy(path, excpt, ctx);
     info->writers = 1;
     info->error = 0;
+    info->append = hlt_enum_equal(mode, Hilti_FileMode_Append, excpt, ctx);
+    info->owner = -1;
+    info->buffers = hlt_calloc(_num_writer_slots(), sizeof(__hlt_file_buffer));
     info->prev = 0;
     info->next = __hlt_globals()->files;
 
@@ -214,6 +518,10 @@ void hlt_file_close(hlt_file* file, hlt_exception** excpt, hlt_execution_context
         return;
     }
 
+    // Get our pending output out first; others flush theirs on their own
+    // close.
+    _flush_buffer(file->info, _writer_slot(ctx), excpt, ctx);
+
     __hlt_cmd_file* cmd = hlt_malloc(sizeof(__hlt_cmd_file));
     __hlt_cmdqueue_init_cmd((__hlt_cmd*) cmd, __HLT_CMD_FILE);
     cmd->info = file->info;
@@ -238,14 +546,6 @@ void hlt_file_write_string(hlt_file* file, hlt_string str, hlt_exception** excpt
     hlt_file_write_bytes(file, b, excpt, ctx);
 }
 
-static void _add_to_cmd_data(__hlt_cmd_file* cmd, const int8_t* data, int len)
-{
-    int old_len = cmd->len;
-    cmd->len += len;
-    cmd->data = hlt_realloc(cmd->data, cmd->len, old_len);
-    memcpy(cmd->data + old_len, data, len);
-}
-
 void hlt_file_write_bytes(hlt_file* file, hlt_bytes* data, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     if ( ! file->open ) {
@@ -254,12 +554,11 @@ void hlt_file_write_bytes(hlt_file* file, hlt_bytes* data, hlt_exception** excpt
         return;
     }
 
-    __hlt_cmd_file* cmd = hlt_malloc(sizeof(__hlt_cmd_file));
-    __hlt_cmdqueue_init_cmd((__hlt_cmd*) cmd, __HLT_CMD_FILE);
-    cmd->info = file->info;
-    cmd->type = 2; // Write.
-    cmd->data = 0;
-    cmd->len = 0;
+    // We append to our thread's buffer, which only we access. As one
+    // write's data is never split across flushes, each write still goes
+    // out in one piece.
+    int slot = _writer_slot(ctx);
+    __hlt_file_buffer* out = &file->info->buffers[slot];
 
     hlt_bytes_block block;
     hlt_iterator_bytes start = hlt_bytes_begin(data, excpt, ctx);
@@ -287,12 +586,12 @@ void hlt_file_write_bytes(hlt_file* file, hlt_bytes* data, hlt_exception** excpt
                     ++e;
 
                 if ( e != s )
-                    _add_to_cmd_data(cmd, s, e - s);
+                    _buffer_append(out, s, e - s);
 
                 if ( e < block.end ) {
                     // Unprintable character.
                     int n = hlt_util_uitoa_n(*e, (char*)buf + 2, 3, 16, 1);
-                    _add_to_cmd_data(cmd, buf, n + 2);
+                    _buffer_append(out, buf, n + 2);
                     ++e;
                 }
 
@@ -302,7 +601,7 @@ void hlt_file_write_bytes(hlt_file* file, hlt_bytes* data, hlt_exception** excpt
 
         else if ( hlt_enum_equal(file->type, Hilti_FileType_Binary, excpt, ctx) )
             // Just write data directly.
-            _add_to_cmd_data(cmd, block.start, block.end - block.start);
+            _buffer_append(out, block.start, block.end - block.start);
 
         else
             fatal_error("unknown file type");
@@ -312,9 +611,17 @@ void hlt_file_write_bytes(hlt_file* file, hlt_bytes* data, hlt_exception** excpt
     }
 
     if ( hlt_enum_equal(file->type, Hilti_FileType_Text, excpt, ctx) )
-        _add_to_cmd_data(cmd, (int8_t*)"\n", 1);
+        _buffer_append(out, (int8_t*)"\n", 1);
 
-    __hlt_cmdqueue_push((__hlt_cmd*) cmd, excpt, ctx);
+    if ( slot == 0 && ! __hlt_globals()->files_main_first )
+        // The main thread has no idle loop checking for expired output, see
+        // __hlt_files_flush_main().
+        __hlt_globals()->files_main_first = out->first;
+
+    const hlt_config* cfg = hlt_config_get();
+
+    if ( out->len >= cfg->file_buffer_size || _current_time() - out->first >= cfg->file_flush_interval )
+        _flush_buffer(file->info, slot, excpt, ctx);
 }
 
 void __hlt_file_cmd_internal(__hlt_cmd* c, hlt_execution_context* ctx)
@@ -325,74 +632,45 @@ void __hlt_file_cmd_internal(__hlt_cmd* c, hlt_execution_context* ctx)
     switch ( cmd->type ) {
 
      case 1: {
-         if ( cmd->info->error )
-             return;
-
-         // Open command.
+         // Open command. The file may already be open if a direct writer
+         // got to it first.
          int s = 0;
          acqire_lock(&s);
-
-         if ( cmd->info->fd < 0 ) {
-             // Not open yet.
-
-             hlt_exception* excpt = 0;
-             char* fn = hlt_string_to_native(cmd->info->path, &excpt, ctx);
-             if ( excpt ) {
-                 release_lock(s);
-                 break;
-             }
-
-             int8_t append = hlt_enum_equal(cmd->param_mode, Hilti_FileMode_Append, &excpt, ctx);
-             int oflags = O_CREAT | O_WRONLY | (append ? O_APPEND : O_TRUNC);
-             int fd = open(fn, oflags, 0666);
-
-             hlt_free(fn);
-
-             if ( fd < 0 ) {
-                 cmd->info->error = 1;
-                 // TODO: We don't have a good way to report errors unfortunately.
-                 release_lock(s);
-                 return;
-             }
-
-             cmd->info->fd = fd;
-         }
-
+         _open_file(cmd->info, ctx);
          release_lock(s);
          break;
 
       case 2: {
           // Write comment.
 
-          if ( cmd->info->fd < 0 )
-              return;
-
-          if ( cmd->info->error )
-              return;
-
-          if ( cmd->len ) {
-              if ( ! __hlt_safe_write(cmd->info->fd, cmd->data, cmd->len) )
-                  cmd->info->error = 1;
+          // A direct writer may have opened the file.
+          int s = 0;
+          acqire_lock(&s);
+          int fd = cmd->info->error ? -1 : cmd->info->fd;
+          release_lock(s);
 
-              hlt_free(cmd->data);
-          }
+          if ( fd >= 0 && ! _writev_all(fd, cmd->iov, cmd->iovcnt) )
+              _set_error(cmd->info);
 
+          _free_iov(cmd->iov, cmd->iovcnt);
           break;
       }
 
       case 3: {
           // Close command.
 
-          if ( cmd->info->fd < 0 )
-              return;
-
           int s = 0;
           acqire_lock(&s);
 
           assert(cmd->info->writers);
 
           if ( --cmd->info->writers == 0 ) {
-              close(cmd->info->fd);
+              // Other writers may still have output buffered that they
+              // never got to flush.
+              _write_out_buffers(cmd->info);
+
+              if ( cmd->info->fd >= 0 )
+                  close(cmd->info->fd);
 
               // Delete from list.
               __hlt_file_info* cur;
@@ -415,6 +693,7 @@ void __hlt_file_cmd_internal(__hlt_cmd* c, hlt_execution_context* ctx)
                   fatal_error("file to close not found");
 
               GC_DTOR(cmd->info->path, hlt_string, hlt_global_execution_context());
+              hlt_free(cmd->info->buffers);
               hlt_free(cmd->info);
 
               cmd->info = 0;
@@ -5,8 +5,13 @@
 /// Functions for manipulating file objects. File are explicitly thread-safe.
 /// Writing to the same file from multiple threads is well-defined.
 ///
-/// Internally, we push all writes into the internal command queue, and the
-/// queue manager performs the actual output.
+/// Internally, each thread buffers its writes per file, and pushes them
+/// into the internal command queue once the buffer fills up or has been
+/// sitting for a while (see hlt_config::file_buffer_size and
+/// hlt_config::file_flush_interval). The queue manager then performs the
+/// actual output. Writes from the same thread reach a file in order.
+/// Optionally, a thread that is the only one writing to a file may do so
+/// directly, bypassing the queue (see hlt_config::file_direct_write).
 ///
 /// Note: For now, we only do output. Long-term, we could look into input via
 /// a specialized IOSource.
@@ -133,6 +138,20 @@ void __hlt_files_init();
 // clean up.
 void __hlt_files_done();
 
+// Internal function that hands the output buffered by one writer thread
+// over for writing. The main thread is writer 0, and worker threads are
+// numbered by their IDs. If expired_only is true, only buffers older than
+// hlt_config::file_flush_interval are flushed. Must be called only from the
+// thread corresponding to the writer.
+void __hlt_files_flush(int writer, int8_t expired_only, hlt_execution_context* ctx);
+
+// Internal function that flushes the main thread's buffered output if it
+// has been sitting longer than hlt_config::file_flush_interval. Unlike the
+// workers, the main thread has no idle loop doing that, so the runtime calls
+// this from the main thread's regular entry points. Must be called only from
+// the main thread.
+void __hlt_files_flush_main(hlt_execution_context* ctx);
+
 typedef struct __hlt_cmd_write __hlt_cmd_write;
 
 // Internal function to perform the actual write from the queue manager. This
@@ -5,6 +5,7 @@
 #include "context.h"
 #include "globals.h"
 #include "config.h"
+#include "hutil.h"
 
 static __hlt_global_state  our_globals;
 static __hlt_global_state* globals = 0;
@@ -21,7 +22,10 @@ void __hlt_global_state_init(int init)
     if ( globals_initialized || ! init )
         return;
 
-    globals->context = __hlt_execution_context_new_ref(HLT_VID_MAIN, 1);
+    // Must come before anything can hash.
+    __hlt_hash_init();
+
+    globals->context = __hlt_execution_context_new_ref(HLT_VID_MAIN, 0, 1);
     globals->multi_threaded = (__hlt_globals()->config->num_workers != 0);
 
     __hlt_debug_init();
@@ -51,6 +51,7 @@ struct __hlt_global_state {
     // file.c
     __hlt_file_info* files;
     pthread_mutex_t files_lock; // Lock to protect access to files.
+    double files_main_first;    // Time the main thread's oldest buffered file output was written, or 0 if none.
 
     // profile.c
     int8_t profiling_enabled;
@@ -60,6 +61,9 @@ struct __hlt_global_state {
     // timer.c
     _Atomic(uint_fast64_t) global_time;
 
+    // util.c
+    uint64_t hash_key[2]; // Key for hlt_hash_bytes().
+
     // fiber.c
     __hlt_fiber_pool* synced_fiber_pool; // Global fiber pool.
     pthread_mutex_t synced_fiber_pool_lock; // Lock to protect access to pool.
@@ -16,6 +16,11 @@ typedef struct __hlt_hook_state hlt_hook_state;
 /// group: The group which's state to set.
 ///
 /// enabled: 0 to disable that group, 1 to enable.
+///
+/// Note: When optimizing, the HILTI linker removes the group checks for all
+/// groups that no HILTI code disables. Calling this function from C to
+/// disable a group that HILTI code never disables itself hence requires
+/// turning off the \c hooks optimization.
 extern void hlt_hook_group_enable(int64_t group, int8_t enabled, hlt_exception** excpt, hlt_execution_context* ctx);
 
 /// Returns the current state of a hook group. If no hook function has that group, the function return "disabled".
@@ -107,17 +107,55 @@ extern uint64_t hlt_flip64(uint64_t v);
 /// Returns: The hash value.
 extern hlt_hash hlt_hash_object(const hlt_type_info* type, const void* obj, int32_t options, hlt_exception** excpt, hlt_execution_context* ctx);
 
-/// Calculates a hash value for a sequence of bytes.
+/// State for hashing data incrementally, see hlt_hash_bytes_begin().
+typedef struct {
+    uint64_t v0, v1, v2, v3; // Internal hash state.
+    uint64_t tail;           // Bytes pending from an incomplete word.
+    uint64_t len;            // Total number of bytes hashed so far.
+} hlt_hash_state;
+
+/// Calculates a hash value for a sequence of bytes. The hash function is
+/// keyed with a per-process random seed (see hlt_config::hash_seed), so
+/// that external input cannot predict which values will collide.
+///
+/// s: The bytes.
+///
+/// len: The number of bytes to include, starting at *s*.
+///
+/// prev_hash: A value to mix into the hash, like the hash of a previous
+/// element when combining several into one. Set to zero if none. Note that
+/// chaining calls this way does not yield the same value as hashing all the
+/// data at once; use hlt_hash_bytes_begin() et al. for that.
+///
+/// Returns: The hash value.
+extern hlt_hash hlt_hash_bytes(const int8_t *s, uint64_t len, hlt_hash prev_hash);
+
+/// Starts hashing data incrementally. Feeding the same bytes into
+/// hlt_hash_bytes_update(), no matter how they are split up, yields the
+/// same value as hlt_hash_bytes() with a *prev_hash* of zero.
+///
+/// state: The state to initialize.
+extern void hlt_hash_bytes_begin(hlt_hash_state* state);
+
+/// Adds the next chunk of data to an incremental hash.
+///
+/// state: The state initialized with hlt_hash_bytes_begin().
 ///
 /// s: The bytes.
 ///
 /// len: The number of bytes to include, starting at *s*.
+extern void hlt_hash_bytes_update(hlt_hash_state* state, const int8_t* s, uint64_t len);
+
+/// Finishes an incremental hash.
 ///
-/// prev_hash: To use the hash incrementally on subsequent chunks of data,
-/// pass the previous value here. Set to zero on initial call.
+/// state: The state initialized with hlt_hash_bytes_begin().
 ///
 /// Returns: The hash value.
-extern hlt_hash hlt_hash_bytes(const int8_t *s, int16_t len, hlt_hash prev_hash);
+extern hlt_hash hlt_hash_bytes_end(hlt_hash_state* state);
+
+/// Initializes the hash key from hlt_config::hash_seed. The function is
+/// called from hlt_init().
+extern void __hlt_hash_init();
 
 /// Default hash function hashing a value by value.
 extern hlt_hash hlt_default_hash(const hlt_type_info* type, const void* obj, hlt_exception** excpt, hlt_execution_context* ctx);
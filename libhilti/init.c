@@ -11,6 +11,7 @@
 #include "hook.h"
 #include "threading.h"
 #include "profiler.h"
+#include "pgo.h"
 #include "init.h"
 #include "linker.h"
 #include "exceptions.h"
@@ -40,6 +41,7 @@ void __hlt_done()
 
     hlt_exception* excpt = 0;
 
+    __hlt_pgo_done();
     __hlt_global_state_done();
 }
 
@@ -1,7 +1,28 @@
 
 #include <pcap.h>
 
+#ifdef __linux__
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+
+#ifdef TPACKET3_HDRLEN
+#define HLT_HAVE_PACKET_RING
+#endif
+#endif
+
 #include "iosrc.h"
+#include "vector.h"
 #include "autogen/hilti-hlt.h"
 
 typedef struct  {
@@ -76,9 +97,399 @@ static void _strip_link_layer(hlt_iosrc* src, const char** pkt, int* caplen, int
     *caplen -= hdr_size;
 }
 
+static inline int _is_ring(hlt_iosrc* src)
+{
+    return hlt_enum_equal(src->type, Hilti_IOSrc_PacketRing, 0, 0);
+}
+
+#ifdef HLT_HAVE_PACKET_RING
+
+// Size and number of the ring's blocks. The kernel hands us complete
+// blocks, which we then process as a batch.
+static const unsigned int _RingBlockSize = 1 << 20;
+static const unsigned int _RingBlockCount = 64;
+static const unsigned int _RingFrameSize = 2048;
+
+// Time after which the kernel passes on a block even if not full, in msecs.
+static const unsigned int _RingBlockTimeout = 10;
+
+// Number of blocks we may hold on to before we copy out packets still in
+// use, rather than waiting for them to go away.
+static const unsigned int _RingMaxOwned = 32;
+
+typedef struct {
+    hlt_bytes** pkts;          // The bytes objects handed out for the block's packets. Entries get cleared once they let go of the ring.
+    uint32_t len;              // The number of entries in pkts.
+    uint32_t cap;              // The number of entries allocated for pkts.
+} __hlt_iosrc_ring_block;
+
+typedef struct {
+    int fd;                    // The AF_PACKET socket.
+    int datalink;              // The DLT_* type of the interface, or -1 if we don't know it.
+    uint8_t* map;              // The memory-mapped ring.
+    size_t map_size;           // The size of the mapping.
+    unsigned int first;        // The index of the oldest block we own.
+    unsigned int owned;        // The number of blocks we own, starting with first.
+    int8_t held;               // True if we are reading packets from the newest block we own.
+    uint32_t left;             // The number of packets left to return from the current block.
+    struct tpacket3_hdr* next; // The next packet to return from the current block.
+    __hlt_iosrc_ring_block* blocks; // Per-block state, indexed like the ring.
+} __hlt_iosrc_ring;
+
+static inline struct tpacket_block_desc* _ring_block(__hlt_iosrc_ring* r, unsigned int i)
+{
+    return (struct tpacket_block_desc*)(r->map + (size_t)i * _RingBlockSize);
+}
+
+// Returns the index of the block we're reading from. Only valid if held.
+static inline unsigned int _ring_cur(__hlt_iosrc_ring* r)
+{
+    return (r->first + r->owned - 1) % _RingBlockCount;
+}
+
+// Returns true if none of the block's packets is in use anymore. If copy is
+// true, packets still in use get their own copy of the data first, except
+// for those that iterators point into.
+static int _ring_block_unused(__hlt_iosrc_ring_block* b, int8_t copy, hlt_execution_context* ctx)
+{
+    int unused = 1;
+
+    for ( uint32_t i = 0; i < b->len; i++ ) {
+        if ( ! b->pkts[i] )
+            continue;
+
+        if ( copy && __hlt_bytes_detach(b->pkts[i], ctx) )
+            continue;
+
+        unused = 0;
+    }
+
+    return unused;
+}
+
+// Returns blocks we're done with to the kernel, oldest first, once their
+// packets have gone away. If we hold on to too many, we don't wait for
+// that but copy out the packets still in use.
+static void _ring_recycle(__hlt_iosrc_ring* r, hlt_execution_context* ctx)
+{
+    while ( r->owned > (r->held ? 1 : 0) ) {
+        __hlt_iosrc_ring_block* b = &r->blocks[r->first];
+
+        if ( ! _ring_block_unused(b, r->owned >= _RingMaxOwned, ctx) )
+            break;
+
+        b->len = 0;
+
+        __sync_synchronize();
+        _ring_block(r, r->first)->hdr.bh1.block_status = TP_STATUS_KERNEL;
+        r->first = (r->first + 1) % _RingBlockCount;
+        --r->owned;
+    }
+}
+
+// Returns true if the block we'd move to next is ready for us, waiting
+// briefly if it isn't yet.
+static int _ring_ready(__hlt_iosrc_ring* r, hlt_execution_context* ctx)
+{
+    _ring_recycle(r, ctx);
+
+    if ( r->owned == _RingBlockCount )
+        // The next one is still ours.
+        return 0;
+
+    unsigned int i = (r->first + r->owned) % _RingBlockCount;
+    struct tpacket_block_desc* bd = _ring_block(r, i);
+
+    if ( bd->hdr.bh1.block_status & TP_STATUS_USER )
+        return 1;
+
+    // Same timeout as for pcap live sources.
+    struct pollfd pfd = { r->fd, POLLIN | POLLERR, 0 };
+    poll(&pfd, 1, 1);
+
+    return (bd->hdr.bh1.block_status & TP_STATUS_USER) != 0;
+}
+
+// Stops reading from the current block. We keep owning it until
+// _ring_recycle() returns it to the kernel.
+static void _ring_release(__hlt_iosrc_ring* r, hlt_execution_context* ctx)
+{
+    r->left = 0;
+    r->next = 0;
+    r->held = 0;
+}
+
+// Moves on to the next block. Returns false if there's none available yet.
+static int _ring_acquire(__hlt_iosrc_ring* r, hlt_execution_context* ctx)
+{
+    if ( ! _ring_ready(r, ctx) )
+        return 0;
+
+    _ring_release(r, ctx);
+
+    __sync_synchronize();
+
+    unsigned int i = (r->first + r->owned) % _RingBlockCount;
+    struct tpacket_block_desc* bd = _ring_block(r, i);
+    uint32_t num = bd->hdr.bh1.num_pkts;
+
+    r->owned++;
+    r->held = 1;
+    r->left = num;
+    r->next = (struct tpacket3_hdr*)((uint8_t*)bd + bd->hdr.bh1.offset_to_first_pkt);
+
+    // Nothing points into the array anymore, so we can move it.
+    __hlt_iosrc_ring_block* b = &r->blocks[i];
+
+    if ( num > b->cap ) {
+        b->pkts = hlt_realloc(b->pkts, num * sizeof(hlt_bytes*), b->cap * sizeof(hlt_bytes*));
+        b->cap = num;
+    }
+
+    if ( ! num ) {
+        _ring_release(r, ctx);
+        _ring_recycle(r, ctx);
+        return 0;
+    }
+
+    return 1;
+}
+
+// Wraps a packet from the current block into a bytes object without
+// copying it. The block stays with us until the object has let go of it.
+static hlt_bytes* _ring_bytes(__hlt_iosrc_ring* r, const u_char* data, int caplen, hlt_execution_context* ctx)
+{
+    __hlt_iosrc_ring_block* b = &r->blocks[_ring_cur(r)];
+    return __hlt_bytes_new_external((const int8_t*)data, caplen, &b->pkts[b->len++], ctx);
+}
+
+static int _ring_read_next(hlt_iosrc* src, int8_t keep_link_layer, hlt_time* t, const u_char** data, int* caplen, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    __hlt_iosrc_ring* r = src->handle;
+
+    if ( ! r->left && ! _ring_acquire(r, ctx) )
+        return 0;
+
+    struct tpacket3_hdr* hdr = r->next;
+
+    r->next = (struct tpacket3_hdr*)((uint8_t*)hdr + hdr->tp_next_offset);
+    --r->left;
+
+    *data = (const u_char*)hdr + hdr->tp_mac;
+    *caplen = hdr->tp_snaplen;
+
+    if ( ! keep_link_layer ) {
+        _strip_link_layer(src, (const char**)data, caplen, r->datalink, excpt, ctx);
+        if ( hlt_check_exception(excpt) )
+            return -2;
+    }
+
+    *t = hlt_time_value(hdr->tp_sec, hdr->tp_nsec);
+    return 1;
+}
+
+static int64_t _ring_read_batch(hlt_iosrc* src, hlt_vector* pkts, int64_t max, int8_t keep_link_layer, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    __hlt_iosrc_ring* r = src->handle;
+
+    if ( ! r->left && ! _ring_ready(r, ctx) ) {
+        hlt_set_exception(excpt, &hlt_exception_would_block, 0, ctx);
+        return 0;
+    }
+
+    // Drop the previous batch, so that its block can go back to the kernel
+    // once nothing else holds on to the packets.
+    __hlt_vector_resize(pkts, 0, excpt, ctx);
+
+    if ( ! r->left && ! _ring_acquire(r, ctx) ) {
+        hlt_set_exception(excpt, &hlt_exception_would_block, 0, ctx);
+        return 0;
+    }
+
+    hlt_vector_reserve(pkts, max < r->left ? max : r->left, excpt, ctx);
+
+    // We don't move on to the next block here, so that a batch never spans
+    // two.
+    int64_t n = 0;
+
+    while ( n < max && r->left ) {
+        hlt_time t;
+        const u_char* data;
+        int caplen;
+
+        if ( _ring_read_next(src, keep_link_layer, &t, &data, &caplen, excpt, ctx) != 1 )
+            break;
+
+        __hlt_vector_resize(pkts, n + 1, excpt, ctx);
+
+        hlt_packet* pkt = (hlt_packet*) hlt_vector_get(pkts, n, excpt, ctx);
+        hlt_bytes* b = _ring_bytes(r, data, caplen, ctx);
+        GC_ASSIGN(pkt->data, b, hlt_bytes, ctx);
+        pkt->t = t;
+        ++n;
+    }
+
+    return n;
+}
+
+static void _ring_close(hlt_iosrc* src, hlt_execution_context* ctx)
+{
+    __hlt_iosrc_ring* r = src->handle;
+
+    if ( ! r )
+        return;
+
+    _ring_release(r, ctx);
+
+    // Packets outliving the source get their own copy of the data. If
+    // iterators point into some, we leave the ring mapped for them; the
+    // kernel doesn't write into blocks we haven't returned.
+    int8_t keep_map = 0;
+
+    for ( unsigned int i = 0; i < r->owned; i++ ) {
+        __hlt_iosrc_ring_block* b = &r->blocks[(r->first + i) % _RingBlockCount];
+
+        for ( uint32_t j = 0; j < b->len; j++ ) {
+            if ( b->pkts[j] && ! __hlt_bytes_detach(b->pkts[j], ctx) ) {
+                __hlt_bytes_abandon(b->pkts[j], ctx);
+                keep_map = 1;
+            }
+        }
+    }
+
+    if ( r->map && ! keep_map )
+        munmap(r->map, r->map_size);
+
+    if ( r->fd >= 0 )
+        close(r->fd);
+
+    for ( unsigned int i = 0; i < _RingBlockCount; i++ )
+        hlt_free(r->blocks[i].pkts);
+
+    hlt_free(r->blocks);
+    hlt_free(r);
+    src->handle = 0;
+}
+
+static int _ring_datalink(int fd, const char* iface)
+{
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, iface, sizeof(ifr.ifr_name) - 1);
+
+    if ( ioctl(fd, SIOCGIFHWADDR, &ifr) < 0 )
+        return -1;
+
+    switch ( ifr.ifr_hwaddr.sa_family ) {
+     case ARPHRD_ETHER:
+     case ARPHRD_LOOPBACK:
+        return DLT_EN10MB;
+
+     case ARPHRD_NONE:
+        return DLT_RAW;
+
+     default:
+        return -1;
+    }
+}
+
+static int _ring_open(__hlt_iosrc_ring* r, const char* iface, int fanout)
+{
+    int ifindex = if_nametoindex(iface);
+
+    if ( ! ifindex ) {
+        errno = ENODEV;
+        return 0;
+    }
+
+    r->fd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+
+    if ( r->fd < 0 )
+        return 0;
+
+    int version = TPACKET_V3;
+
+    if ( setsockopt(r->fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0 )
+        return 0;
+
+    struct tpacket_req3 req;
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = _RingBlockSize;
+    req.tp_block_nr = _RingBlockCount;
+    req.tp_frame_size = _RingFrameSize;
+    req.tp_frame_nr = (_RingBlockSize * _RingBlockCount) / _RingFrameSize;
+    req.tp_retire_blk_tov = _RingBlockTimeout;
+
+    if ( setsockopt(r->fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0 )
+        return 0;
+
+    r->map_size = (size_t)_RingBlockSize * _RingBlockCount;
+    r->map = mmap(0, r->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, r->fd, 0);
+
+    if ( r->map == MAP_FAILED ) {
+        r->map = 0;
+        return 0;
+    }
+
+    struct sockaddr_ll addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sll_family = AF_PACKET;
+    addr.sll_protocol = htons(ETH_P_ALL);
+    addr.sll_ifindex = ifindex;
+
+    if ( bind(r->fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 )
+        return 0;
+
+    struct packet_mreq mreq;
+    memset(&mreq, 0, sizeof(mreq));
+    mreq.mr_ifindex = ifindex;
+    mreq.mr_type = PACKET_MR_PROMISC;
+
+    if ( setsockopt(r->fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0 )
+        return 0;
+
+    if ( fanout >= 0 ) {
+        // All sockets joining the same group share the interface's
+        // traffic, with all packets of a flow going to the same socket.
+        int arg = (fanout & 0xffff) | (PACKET_FANOUT_HASH << 16);
+
+        if ( setsockopt(r->fd, SOL_PACKET, PACKET_FANOUT, &arg, sizeof(arg)) < 0 )
+            return 0;
+    }
+
+    r->datalink = _ring_datalink(r->fd, iface);
+    return 1;
+}
+
+#else
+
+static int _ring_read_next(hlt_iosrc* src, int8_t keep_link_layer, hlt_time* t, const u_char** data, int* caplen, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    return -2;
+}
+
+static int64_t _ring_read_batch(hlt_iosrc* src, hlt_vector* pkts, int64_t max, int8_t keep_link_layer, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    return 0;
+}
+
+static hlt_bytes* _ring_bytes(void* r, const u_char* data, int caplen, hlt_execution_context* ctx)
+{
+    return 0;
+}
+
+static void _ring_close(hlt_iosrc* src, hlt_execution_context* ctx)
+{
+}
+
+#endif
+
 void hlt_iosrc_dtor(hlt_type_info* ti, hlt_iosrc* c, hlt_execution_context* ctx)
 {
-    if ( c->handle )
+    if ( _is_ring(c) )
+        _ring_close(c, ctx);
+
+    else if ( c->handle )
         pcap_close(c->handle);
 
     GC_CLEAR(c->iface, hlt_string, ctx);
@@ -91,7 +502,8 @@ hlt_string hlt_iosrc_to_string(const hlt_type_info* type, const void* obj, int32
     if ( ! src )
         return hlt_string_from_asciiz("(Null)", excpt, ctx);
 
-    hlt_string prefix = hlt_string_from_asciiz("<pcap source ", excpt, ctx);
+    const char* kind = _is_ring((hlt_iosrc*)src) ? "<packet ring " : "<pcap source ";
+    hlt_string prefix = hlt_string_from_asciiz(kind, excpt, ctx);
     hlt_string postfix = hlt_string_from_asciiz(">", excpt, ctx);
 
     hlt_string str = hlt_string_concat(prefix, src->iface, excpt, ctx);
@@ -170,64 +582,207 @@ hlt_iosrc* hlt_iosrc_new_offline(hlt_string interface, hlt_exception** excpt, hl
     return src;
 }
 
-hlt_packet hlt_iosrc_read_try(hlt_iosrc* src, int8_t keep_link_layer, hlt_exception** excpt, hlt_execution_context* ctx)
+hlt_iosrc* hlt_iosrc_new_ring(hlt_string interface, hlt_exception** excpt, hlt_execution_context* ctx)
 {
-    hlt_packet result = { 0.0, NULL };
+    hlt_iosrc* src = GC_NEW(hlt_iosrc, ctx);
+    src->type = Hilti_IOSrc_PacketRing;
+    src->iface = hlt_string_copy(interface, excpt, ctx);
+    GC_CCTOR(src->iface, hlt_string, ctx);
+
+#ifdef HLT_HAVE_PACKET_RING
+    char* iface = hlt_string_to_native(interface, excpt, ctx);
+    if ( hlt_check_exception(excpt) )
+        return 0;
+
+    // A trailing "@<group>" selects the fanout group to join.
+    int fanout = -1;
+    char* at = strrchr(iface, '@');
+
+    if ( at ) {
+        *at = '\0';
+        fanout = atoi(at + 1);
+    }
+
+    __hlt_iosrc_ring* r = hlt_malloc(sizeof(__hlt_iosrc_ring));
+    r->fd = -1;
+    r->blocks = hlt_malloc(_RingBlockCount * sizeof(__hlt_iosrc_ring_block));
+    src->handle = r;
+
+    int ok = _ring_open(r, iface, fanout);
+
+    hlt_free(iface);
 
+    if ( ! ok ) {
+        _raise_error(src, strerror(errno), excpt, ctx);
+        _ring_close(src, ctx);
+        return 0;
+    }
+
+    // Up and running.
+    return src;
+#else
+    _raise_error(src, "packet rings are not supported on this platform", excpt, ctx);
+    return 0;
+#endif
+}
+
+// Reads the next packet from the source. Returns 1 if we got one, 0 if
+// there's none available right now, -1 if the source is exhausted, and -2
+// if an exception has been raised. The returned data remains valid only
+// until the next call for pcap sources, and until the block is released
+// for packet rings.
+static int _read_next(hlt_iosrc* src, int8_t keep_link_layer, hlt_time* t, const u_char** data, int* caplen, hlt_exception** excpt, hlt_execution_context* ctx)
+{
     if ( ! src->handle ) {
         _raise_error(src, "already closed", excpt, ctx);
-        return result;
+        return -2;
     }
 
+    if ( _is_ring(src) )
+        return _ring_read_next(src, keep_link_layer, t, data, caplen, excpt, ctx);
+
     struct pcap_pkthdr* hdr;
-    const u_char* data;
 
-    int rc = pcap_next_ex(src->handle, &hdr, &data);
-    int caplen = hdr->caplen;
+    int rc = pcap_next_ex(src->handle, &hdr, data);
 
     if ( rc > 0 ) {
         // Got a packet.
+        *caplen = hdr->caplen;
+
         if ( ! keep_link_layer ) {
-            _strip_link_layer(src, (const char**)&data, &caplen, pcap_datalink(src->handle), excpt, ctx);
+            _strip_link_layer(src, (const char**)data, caplen, pcap_datalink(src->handle), excpt, ctx);
             if ( hlt_check_exception(excpt) )
-                return result;
+                return -2;
         }
 
-        // We need to copy it to make sure it remains valid.
-        hlt_bytes* pkt = hlt_bytes_new_from_data_copy((const int8_t*)data, caplen, excpt, ctx);
-        if ( hlt_check_exception(excpt) )
-            return result;
-
-        // Build the result tuple.
-        result.t = hlt_time_value(hdr->ts.tv_sec, hdr->ts.tv_usec * 1000);
-        result.data = pkt;
-
-        return result;
+        *t = hlt_time_value(hdr->ts.tv_sec, hdr->ts.tv_usec * 1000);
+        return 1;
     }
 
-    if ( rc == -2 ) {
+    if ( rc == -2 )
         // No more packets.
-        return result;
-    }
+        return -1;
 
     if ( rc < 0 ) {
         // Error.
         _raise_error(src, 0, excpt, ctx);
         pcap_close(src->handle);
         src->handle = 0;
-        return result;
+        return -2;
     }
 
     // Don't think we can get here when reading from a trace ...
     assert(! hlt_enum_equal(src->type, Hilti_IOSrc_PcapOffline, excpt, ctx));
 
     // No packet this time.
-    hlt_set_exception(excpt, &hlt_exception_would_block, 0, ctx);
-    return result;
+    return 0;
+}
+
+hlt_packet hlt_iosrc_read_try(hlt_iosrc* src, int8_t keep_link_layer, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    hlt_packet result = { 0.0, NULL };
+
+    hlt_time t;
+    const u_char* data;
+    int caplen;
+
+    switch ( _read_next(src, keep_link_layer, &t, &data, &caplen, excpt, ctx) ) {
+     case 1: {
+        hlt_bytes* pkt = 0;
+
+        if ( _is_ring(src) )
+            // The ring keeps the data valid for as long as we need it.
+            pkt = _ring_bytes(src->handle, data, caplen, ctx);
+
+        else {
+            // We need to copy it to make sure it remains valid.
+            pkt = hlt_bytes_new_from_data_copy((const int8_t*)data, caplen, excpt, ctx);
+            if ( hlt_check_exception(excpt) )
+                return result;
+        }
+
+        // Build the result tuple.
+        result.t = t;
+        result.data = pkt;
+        return result;
+     }
+
+     case 0:
+        hlt_set_exception(excpt, &hlt_exception_would_block, 0, ctx);
+        return result;
+
+     default:
+        // Exhausted or error.
+        return result;
+    }
+}
+
+int64_t hlt_iosrc_read_batch_try(hlt_iosrc* src, hlt_vector* pkts, int64_t max, int8_t keep_link_layer, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    if ( max <= 0 ) {
+        hlt_set_exception(excpt, &hlt_exception_value_error, 0, ctx);
+        return 0;
+    }
+
+    if ( ! src->handle ) {
+        _raise_error(src, "already closed", excpt, ctx);
+        return 0;
+    }
+
+    if ( _is_ring(src) )
+        return _ring_read_batch(src, pkts, max, keep_link_layer, excpt, ctx);
+
+    hlt_vector_idx size = hlt_vector_size(pkts, excpt, ctx);
+    int64_t n = 0;
+    int rc = 0;
+
+    hlt_vector_reserve(pkts, max, excpt, ctx);
+
+    while ( n < max ) {
+        hlt_time t;
+        const u_char* data;
+        int caplen;
+
+        rc = _read_next(src, keep_link_layer, &t, &data, &caplen, excpt, ctx);
+
+        if ( rc != 1 )
+            break;
+
+        if ( n >= size ) {
+            __hlt_vector_resize(pkts, n + 1, excpt, ctx);
+            size = n + 1;
+        }
+
+        hlt_packet* pkt = (hlt_packet*) hlt_vector_get(pkts, n, excpt, ctx);
+
+        // We can't reuse the previous batch's buffer: the caller may still
+        // be looking at it through a local, which doesn't hold a reference.
+        hlt_bytes* b = hlt_bytes_new_from_data_copy((const int8_t*)data, caplen, excpt, ctx);
+        GC_ASSIGN(pkt->data, b, hlt_bytes, ctx);
+
+        pkt->t = t;
+        ++n;
+    }
+
+    if ( rc == 0 && n == 0 ) {
+        // Leave the vector alone, as documented.
+        hlt_set_exception(excpt, &hlt_exception_would_block, 0, ctx);
+        return 0;
+    }
+
+    if ( n < size )
+        __hlt_vector_resize(pkts, n, excpt, ctx);
+
+    return n;
 }
 
 void hlt_iosrc_close(hlt_iosrc* src, hlt_exception** excpt, hlt_execution_context* ctx)
 {
+    if ( _is_ring(src) ) {
+        _ring_close(src, ctx);
+        return;
+    }
+
     pcap_close(src->handle);
     src->handle = 0;
 }
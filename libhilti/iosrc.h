@@ -6,8 +6,8 @@
 // external input/output (well, input only at the moment). Each I/O source
 // implements a similar interface.
 //
-// For now, we online provide one implementation for libpcap input. More to
-// come.
+// For now, we provide implementations for libpcap input and, on Linux, for
+// reading from an AF_PACKET ring buffer. More to come.
 //
 // Todo: This interface is quite preliminary; we'll need to refine it when we
 // add more sources. For example, we probably want some kind of dispatcher
@@ -23,13 +23,14 @@
 #include "enum.h"
 #include "time_.h"
 #include "bytes.h"
+#include "vector.h"
 
 /// The type of an IOSource as one of the Hilti::IOSrc constants.
 typedef hlt_enum hlt_iosrc_type;
 
 struct __hlt_iosrc {
     __hlt_gchdr __gchdr;    // Header for memory management.
-    hlt_iosrc_type type;  // Hilti_PktSrc_PcapLive or Hilti_PktSrc_PcapOffline.
+    hlt_iosrc_type type;  // Hilti_IOSrc_PcapLive, Hilti_IOSrc_PcapOffline, or Hilti_IOSrc_PacketRing.
     hlt_string iface;     // The name of the interface.
     void* handle;         // A kind-specific handle.
 };
@@ -60,6 +61,24 @@ extern hlt_iosrc* hlt_iosrc_new_live(hlt_string interface, hlt_exception** excpt
 /// Raises: IOError if there is a problem opening the the interface for monitoring.
 extern hlt_iosrc* hlt_iosrc_new_offline(hlt_string interface, hlt_exception** excpt, hlt_execution_context* ctx);
 
+/// Creates a new packet source reading from a Linux TPACKET_V3 ring buffer.
+/// The kernel stores packets directly into memory shared with us, and we
+/// pass them on without copying. The source processes the ring block by
+/// block, and returns a block to the kernel once none of its packets is in
+/// use anymore. If we hold on to too many blocks, packets still in use
+/// receive their own copy of the data, except for those that iterators
+/// point into, as iterators can't follow the data moving.
+///
+/// interface: The name of the interface, which will be put into
+/// promiscious mode. If the name is followed by ``@<n>``, the source joins
+/// the fanout group with ID *n*. The kernel then load-balances the
+/// interface's traffic across all sources of the group by flow, so opening
+/// one source per virtual thread spreads the capture across cores.
+///
+/// Raises: IOError if there is a problem opening the the interface for
+/// monitoring, or if the platform doesn't support packet rings.
+extern hlt_iosrc* hlt_iosrc_new_ring(hlt_string interface, hlt_exception** excpt, hlt_execution_context* ctx);
+
 /// Attempts to reads a packet from a PCAP source. If no packet is currently
 /// available, raises a WouldBlock exception if there might be one at a later
 /// time. If the source is permanently exhausted, returns a null pointer (see
@@ -78,6 +97,34 @@ extern hlt_iosrc* hlt_iosrc_new_offline(hlt_string interface, hlt_exception** ex
 /// *keep_link_layer* is disabled.
 extern hlt_packet hlt_iosrc_read_try(hlt_iosrc* src, int8_t keep_link_layer, hlt_exception** excpt, hlt_execution_context* ctx);
 
+/// Attempts to read a batch of packets from a PCAP source into a vector.
+/// The function reads as many packets as are currently available, up to a
+/// maximum, and resizes the vector to hold exactly those. Each packet gets
+/// a new ``bytes`` object; the vector's elements themselves are reused. If
+/// no packet is currently available, raises a WouldBlock exception if
+/// there might be one at a later time, and leaves the vector untouched.
+///
+/// For packet rings, the batch never extends beyond the current block, and
+/// the packets reference the ring's memory until they go away or get
+/// copied, see hlt_iosrc_new_ring().
+///
+/// src: The packet source.
+///
+/// pkts: The vector to fill. Its elements must be of type
+/// ``tuple<time, ref<bytes>>``.
+///
+/// max: The maximum number of packets to read. Must be larger than zero.
+///
+/// keep_link_layer: If not true, any link layer headers are stripped.
+///
+/// Returns: The number of packets read, which is zero if the source is
+/// permanently exhausted.
+///
+/// Raises: IOError if there are any errors other than those described
+/// above, including encountering an unsupported link-layer header if
+/// *keep_link_layer* is disabled; ValueError if *max* isn't positive.
+extern int64_t hlt_iosrc_read_batch_try(hlt_iosrc* src, hlt_vector* pkts, int64_t max, int8_t keep_link_layer, hlt_exception** excpt, hlt_execution_context* ctx);
+
 /// Closes a live PCAP packet source. Any attempt to read further packets
 /// will result in an IOSrcError exception.
 ///
@@ -55,6 +55,7 @@
 #include "cmdqueue.h"
 #include "file.h"
 #include "profiler.h"
+#include "pgo.h"
 #include "classifier.h"
 #include "hutil.h"
 #include "clone.h"
@@ -38,7 +38,8 @@
     i8*, ;; Function pointer for call that discards result.
     i8*, ;; Function pointer for dtor.
     i8*, ;; Function pointer for clone_init.
-    i64  ;; Total size of %hlt.callable object.
+    i64, ;; Total size of %hlt.callable object.
+    i8   ;; True if the function may yield.
 }
 
 ; A callable object.
@@ -116,6 +117,8 @@
     i8*,
     i8*,
     i8*,
+    i8*,
+    i8*,
     [0 x i8]
 }
 
@@ -176,8 +179,12 @@ declare void         @hlt_bytes_new_from_data_copy_hoisted(%hlt.bytes*, i8*, i64
 declare i8*          @hlt_bytes_to_raw(i8*, i64, %hlt.bytes*, %hlt.exception**, %hlt.execution_context*)
 
 declare i8 @__hlt_bytes_extract_one(%hlt.iterator.bytes*, %hlt.iterator.bytes, %hlt.exception**, %hlt.execution_context*)
+declare i8* @__hlt_bytes_chunk_end(%hlt.bytes*)
+declare i8 @hlt_bytes_match_raw_at(%hlt.iterator.bytes, i8*, i64, %hlt.exception**, %hlt.execution_context*)
 
 declare void            @__hlt_exception_print_uncaught_abort(%hlt.exception*, %hlt.execution_context*)
+declare void            @__hlt_exception_unwind(%hlt.execution_context*)
+declare i32             @__hlt_personality(i32, i32, i64, i8*, i8*)
 declare i8              @__hlt_exception_match(%hlt.exception*, %hlt.exception.type*)
 declare %hlt.exception* @hlt_exception_new(%hlt.exception.type*, i8*, i8*, %hlt.execution_context*)
 declare %hlt.exception* @hlt_exception_new_yield(%hlt.fiber*, i8*, %hlt.execution_context*)
@@ -217,10 +224,13 @@ declare %hlt.execution_context* @hlt_fiber_context(%hlt.fiber*)
 
 declare void @__hlt_thread_mgr_schedule(%hlt.thread_mgr*, %hlt.vid, %hlt.callable*, %hlt.exception**, %hlt.execution_context*)
 declare void @__hlt_thread_mgr_schedule_tcontext(%hlt.thread_mgr*, %hlt.type_info*, %hlt.void*, %hlt.callable*, %hlt.exception**, %hlt.execution_context*)
+declare void @__hlt_thread_mgr_schedule_tcontext_transfer(%hlt.thread_mgr*, %hlt.type_info*, %hlt.void*, %hlt.callable*, %hlt.exception**, %hlt.execution_context*)
 
 declare void @hlt_clone_deep(i8*, %hlt.type_info*, i8*, %hlt.exception**, %hlt.execution_context*)
 declare void @hlt_clone_shallow(i8*, %hlt.type_info*, i8*, %hlt.exception**, %hlt.execution_context*)
 declare void @hlt_clone_for_thread(i8*, %hlt.type_info*, i8*, %hlt.vid, %hlt.exception**, %hlt.execution_context*)
+declare void @hlt_clone_transfer(i8*, %hlt.type_info*, i8*, %hlt.vid, %hlt.exception**, %hlt.execution_context*)
+declare void @hlt_clone_transfer_unaliased(i8*, %hlt.type_info*, i8*, %hlt.exception**, %hlt.execution_context*)
 declare void @__hlt_clone(i8*, %hlt.type_info*, i8*, i8*, %hlt.exception**, %hlt.execution_context*)
 
 ;;; Exception types used by the code generator.
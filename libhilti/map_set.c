@@ -41,6 +41,10 @@ typedef struct __hlt_map {
     void *cache_result;                // Cache for deref's result tuple.
     void *cache_default;               // Cache for DEFAULT_FUNCTION's result value.
 
+    hlt_set* changes;                  // Keys changed since the last hlt_map_changes(), or null if not recording.
+    void* shadow;                      // Host application object associated with the map, or null.
+    void (*shadow_release)(void* obj); // Function to release the shadow object.
+
     // These are used by khash and copied from there (see README.HILTI).
     khint_t n_buckets, size, n_occupied, upper_bound;
     uint32_t *flags;
@@ -115,9 +119,13 @@ void hlt_map_dtor(hlt_type_info* ti, hlt_map* m, hlt_execution_context* ctx)
     _map_clear_default(m, ctx);
 
     GC_DTOR(m->tmgr, hlt_timer_mgr, ctx);
+    GC_DTOR(m->changes, hlt_set, ctx);
     hlt_free(m->cache_result);
     hlt_free(m->cache_default);
 
+    if ( m->shadow )
+        (*m->shadow_release)(m->shadow);
+
     kh_destroy_map(m);
 }
 
@@ -195,6 +203,29 @@ static inline void _access_map(hlt_map* m, khiter_t i, hlt_exception** excpt, hl
     hlt_timer_update(kh_value(m, i).timer, t, excpt, ctx);
 }
 
+static inline void _changed_map(hlt_map* m, void* key, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    if ( ! m->changes )
+        return;
+
+    hlt_set_insert(m->changes, m->tkey, key, excpt, ctx);
+
+    // The key may not be in the map yet, hence the +1.
+    if ( m->changes->size <= m->size + 1 )
+        return;
+
+    // More keys have changed than the map holds, so catching up would
+    // be no cheaper than starting over, and maybe nobody is catching
+    // up at all. Stop recording and drop the host application's copy,
+    // which then gets rebuilt from the whole map.
+    GC_CLEAR(m->changes, hlt_set, ctx);
+
+    if ( m->shadow ) {
+        (*m->shadow_release)(m->shadow);
+        m->shadow = 0;
+    }
+}
+
 static inline void _access_set(hlt_set* m, khiter_t i, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     if ( ! m->tmgr || ! hlt_enum_equal(m->strategy, Hilti_ExpireStrategy_Access, excpt, ctx) || m->timeout == 0 )
@@ -218,6 +249,8 @@ static inline void _hlt_map_init(hlt_map* m, const hlt_type_info* key, const hlt
     m->strategy = hlt_enum_unset(excpt, ctx);
     m->cache_result = 0;
     m->cache_default = 0;
+    m->changes = 0;
+    m->shadow = 0;
 
     _map_clear_default(m, ctx);
 }
@@ -276,6 +309,8 @@ void hlt_map_clone_init(void* dstp, const hlt_type_info* ti, void* srcp, __hlt_c
     dst->default_type = src->default_type;
     dst->cache_result = 0;
     dst->cache_default = 0;
+    dst->changes = 0;
+    dst->shadow = 0;
 
     switch ( src->default_type ) {
      case HLT_MAP_DEFAULT_NONE:
@@ -390,6 +425,8 @@ void hlt_map_insert(hlt_map* m, const hlt_type_info* tkey, void* key, const hlt_
         return;
     }
 
+    _changed_map(m, key, excpt, ctx);
+
     void* keytmp = _to_voidp(tkey, key);
     void* valtmp = _to_voidp(tval, value);
 
@@ -462,6 +499,7 @@ void hlt_map_remove(hlt_map* m, const hlt_type_info* type, void* key, hlt_except
         }
 
         void* key = kh_key(m, i);
+        _changed_map(m, key, excpt, ctx);
         GC_DTOR_GENERIC(key, m->tkey, ctx);
         hlt_free(key);
 
@@ -486,6 +524,7 @@ void hlt_map_expire(__hlt_map_timer_cookie cookie, hlt_exception** excpt, hlt_ex
     kh_value(cookie.map, i).timer = 0;
 
     void* key = kh_key(cookie.map, i);
+    _changed_map(cookie.map, key, excpt, ctx);
     GC_DTOR_GENERIC(key, cookie.map->tkey, ctx);
     hlt_free(key);
 
@@ -518,6 +557,7 @@ void hlt_map_clear(hlt_map* m, hlt_exception** excpt, hlt_execution_context* ctx
             if ( kh_value(m, i).timer )
                 hlt_timer_cancel(kh_value(m, i).timer, excpt, ctx);
 
+            _changed_map(m, kh_key(m, i), excpt, ctx);
             GC_DTOR_GENERIC(kh_key(m, i), m->tkey, ctx);
             GC_DTOR_GENERIC(kh_value(m, i).val, m->tvalue, ctx);
             hlt_free(kh_key(m, i));
@@ -563,6 +603,39 @@ void hlt_map_timeout(hlt_map* m, hlt_enum strategy, hlt_interval timeout, hlt_ex
         GC_ASSIGN(m->tmgr, ctx->tmgr, hlt_timer_mgr, ctx);
 }
 
+hlt_set* hlt_map_changes(hlt_map* m, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    if ( ! m ) {
+        hlt_set_exception(excpt, &hlt_exception_null_reference, 0, ctx);
+        return 0;
+    }
+
+    hlt_set* changes = m->changes;
+
+    m->changes = hlt_set_new(m->tkey, 0, excpt, ctx);
+    GC_CCTOR(m->changes, hlt_set, ctx);
+
+    // We pass our reference on to the caller.
+    if ( changes )
+        GC_DTOR(changes, hlt_set, ctx);
+
+    return changes;
+}
+
+void __hlt_map_set_shadow(hlt_map* m, void* obj, void (*release)(void* obj), hlt_execution_context* ctx)
+{
+    if ( m->shadow )
+        (*m->shadow_release)(m->shadow);
+
+    m->shadow = obj;
+    m->shadow_release = release;
+}
+
+void* __hlt_map_shadow(hlt_map* m)
+{
+    return m->shadow;
+}
+
 hlt_iterator_map hlt_map_begin(hlt_map* m, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     if ( ! m ) {
@@ -174,6 +174,39 @@ extern void hlt_map_default_callable(hlt_map* m, hlt_callable* func, hlt_excepti
 /// Raises: NoTimerManager if not timer manager has been associated with the map.
 extern void hlt_map_timeout(hlt_map* m, hlt_enum strategy, hlt_interval timeout, hlt_exception** excpt, hlt_execution_context* ctx);
 
+/// Returns the keys that have been inserted, replaced, or removed since the
+/// last call for the same map, including those of entries that expired. The
+/// map only records these once the function has been called the first
+/// time, which returns null. Once more keys have changed than the map
+/// holds, it stops recording and releases its shadow object; the next call
+/// then returns null again, and the caller needs to start over from the
+/// whole map. Changes inside of a value that the map holds by reference are
+/// not recorded.
+///
+/// m: The map.
+///
+/// excpt: &
+///
+/// Returns: The set of changed keys, or null if not recording.
+extern hlt_set* hlt_map_changes(hlt_map* m, hlt_exception** excpt, hlt_execution_context* ctx);
+
+/// Associates an object of the host application with a map, such as a
+/// copy of the map that the host application keeps in sync. The map
+/// releases the object when it is destroyed or another one is set.
+///
+/// m: The map.
+///
+/// obj: The object, or null to remove a previously set one.
+///
+/// release: Function to call for releasing *obj*.
+extern void __hlt_map_set_shadow(hlt_map* m, void* obj, void (*release)(void* obj), hlt_execution_context* ctx);
+
+/// Returns the host application object associated with a map by
+/// __hlt_map_set_shadow(), or null if none.
+///
+/// m: The map.
+extern void* __hlt_map_shadow(hlt_map* m);
+
 /// Returns an iterator pointing the first map element.
 ///
 /// m: The map.
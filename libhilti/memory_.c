@@ -1,5 +1,6 @@
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 #include <inttypes.h>
 #include <string.h>
@@ -23,11 +24,30 @@ struct __obj_with_rtti {
     void* obj;
 };
 
+// Objects allocated inside a region start out with this reference count,
+// which stands for the region's own reference. It is large enough that the
+// count won't drop to zero while the region is active, so these objects
+// don't go into the null buffer; the region takes care of them.
+static const int64_t __REGION_REF_CNT = ((int64_t)1) << 40;
+
+static const size_t __INITIAL_REGION_OBJS = 64;
+
+typedef struct __hlt_memory_region {
+    size_t used;                      // Number of entries in objs.
+    size_t allocated;                 // Number of entries allocated for objs.
+    struct __obj_with_rtti* objs;     // All objects allocated inside the region; destroyed ones are zeroed.
+} __hlt_memory_region;
+
 struct __hlt_memory_nullbuffer {
     size_t used;
     size_t allocated;
     int64_t flush_pos;
     struct __obj_with_rtti* objs;
+
+    // Allocation regions, see hlt_memory_region_begin().
+    __hlt_memory_region* region;  // The currently active region, if any.
+    __hlt_memory_region* spare;   // An empty region kept for reuse.
+    uint64_t region_depth;        // Nesting level of hlt_memory_region_begin() calls.
 };
 
 #ifdef DEBUG
@@ -125,6 +145,25 @@ void* __hlt_malloc_no_init(uint64_t size, const char* type, const char* location
     return p;
 }
 
+void* __hlt_malloc_aligned(uint64_t alignment, uint64_t size, const char* type, const char* location)
+{
+    void *p = 0;
+
+    if ( posix_memalign(&p, alignment, size) != 0 ) {
+        fputs("out of memory in hlt_malloc_aligned, aborting", stderr);
+        exit(1);
+    }
+
+    memset(p, 0, size);
+
+#ifdef DEBUG
+    ++__hlt_globals()->num_allocs;
+    _dbg_mem_raw("malloc_aligned", p, size, type, location, 0, 0);
+#endif
+
+    return p;
+}
+
 void* __hlt_realloc(void* p, uint64_t size, uint64_t old_size, const char* type, const char* location)
 {
 #ifdef DEBUG
@@ -221,12 +260,45 @@ void* __hlt_object_new_ref(const hlt_type_info* ti, uint64_t size, const char* l
     return hdr;
 }
 
+// Hands a new object over to the context's active region. Returns false if
+// there's no region.
+static inline int8_t _region_add(const hlt_type_info* ti, __hlt_gchdr* hdr, hlt_execution_context* ctx)
+{
+    __hlt_memory_region* r = ctx->nullbuffer->region;
+
+    if ( ! r )
+        return 0;
+
+    if ( r->used >= r->allocated ) {
+        size_t nsize = (r->allocated * 2);
+        r->objs = (struct __obj_with_rtti*) hlt_realloc_no_init(r->objs, sizeof(struct __obj_with_rtti) * nsize);
+        r->allocated = nsize;
+    }
+
+    hdr->ref_cnt = __REGION_REF_CNT;
+
+    struct __obj_with_rtti x;
+    x.ti = ti;
+    x.obj = hdr;
+    r->objs[r->used++] = x;
+
+    return 1;
+}
+
 void* __hlt_object_new(const hlt_type_info* ti, uint64_t size, const char* location, hlt_execution_context* ctx)
 {
     assert(size);
     assert(ctx->nullbuffer->flush_pos < 0);
 
     __hlt_gchdr* hdr = (__hlt_gchdr*)__hlt_malloc(size, ti->tag, location);
+
+    if ( _region_add(ti, hdr, ctx) ) {
+#ifdef DEBUG
+        _dbg_mem_gc("new", ti, hdr, location, "region", ctx);
+#endif
+        return hdr;
+    }
+
     hdr->ref_cnt = 0;
     __hlt_memory_nullbuffer_add(ctx->nullbuffer, ti, hdr, ctx);
 
@@ -257,6 +329,14 @@ void* __hlt_object_new_no_init(const hlt_type_info* ti, uint64_t size, const cha
     assert(ctx->nullbuffer->flush_pos < 0);
 
     __hlt_gchdr* hdr = (__hlt_gchdr*)__hlt_malloc_no_init(size, ti->tag, location);
+
+    if ( _region_add(ti, hdr, ctx) ) {
+#ifdef DEBUG
+        _dbg_mem_gc("new", ti, hdr, location, "region", ctx);
+#endif
+        return hdr;
+    }
+
     hdr->ref_cnt = 0;
     __hlt_memory_nullbuffer_add(ctx->nullbuffer, ti, hdr, ctx);
 
@@ -612,6 +692,134 @@ void  hlt_memory_pool_free(hlt_memory_pool* p, void* b)
     // Do nothing.
 }
 
+static __hlt_memory_region* _region_new()
+{
+    __hlt_memory_region* r = hlt_malloc_no_init(sizeof(__hlt_memory_region));
+    r->used = 0;
+    r->allocated = __INITIAL_REGION_OBJS;
+    r->objs = (struct __obj_with_rtti*) hlt_malloc_no_init(sizeof(struct __obj_with_rtti) * r->allocated);
+    return r;
+}
+
+static void _region_delete(__hlt_memory_region* r)
+{
+    hlt_free(r->objs);
+    hlt_free(r);
+}
+
+// Appends an object to the null buffer without checking whether it's
+// already in there.
+static void _nullbuffer_append(__hlt_memory_nullbuffer* nbuf, const hlt_type_info* ti, void *obj)
+{
+    if ( nbuf->used >= nbuf->allocated ) {
+        size_t nsize = (nbuf->allocated * 2);
+        nbuf->objs = (struct __obj_with_rtti*) hlt_realloc(nbuf->objs,
+                                                           sizeof(struct __obj_with_rtti) * nsize,
+                                                           sizeof(struct __obj_with_rtti) * nbuf->allocated);
+        nbuf->allocated = nsize;
+    }
+
+    struct __obj_with_rtti x;
+    x.ti = ti;
+    x.obj = obj;
+    nbuf->objs[nbuf->used++] = x;
+
+#ifdef DEBUG
+    ++__hlt_globals()->num_nullbuffer;
+
+    if ( nbuf->used > __hlt_globals()->max_nullbuffer )
+        // Not thread-safe, but doesn't matter.
+        __hlt_globals()->max_nullbuffer = nbuf->used;
+#endif
+}
+
+// Drops the region's reference to all of its objects. Those that nobody
+// else references go into the null buffer, which the caller then flushes;
+// the others become regular objects, released once their reference count
+// drops to zero. That way, an object escaping the region doesn't keep
+// anything else around.
+//
+// This is a single pass over the region. If destroying one object releases
+// the last reference to another region object, that one is destroyed right
+// away by the flush, no matter where it is in the region.
+static void _region_end(__hlt_memory_region* r, hlt_execution_context* ctx)
+{
+    __hlt_memory_nullbuffer* nbuf = ctx->nullbuffer;
+
+    // Region objects are never in the null buffer, so we can skip the
+    // check for duplicates that __hlt_memory_nullbuffer_add() does.
+    for ( size_t i = 0; i < r->used; i++ ) {
+        __hlt_gchdr* hdr = (__hlt_gchdr*)r->objs[i].obj;
+        const hlt_type_info* ti = r->objs[i].ti;
+
+#ifdef HLT_ATOMIC_REF_COUNTING
+        int64_t ref_cnt = __atomic_sub_fetch(&hdr->ref_cnt, __REGION_REF_CNT, __ATOMIC_SEQ_CST);
+#else
+        int64_t ref_cnt = (hdr->ref_cnt -= __REGION_REF_CNT);
+#endif
+
+        if ( ref_cnt > 0 ) {
+#ifdef DEBUG
+            _dbg_mem_gc("region_promote", ti, hdr, "", 0, ctx);
+#endif
+            continue;
+        }
+
+#ifdef DEBUG
+        _dbg_mem_gc("region_destroy", ti, hdr, "", 0, ctx);
+#endif
+
+        _nullbuffer_append(nbuf, ti, hdr);
+    }
+
+    r->used = 0;
+}
+
+void hlt_memory_region_begin(hlt_execution_context* ctx)
+{
+    __hlt_memory_nullbuffer* nbuf = ctx->nullbuffer;
+
+    if ( nbuf->region_depth++ )
+        return;
+
+    assert(! nbuf->region);
+
+    if ( nbuf->spare ) {
+        nbuf->region = nbuf->spare;
+        nbuf->spare = 0;
+    }
+    else
+        nbuf->region = _region_new();
+}
+
+void hlt_memory_region_end(hlt_execution_context* ctx)
+{
+    __hlt_memory_nullbuffer* nbuf = ctx->nullbuffer;
+
+    assert(nbuf->region_depth);
+
+    if ( --nbuf->region_depth )
+        return;
+
+    __hlt_memory_region* r = nbuf->region;
+    nbuf->region = 0;
+
+    // Releasing the temporaries first may drop references to the region's
+    // objects.
+    __hlt_memory_nullbuffer_flush(nbuf, ctx);
+
+    _region_end(r, ctx);
+
+    if ( nbuf->spare )
+        _region_delete(r);
+    else
+        nbuf->spare = r;
+
+    // Destroys the region's unreferenced objects, along with anything
+    // released by that.
+    __hlt_memory_nullbuffer_flush(nbuf, ctx);
+}
+
 __hlt_memory_nullbuffer* __hlt_memory_nullbuffer_new()
 {
     __hlt_memory_nullbuffer* nbuf = (__hlt_memory_nullbuffer*) hlt_malloc(sizeof(__hlt_memory_nullbuffer));
@@ -619,12 +827,21 @@ __hlt_memory_nullbuffer* __hlt_memory_nullbuffer_new()
     nbuf->allocated = __INITIAL_NULLBUFFER_SIZE;
     nbuf->flush_pos = -1;
     nbuf->objs = (struct __obj_with_rtti*) hlt_malloc(sizeof(struct __obj_with_rtti) * nbuf->allocated);
+    nbuf->region = 0;
+    nbuf->spare = 0;
+    nbuf->region_depth = 0;
     return nbuf;
 }
 
 void __hlt_memory_nullbuffer_delete(__hlt_memory_nullbuffer* nbuf, hlt_execution_context* ctx)
 {
+    assert(! nbuf->region);
+
     __hlt_memory_nullbuffer_flush(nbuf, ctx);
+
+    if ( nbuf->spare )
+        _region_delete(nbuf->spare);
+
     hlt_free(nbuf->objs);
     hlt_free(nbuf);
 }
@@ -683,26 +900,7 @@ void __hlt_memory_nullbuffer_add(__hlt_memory_nullbuffer* nbuf, const hlt_type_i
     _dbg_mem_gc("nullbuffer_add", ti, hdr, "", 0, ctx);
 #endif
 
-    if ( nbuf->used >= nbuf->allocated ) {
-        size_t nsize = (nbuf->allocated * 2);
-        nbuf->objs = (struct __obj_with_rtti*) hlt_realloc(nbuf->objs,
-                                                           sizeof(struct __obj_with_rtti) * nsize,
-                                                           sizeof(struct __obj_with_rtti) * nbuf->allocated);
-        nbuf->allocated = nsize;
-    }
-
-    struct __obj_with_rtti x;
-    x.ti = ti;
-    x.obj = obj;
-    nbuf->objs[nbuf->used++] = x;
-
-#ifdef DEBUG
-    ++__hlt_globals()->num_nullbuffer;
-
-    if ( nbuf->used > __hlt_globals()->max_nullbuffer )
-        // Not thread-safe, but doesn't matter.
-        __hlt_globals()->max_nullbuffer = nbuf->used;
-#endif
+    _nullbuffer_append(nbuf, ti, obj);
 }
 
 int8_t __hlt_memory_nullbuffer_contains(__hlt_memory_nullbuffer* nbuf, void *obj)
@@ -712,17 +910,18 @@ int8_t __hlt_memory_nullbuffer_contains(__hlt_memory_nullbuffer* nbuf, void *obj
 
 void __hlt_memory_nullbuffer_remove(__hlt_memory_nullbuffer* nbuf, void *obj)
 {
-    // TODO: Unclear if it's worth keeping the buffer sorted to speed this up?
-    for ( size_t i = 0; i < nbuf->used; i++ ) {
-        struct __obj_with_rtti x = nbuf->objs[i];
-
-        if ( x.obj == obj ) {
-            // Mark as done.
-            x.obj = 0;
-            --__hlt_globals()->num_nullbuffer;
-            break;
-        }
-    }
+    int64_t nbpos = _nullbuffer_index(nbuf, obj);
+
+    if ( nbpos < 0 )
+        return;
+
+    // Mark as done. Note that this needs to modify the buffer itself, not a
+    // copy of the entry.
+    nbuf->objs[nbpos].obj = 0;
+
+#ifdef DEBUG
+    --__hlt_globals()->num_nullbuffer;
+#endif
 }
 
 void __hlt_memory_nullbuffer_flush(__hlt_memory_nullbuffer* nbuf, hlt_execution_context* ctx)
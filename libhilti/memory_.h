@@ -64,6 +64,27 @@ extern void* __hlt_malloc(uint64_t size, const char* type, const char* location)
 /// XXX
 extern void* __hlt_malloc_no_init(uint64_t size, const char* type, const char* location);
 
+/// Allocates an unmanaged memory chunk starting at a given alignment. This
+/// operates like __hlt_malloc() otherwise, and the memory must be freed
+/// with ``hlt_free`` as well.
+///
+/// alignment: The alignment in bytes; must be a power of two and a multiple
+/// of ``sizeof(void*)``.
+///
+/// size: The size of the chunk.
+///
+/// type: A string describing the type of object being allocated. This is for
+/// debug purposes only.
+///
+/// location: A string describing the location where the object is allocaged.
+/// This is for debugging purposes only.
+///
+/// Returns: A pointer to the new memory chunk. This will never be null.
+///
+/// \note This shouldn't be called directly by user code. Use the macro \c
+/// hlt_malloc_aligned instead.
+extern void* __hlt_malloc_aligned(uint64_t alignment, uint64_t size, const char* type, const char* location);
+
 /// Allocates a number of unmanaged memory elements of a given size. This
 /// operates pretty much like calloc but it will always return a valid
 /// address. If it can't allocate sufficient memory, the function will
@@ -159,6 +180,7 @@ extern void hlt_stack_invalidate(void* stack, size_t size);
 
 #define hlt_malloc(size)                 __hlt_malloc(size, "-", __hlt_make_location(__FILE__,__LINE__))
 #define hlt_malloc_no_init(size)         __hlt_malloc_no_init(size, "-", __hlt_make_location(__FILE__,__LINE__))
+#define hlt_malloc_aligned(align, size)  __hlt_malloc_aligned(align, size, "-", __hlt_make_location(__FILE__,__LINE__))
 #define hlt_calloc(count, size)          __hlt_calloc(count, size, "-", __hlt_make_location(__FILE__,__LINE__))
 #define hlt_realloc(ptr, size, old_size) __hlt_realloc(ptr, size, old_size, "-", __hlt_make_location(__FILE__,__LINE__))
 #define hlt_realloc_no_init(ptr, size)   __hlt_realloc_no_init(ptr, size, "-", __hlt_make_location(__FILE__,__LINE__))
@@ -370,4 +392,28 @@ void* hlt_memory_pool_malloc(hlt_memory_pool* p, size_t n);
 void* hlt_memory_pool_calloc(hlt_memory_pool* p, size_t count, size_t n);
 void  hlt_memory_pool_free(hlt_memory_pool* p, void* b); // just a hint, not mandatory
 
+/// Starts an allocation region for the execution context. Until the matching
+/// hlt_memory_region_end(), managed objects that the context creates without
+/// an initial reference (i.e., those that would otherwise go into the null
+/// buffer) are tracked by the region instead. The region keeps its own
+/// reference to each of them.
+///
+/// Calls can be nested; only the outermost pair opens and closes a region.
+///
+/// ctx: The context to start the region for.
+extern void hlt_memory_region_begin(hlt_execution_context* ctx);
+
+/// Ends the region started by the corresponding hlt_memory_region_begin().
+/// This destroys all objects of the region that nobody else holds a
+/// reference to anymore, in one go. Objects that are still referenced
+/// elsewhere remain valid and become regular objects, released once their
+/// reference count drops to zero; they don't keep anything else of the
+/// region around.
+///
+/// As this releases memory, it must only be called at a point where a
+/// memory safepoint would be fine as well.
+///
+/// ctx: The context to end the region for.
+extern void hlt_memory_region_end(hlt_execution_context* ctx);
+
 #endif
@@ -0,0 +1,119 @@
+// Profile-guided optimization support.
+//
+// The output file has one line per instrumented function, of the form
+// "<function>\t<number of blocks>\t<count block 0> <count block 1> ...".
+// Each run overwrites the profile of the previous one; the counters aren't
+// updated atomically and are thus approximate with multiple threads, which
+// is fine for the purpose.
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "pgo.h"
+#include "debug.h"
+
+typedef struct __hlt_pgo_module {
+    uint64_t* counters;               // The module's counter array.
+    const char* table;                // The module's counter layout.
+    const char* path;                 // The file to write the profile to.
+    struct __hlt_pgo_module* next;    // Next registered module.
+} __hlt_pgo_module;
+
+static __hlt_pgo_module* _modules = 0;
+static pthread_mutex_t _lock = PTHREAD_MUTEX_INITIALIZER;
+
+void __hlt_pgo_register(uint64_t* counters, const char* table, const char* path)
+{
+    pthread_mutex_lock(&_lock);
+
+    __hlt_pgo_module* m;
+
+    for ( m = _modules; m; m = m->next ) {
+        if ( m->counters == counters )
+            goto done;
+    }
+
+    m = malloc(sizeof(__hlt_pgo_module));
+
+    if ( ! m )
+        goto done;
+
+    m->counters = counters;
+    m->table = table;
+    m->path = path;
+    m->next = _modules;
+    _modules = m;
+
+    DBG_LOG("hilti-pgo", "registered profile counters for %s", path);
+
+done:
+    pthread_mutex_unlock(&_lock);
+}
+
+static void _write_profile(__hlt_pgo_module* m)
+{
+    char tmp[strlen(m->path) + 5];
+    strcpy(tmp, m->path);
+    strcat(tmp, ".tmp");
+
+    FILE* out = fopen(tmp, "w");
+
+    if ( ! out ) {
+        fprintf(stderr, "libhilti: cannot write profile to %s\n", tmp);
+        return;
+    }
+
+    fprintf(out, "%s\n", HLT_PGO_MAGIC);
+
+    const char* p = m->table;
+    uint64_t* c = m->counters;
+
+    while ( *p ) {
+        const char* eol = strchr(p, '\n');
+
+        if ( ! eol )
+            break;
+
+        const char* tab = memchr(p, '\t', eol - p);
+
+        if ( ! tab )
+            break;
+
+        uint64_t n = strtoull(tab + 1, 0, 10);
+        uint64_t i;
+
+        fprintf(out, "%.*s\t%" PRIu64 "\t", (int)(eol - p), p, n);
+
+        for ( i = 0; i < n; i++ )
+            fprintf(out, i ? " %" PRIu64 : "%" PRIu64, *c++);
+
+        fputc('\n', out);
+        p = eol + 1;
+    }
+
+    fclose(out);
+
+    if ( rename(tmp, m->path) < 0 )
+        fprintf(stderr, "libhilti: cannot move profile into %s\n", m->path);
+}
+
+void __hlt_pgo_done()
+{
+    pthread_mutex_lock(&_lock);
+
+    __hlt_pgo_module* m = _modules;
+
+    while ( m ) {
+        __hlt_pgo_module* next = m->next;
+        _write_profile(m);
+        free(m);
+        m = next;
+    }
+
+    _modules = 0;
+
+    pthread_mutex_unlock(&_lock);
+}
@@ -0,0 +1,31 @@
+// Run-time support for profile-guided optimization.
+//
+// When the compiler instruments a linked module for PGO, it adds an array
+// of per-block execution counters plus a table describing their layout, and
+// registers both with the runtime at module initialization. At termination,
+// the runtime writes the counters out to the profile file the compiler
+// picked, from where the next compilation of the same module picks them up.
+
+#ifndef HLT_PGO_H
+#define HLT_PGO_H
+
+#include <stdint.h>
+
+#define HLT_PGO_MAGIC "hilti-pgo 1" // First line of a profile file.
+
+/// Registers a module's block counters. Registering the same counter array
+/// more than once is a no-op.
+///
+/// counters: Array of counters, one per instrumented basic block.
+///
+/// table: The counter layout, one line per instrumented function of the
+/// form ``<function>\t<number of blocks>\n``, in the order the counters
+/// appear in *counters*.
+///
+/// path: The file to write the profile into at termination.
+extern void __hlt_pgo_register(uint64_t* counters, const char* table, const char* path);
+
+/// Writes out the profiles of all registered modules.
+extern void __hlt_pgo_done();
+
+#endif
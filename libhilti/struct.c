@@ -77,6 +77,29 @@ void hlt_struct_clone_init(void* dstp, const hlt_type_info* ti, void* srcp, __hl
     }
 }
 
+void __hlt_struct_transfer(const hlt_type_info* ti, void* obj, __hlt_transfer_callback cb, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    char* s = *(char**)obj;
+
+    if ( ! s )
+        return;
+
+    uint32_t mask = *((uint32_t*)(s + sizeof(__hlt_gchdr)));
+
+    struct field* fields = (struct field *)ti->aux;
+    hlt_type_info** types = (hlt_type_info**) &ti->type_params;
+
+    for ( int i = 0; i < ti->num_params; i++ ) {
+        uint32_t is_set = (mask & (1 << i));
+
+        if ( is_set ) {
+            (*cb)(s + fields[i].offset, types[i], cstate, excpt, ctx);
+            if ( hlt_check_exception(excpt) )
+                return;
+        }
+    }
+}
+
 hlt_string hlt_struct_to_string(const hlt_type_info* type, void* obj, int32_t options, __hlt_pointer_stack* seen, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     assert(type->type == HLT_TYPE_STRUCT);
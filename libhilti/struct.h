@@ -6,6 +6,7 @@
 #define LIBHILTI_STRUCT_H
 
 #include "types.h"
+#include "clone.h"
 
 /// Meta-information about a struct field.
 typedef struct {
@@ -62,6 +63,18 @@ extern void* hlt_struct_get(const hlt_type_info* type, void* obj, int index, hlt
 /// Returns: A pointer to the meta information. All pointers in there must be left untouched, ownership is *not* passed to caller.
 extern hlt_struct_field hlt_struct_get_type(const hlt_type_info* type, int index, hlt_exception** excpt, hlt_execution_context* ctx);
 
+/// Internal function that calls a transfer callback for each set field of a
+/// struct being moved to a different thread by hlt_clone_transfer().
+///
+/// type: The type of the struct.
+///
+/// obj: A pointer to the reference to the struct.
+///
+/// cb: The callback to run for each field.
+///
+/// cstate: The transfer's state, to be passed on to the callback.
+extern void __hlt_struct_transfer(const hlt_type_info* type, void* obj, __hlt_transfer_callback cb, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx);
+
 #endif
 
 
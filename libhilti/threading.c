@@ -24,7 +24,9 @@
 #include "callable.h"
 #include "context.h"
 #include "globals.h"
+#include "file.h"
 #include "exceptions.h"
+#include "timer.h"
 #include "autogen/hilti-hlt.h"
 
 typedef hlt_hash khint_t;
@@ -55,6 +57,27 @@ static inline int8_t __kh_ptr_equal_func(const void* p1, const void* p2, const v
 
 KHASH_INIT(blocked_jobs, const void*, hlt_blocked_job*, 1, __kh_ptr_hash_func, __kh_ptr_equal_func)
 
+typedef struct __kh_vthreads_t {
+    // These are used by khash and copied from there (see README.HILTI).
+    khint_t n_buckets, size, n_occupied, upper_bound;
+    uint32_t *flags;
+    hlt_vthread_id* keys;
+    __hlt_vthread_state** vals;
+} kh_vthreads_t;
+
+static inline hlt_hash __kh_vid_hash_func(hlt_vthread_id vid, const void* unused)
+{
+    // Same as khash's kh_int64_hash_func.
+    return (hlt_hash)((vid >> 33) ^ vid ^ (vid << 11));
+}
+
+static inline int8_t __kh_vid_equal_func(hlt_vthread_id vid1, hlt_vthread_id vid2, const void* unused)
+{
+    return vid1 == vid2;
+}
+
+KHASH_INIT(vthreads, hlt_vthread_id, __hlt_vthread_state*, 1, __kh_vid_hash_func, __kh_vid_equal_func)
+
 // Batch size for the jobs queues.
 #define QUEUE_BATCH_SIZE 100
 
@@ -68,34 +91,111 @@ static void _fatal_error(const char* msg)
     exit(1);
 }
 
-// Returns the execution context to use for a given virtual thread ID.
-static hlt_execution_context* _worker_get_ctx(hlt_worker_thread* thread, hlt_vthread_id vid)
+static void _worker_lru_unlink(hlt_worker_thread* thread, __hlt_vthread_state* vt)
 {
-    if ( vid == 0 )
-        return hlt_global_execution_context();
+    if ( vt->prev )
+        vt->prev->next = vt->next;
+    else
+        thread->lru_head = vt->next;
 
-    hlt_vthread_id max = thread->max_vid;
+    if ( vt->next )
+        vt->next->prev = vt->prev;
+    else
+        thread->lru_tail = vt->prev;
 
-    if ( max < vid ) {
-        // Need to grow the context array.
-        hlt_vthread_id new_max = max;
-        while ( new_max < vid )
-            new_max *= 2;
+    vt->prev = vt->next = 0;
+}
 
-        thread->ctxs = hlt_realloc(thread->ctxs, (new_max+1) * sizeof(hlt_execution_context*), (max+1) * sizeof(hlt_execution_context*));
-        thread->max_vid = new_max;
-    }
+static void _worker_lru_append(hlt_worker_thread* thread, __hlt_vthread_state* vt)
+{
+    vt->prev = thread->lru_tail;
+    vt->next = 0;
 
-    hlt_execution_context* ctx = thread->ctxs[vid];
+    if ( thread->lru_tail )
+        thread->lru_tail->next = vt;
+    else
+        thread->lru_head = vt;
 
-    if ( ! ctx ) {
-        // Haven't seen this thread yet, need to create new context.
-        ctx = __hlt_execution_context_new_ref(vid, 1);
-        ctx->worker = thread;
-        thread->ctxs[vid] = ctx;
-    }
+    thread->lru_tail = vt;
+}
+
+// Records that a virtual thread is active at the worker's current global
+// time, moving it to the end of the list of idle candidates.
+static void _worker_touch_vthread(hlt_worker_thread* thread, __hlt_vthread_state* vt)
+{
+    vt->last_active = thread->global_time;
 
-    return ctx;
+    if ( thread->lru_tail == vt )
+        return;
+
+    _worker_lru_unlink(thread, vt);
+    _worker_lru_append(thread, vt);
+}
+
+// Returns the worker's state for a virtual thread. If we haven't seen the
+// thread yet, or have evicted it since, this creates a new execution
+// context for it. Must not be called for vid zero, which uses the global
+// context.
+static __hlt_vthread_state* _worker_get_vthread(hlt_worker_thread* thread, hlt_vthread_id vid)
+{
+    khiter_t i = kh_get_vthreads(thread->vthreads, vid, 0);
+
+    if ( i != kh_end(thread->vthreads) )
+        return kh_value(thread->vthreads, i);
+
+    __hlt_vthread_state* vt = hlt_malloc(sizeof(__hlt_vthread_state));
+    vt->ctx = __hlt_execution_context_new_ref(vid, thread, 1);
+    vt->deadline_pos = 0;
+    vt->num_fibers = 0;
+    vt->last_active = thread->global_time;
+    _worker_lru_append(thread, vt);
+
+    int ret;
+    i = kh_put_vthreads(thread->vthreads, vid, &ret, 0);
+    kh_value(thread->vthreads, i) = vt;
+
+    return vt;
+}
+
+// Deletes a virtual thread's execution context. The thread must not have
+// any timers pending, nor any jobs holding on to the context.
+static void _worker_evict_vthread(hlt_worker_thread* thread, __hlt_vthread_state* vt)
+{
+    assert(! vt->deadline_pos && ! vt->num_fibers);
+
+    DBG_LOG(DBG_STREAM, "evicting idle vid %" PRId64 " from %s", vt->ctx->vid, thread->name);
+
+    khiter_t i = kh_get_vthreads(thread->vthreads, vt->ctx->vid, 0);
+    assert(i != kh_end(thread->vthreads));
+    kh_del_vthreads(thread->vthreads, i);
+
+    _worker_lru_unlink(thread, vt);
+    hlt_execution_context_delete(vt->ctx);
+    hlt_free(vt);
+
+    ++thread->num_evicted;
+}
+
+// Evicts all virtual threads that have been idle for longer than
+// configured, and don't have anything else pending.
+static void _worker_evict_idle(hlt_worker_thread* thread, hlt_time gt)
+{
+    hlt_time timeout = hlt_time_from_timestamp(hlt_config_get()->vthread_idle_timeout);
+
+    if ( ! timeout )
+        return;
+
+    // The list is ordered by last activity, so we can stop at the first
+    // thread that hasn't been idle long enough.
+    while ( thread->lru_head && thread->lru_head->last_active + timeout <= gt ) {
+        __hlt_vthread_state* vt = thread->lru_head;
+
+        if ( vt->deadline_pos || vt->num_fibers )
+            // Still in use, check back later.
+            _worker_touch_vthread(thread, vt);
+        else
+            _worker_evict_vthread(thread, vt);
+    }
 }
 
 static void _hlt_job_delete(hlt_job* j, hlt_execution_context* ctx)
@@ -108,6 +208,8 @@ static void _hlt_job_delete(hlt_job* j, hlt_execution_context* ctx)
         hlt_fiber_delete(j->fiber, ctx);
     }
 
+    GC_DTOR(j->func, hlt_callable, ctx);
+
     GC_DTOR_GENERIC(&j->tcontext, j->tcontext_type, ctx);
     hlt_free(j);
 }
@@ -116,11 +218,14 @@ static void _hlt_worker_thread_delete(hlt_worker_thread* t)
 {
     DBG_LOG(DBG_STREAM, "deleting worker thread %s", t->name);
 
+    // A job's virtual thread may not have a context (anymore) if the job
+    // never got to run, and we don't want to create one just for cleaning
+    // up. Any context will do for deleting those.
     while ( hlt_thread_queue_size(t->jobs) ) {
         hlt_job* job = hlt_thread_queue_read(t->jobs, 10);
         assert(job);
 
-        hlt_execution_context* ctx = _worker_get_ctx(t, job->vid);
+        hlt_execution_context* ctx = job->fiber ? hlt_fiber_context(job->fiber) : hlt_global_execution_context();
         _hlt_job_delete(job, ctx);
     }
 
@@ -135,23 +240,31 @@ static void _hlt_worker_thread_delete(hlt_worker_thread* t)
         while ( bjob ) {
             hlt_blocked_job* next = bjob->next;
 
-            hlt_execution_context* ctx = _worker_get_ctx(t, bjob->job->vid);
-            _hlt_job_delete(bjob->job, ctx);
+            hlt_job* job = bjob->job;
+            hlt_execution_context* ctx = job->fiber ? hlt_fiber_context(job->fiber) : hlt_global_execution_context();
+            _hlt_job_delete(job, ctx);
 
             hlt_free(bjob);
             bjob = next;
         }
     }
 
-    for ( int j = 1; j <= t->max_vid; j++ ) {
-        if ( t->ctxs[j] )
-            hlt_execution_context_delete(t->ctxs[j]);
+    for ( khiter_t i = kh_begin(t->vthreads); i != kh_end(t->vthreads); i++ ) {
+        if ( ! kh_exist(t->vthreads, i) )
+            continue;
+
+        __hlt_vthread_state* vt = kh_value(t->vthreads, i);
+        hlt_execution_context_delete(vt->ctx);
+        hlt_free(vt);
     }
 
     kh_destroy_blocked_jobs(t->jobs_blocked);
     hlt_free(t->jobs_blocked);
 
-    hlt_free(t->ctxs);
+    kh_destroy_vthreads(t->vthreads);
+    hlt_free(t->vthreads);
+
+    hlt_free(t->deadlines);
     hlt_free(t->name);
     __hlt_fiber_pool_delete(t->fiber_pool);
 
@@ -356,7 +469,11 @@ static void _worker_schedule(hlt_worker_thread* current, hlt_worker_thread* targ
     }
 
     hlt_job* job = hlt_malloc(sizeof(hlt_job));
-    job->fiber = hlt_fiber_create(_worker_fiber_entry, _worker_get_ctx(target, vid), func, ctx);
+
+    // The target worker sets up a fiber once the job runs, if it needs
+    // one. That way only the worker itself ever touches its contexts.
+    job->fiber = 0;
+    job->func = func;
     job->vid = vid;
     job->tcontext_type = tcontext_type;
     job->tcontext = tcontext;
@@ -391,6 +508,12 @@ static void _debug_print_job_summary(hlt_thread_mgr* mgr)
         fprintf(stderr, "  %20s : ", "read");
         _debug_print_queue_stats(hlt_thread_queue_stats_reader(queue));
         fprintf(stderr, "  %20s : %" PRIu64 "   queue size: %" PRIu64 "  batches pending: %" PRIu64 "\n", "blocked jobs", kh_size(thread->jobs_blocked), hlt_thread_queue_size(thread->jobs), size);
+        fprintf(stderr, "  %20s : ticks=%" PRIu64 "  advanced=%" PRIu64 " (%.2f/tick)  pending=%" PRIu64 "\n", "timers",
+                thread->num_ticks, thread->num_advanced,
+                thread->num_ticks ? (double)thread->num_advanced / thread->num_ticks : 0.0,
+                (uint64_t)thread->num_deadlines);
+        fprintf(stderr, "  %20s : live=%" PRIu64 "  evicted=%" PRIu64 "\n", "contexts",
+                (uint64_t)kh_size(thread->vthreads), thread->num_evicted);
         for ( int j = 0; j < mgr->num_workers + 1; j++ ) {
             fprintf(stderr, "  %20s[%d] : ", (j==0 ? "writer-main" : "writer-worker"), j);
             _debug_print_queue_stats(hlt_thread_queue_stats_writer(queue, j));
@@ -419,11 +542,219 @@ void __hlt_thread_mgr_unblock(__hlt_thread_mgr_blockable *resource, hlt_executio
     _unblock_blocked(thread, resource, ctx);
 }
 
+// A worker keeps its virtual threads with pending timers in a min-heap
+// ordered by their next deadline. Each entry's vthread records its index in
+// the heap (plus one) so that an entry can be re-keyed or removed in place.
+
+// Swaps two heap entries, keeping their vthreads' positions up to date.
+static inline void _deadline_swap(hlt_worker_thread* thread, size_t i, size_t j)
+{
+    __hlt_vthread_deadline tmp = thread->deadlines[i];
+    thread->deadlines[i] = thread->deadlines[j];
+    thread->deadlines[j] = tmp;
+
+    thread->deadlines[i].vthread->deadline_pos = i + 1;
+    thread->deadlines[j].vthread->deadline_pos = j + 1;
+}
+
+static void _deadline_sift_up(hlt_worker_thread* thread, size_t i)
+{
+    while ( i > 0 ) {
+        size_t parent = (i - 1) / 2;
+
+        if ( thread->deadlines[parent].time <= thread->deadlines[i].time )
+            break;
+
+        _deadline_swap(thread, i, parent);
+        i = parent;
+    }
+}
+
+static void _deadline_sift_down(hlt_worker_thread* thread, size_t i)
+{
+    while ( 1 ) {
+        size_t l = 2 * i + 1;
+        size_t r = l + 1;
+        size_t m = i;
+
+        if ( l < thread->num_deadlines && thread->deadlines[l].time < thread->deadlines[m].time )
+            m = l;
+
+        if ( r < thread->num_deadlines && thread->deadlines[r].time < thread->deadlines[m].time )
+            m = r;
+
+        if ( m == i )
+            break;
+
+        _deadline_swap(thread, i, m);
+        i = m;
+    }
+}
+
+// Records a virtual thread's next timer deadline with its worker, with
+// zero meaning it has no timers pending anymore.
+static void _worker_set_deadline(hlt_worker_thread* thread, __hlt_vthread_state* vt, hlt_time t)
+{
+    size_t pos = vt->deadline_pos;
+
+    if ( ! t ) {
+        if ( ! pos )
+            return;
+
+        // Remove from the heap.
+        size_t i = pos - 1;
+        size_t last = --thread->num_deadlines;
+        vt->deadline_pos = 0;
+
+        if ( i == last )
+            return;
+
+        thread->deadlines[i] = thread->deadlines[last];
+        thread->deadlines[i].vthread->deadline_pos = i + 1;
+        _deadline_sift_down(thread, i);
+        _deadline_sift_up(thread, i);
+        return;
+    }
+
+    if ( ! pos ) {
+        // Add to the heap.
+        if ( thread->num_deadlines >= thread->max_deadlines ) {
+            size_t new_max = thread->max_deadlines * 2;
+            thread->deadlines = hlt_realloc(thread->deadlines, new_max * sizeof(__hlt_vthread_deadline), thread->max_deadlines * sizeof(__hlt_vthread_deadline));
+            thread->max_deadlines = new_max;
+        }
+
+        size_t i = thread->num_deadlines++;
+        thread->deadlines[i].time = t;
+        thread->deadlines[i].vthread = vt;
+        vt->deadline_pos = i + 1;
+        _deadline_sift_up(thread, i);
+        return;
+    }
+
+    // Update the existing entry.
+    size_t i = pos - 1;
+    hlt_time old = thread->deadlines[i].time;
+    thread->deadlines[i].time = t;
+
+    if ( t < old )
+        _deadline_sift_up(thread, i);
+    else
+        _deadline_sift_down(thread, i);
+}
+
+// Brings a context's timer manager up to the worker's global time before
+// running a job with it. We advance a context's timers only when one of
+// them is due, so its notion of time may be lagging.
+static void _worker_sync_time(hlt_worker_thread* thread, hlt_execution_context* ctx)
+{
+    hlt_exception* excpt = 0;
+
+    if ( ctx->vid == HLT_VID_MAIN || hlt_timer_mgr_current(ctx->tmgr, &excpt, ctx) >= thread->global_time )
+        return;
+
+    hlt_timer_mgr_advance(ctx->tmgr, thread->global_time, &excpt, ctx);
+
+    if ( excpt ) {
+        __hlt_thread_mgr_uncaught_exception_in_thread(excpt, ctx);
+        GC_DTOR(excpt, hlt_exception, ctx);
+    }
+}
+
+// Updates the worker's record of a virtual thread's next timer deadline
+// after its context may have (re-)scheduled or canceled timers. vt may be
+// null for jobs running with the global context.
+static void _worker_update_deadline(hlt_worker_thread* thread, __hlt_vthread_state* vt)
+{
+    if ( ! vt )
+        return;
+
+    _worker_set_deadline(thread, vt, __hlt_timer_mgr_next(vt->ctx->tmgr));
+}
+
+// Advances the time of all virtual threads that have timers due by the
+// given global time.
+static void _worker_advance_time(hlt_worker_thread* thread, hlt_time gt)
+{
+    thread->global_time = gt;
+    ++thread->num_ticks;
+
+    while ( thread->num_deadlines && thread->deadlines[0].time <= gt ) {
+        __hlt_vthread_state* vt = thread->deadlines[0].vthread;
+        hlt_execution_context* tctx = vt->ctx;
+        hlt_exception* excpt = 0;
+
+        DBG_LOG(DBG_STREAM, "advancing vid %" PRIu64 "'s time to %" PRIu64, tctx->vid, gt);
+
+        hlt_timer_mgr_advance(tctx->tmgr, gt, &excpt, tctx);
+        ++thread->num_advanced;
+
+        if ( excpt ) {
+            __hlt_thread_mgr_uncaught_exception_in_thread(excpt, tctx);
+            GC_DTOR(excpt, hlt_exception, tctx);
+        }
+
+        _worker_update_deadline(thread, vt);
+    }
+
+    _worker_evict_idle(thread, gt);
+}
+
+// Runs a job that doesn't need a fiber.
+static void _worker_run_job_direct(hlt_worker_thread* thread, __hlt_vthread_state* vt, hlt_execution_context* ctx, hlt_job* job)
+{
+    DBG_LOG(DBG_STREAM, "executing job %" PRIu64 " without fiber with context %p and thread context %p", job->id, ctx, job->tcontext);
+
+    hlt_exception* excpt = 0;
+
+    __hlt_context_set_fiber(ctx, 0);
+    __hlt_context_set_thread_context(ctx, job->tcontext_type, job->tcontext);
+
+    _worker_sync_time(thread, ctx);
+
+    HLT_CALLABLE_RUN(job->func, 0, Hilti_CallbackSchedule, &excpt, ctx);
+
+    if ( excpt ) {
+        __hlt_thread_mgr_uncaught_exception_in_thread(excpt, ctx);
+        GC_DTOR(excpt, hlt_exception, ctx);
+    }
+
+    // A fiber would take care of this when finishing; without one we need
+    // to do it ourselves.
+    __hlt_memory_safepoint(ctx, "job/no-fiber");
+
+    DBG_LOG(DBG_STREAM, "done with job %" PRIu64 "", job->id);
+
+    __hlt_context_set_thread_context(ctx, job->tcontext_type, 0);
+    _hlt_job_delete(job, ctx);
+
+    _worker_update_deadline(thread, vt);
+}
+
 static void _worker_run_job(hlt_worker_thread* thread, hlt_job* job)
 {
-    assert(job->fiber);
+    __hlt_vthread_state* vt = job->vid ? _worker_get_vthread(thread, job->vid) : 0;
+    hlt_execution_context* ctx = vt ? vt->ctx : hlt_global_execution_context();
+
+    if ( vt )
+        _worker_touch_vthread(thread, vt);
+
+    if ( ! job->fiber ) {
+        if ( ! job->func->__func->may_yield ) {
+            // The compiler has proven that the function never yields, so we
+            // can run it directly on the worker's stack and save setting up
+            // a fiber.
+            _worker_run_job_direct(thread, vt, ctx, job);
+            return;
+        }
 
-    hlt_execution_context* ctx = hlt_fiber_context(job->fiber);
+        job->fiber = hlt_fiber_create(_worker_fiber_entry, ctx, job->func, ctx);
+        job->func = 0;
+
+        // The context must stay around as long as the fiber does.
+        if ( vt )
+            ++vt->num_fibers;
+    }
 
     DBG_LOG(DBG_STREAM, "executing job %" PRIu64 " with context %p and thread context %p", job->id, ctx, job->tcontext);
 
@@ -432,6 +763,8 @@ static void _worker_run_job(hlt_worker_thread* thread, hlt_job* job)
     __hlt_context_set_fiber(ctx, job->fiber);
     __hlt_context_set_thread_context(ctx, job->tcontext_type, job->tcontext);
 
+    _worker_sync_time(thread, ctx);
+
     if ( hlt_fiber_start(job->fiber, ctx) == 0 ) {
         // Yield.
         DBG_LOG(DBG_STREAM, "vid %d is yielding", ctx->vid);
@@ -454,7 +787,12 @@ static void _worker_run_job(hlt_worker_thread* thread, hlt_job* job)
 
         job->fiber = 0; // This is deleted already.
         _hlt_job_delete(job, ctx);
+
+        if ( vt )
+            --vt->num_fibers;
     }
+
+    _worker_update_deadline(thread, vt);
 }
 
 // Entry function for the worker threads.
@@ -478,6 +816,11 @@ static void* _worker(void* worker_thread_ptr)
 
         hlt_job* job = hlt_thread_queue_read(thread->jobs, 10);
 
+        if ( ! job )
+            // Use the idle time to write out output that has been sitting
+            // around for too long.
+            __hlt_files_flush(thread->id, 1, hlt_global_execution_context());
+
         if ( mgr->state == HLT_THREAD_MGR_FINISH ) {
             // If the manager wants to finish once everybody is idle, check
             // whether we are idle. But even if, make sure we get whatever is
@@ -512,38 +855,14 @@ static void* _worker(void* worker_thread_ptr)
             finished = 1;
         }
 
-        hlt_time gt = __hlt_globals()->global_time;
-
-        for ( int i = 0; i < mgr->num_workers; ++i ) {
-            hlt_worker_thread* worker = mgr->workers[i];
-
-            hlt_thread_queue_writer_update(worker->jobs, thread->id);
-
-            // Advance all the virtual threads' time if the global one has
-            // changed.
-
-            if ( worker->global_time >= gt )
-                continue;
-
-            for ( int j = 1; j <= worker->max_vid; j++ ) {
-                hlt_execution_context* tctx = worker->ctxs[j];
-                hlt_exception* excpt = 0;
-
-                if ( ! tctx )
-                    continue;
+        for ( int i = 0; i < mgr->num_workers; ++i )
+            hlt_thread_queue_writer_update(mgr->workers[i]->jobs, thread->id);
 
-                DBG_LOG(DBG_STREAM, "advancing vid %" PRIu64 "'s time to %" PRIu64, tctx->vid, gt);
-
-                hlt_timer_mgr_advance(tctx->tmgr, gt, &excpt, tctx);
-
-                if ( excpt ) {
-                    __hlt_thread_mgr_uncaught_exception_in_thread(excpt, tctx);
-                    GC_DTOR(excpt, hlt_exception, tctx);
-                }
-            }
+        // Advance our virtual threads' time if the global one has changed.
+        hlt_time gt = __hlt_globals()->global_time;
 
-            worker->global_time = gt;
-        }
+        if ( thread->global_time < gt )
+            _worker_advance_time(thread, gt);
 
 #ifdef DEBUG
         hlt_thread_queue_size(thread->jobs);
@@ -560,7 +879,9 @@ static void* _worker(void* worker_thread_ptr)
 #endif
     }
 
-    // Signal the command queue that we're done.
+    // Signal the command queue that we're done, after handing over any
+    // output still buffered.
+    __hlt_files_flush(thread->id, 0, hlt_global_execution_context());
     __hlt_cmd_worker_terminating(thread->id);
 
     for ( int i = 0; i < mgr->num_workers; ++i )
@@ -726,9 +1047,16 @@ void hlt_thread_mgr_start(hlt_thread_mgr* mgr)
         // scheduler will deadlock when blocking because each thread is both
         // reader and writer.
         thread->jobs = hlt_thread_queue_new(hlt_config_get()->num_workers + 1, QUEUE_BATCH_SIZE, 0);
-        thread->ctxs = hlt_calloc(3, sizeof(hlt_execution_context*));
-        thread->max_vid = 2;
+        thread->vthreads = kh_init(vthreads);
+        thread->lru_head = 0;
+        thread->lru_tail = 0;
         thread->global_time = 0;
+        thread->max_deadlines = 16;
+        thread->num_deadlines = 0;
+        thread->deadlines = hlt_malloc(thread->max_deadlines * sizeof(__hlt_vthread_deadline));
+        thread->num_ticks = 0;
+        thread->num_advanced = 0;
+        thread->num_evicted = 0;
         thread->fiber_pool = __hlt_fiber_pool_new();
         thread->id = i + 1; // We leave zero for the main thread so that we can use that as its writer id.
         thread->idle = 0;
@@ -799,11 +1127,17 @@ void __hlt_thread_mgr_schedule(hlt_thread_mgr* mgr, hlt_vthread_id vid, hlt_call
 
     hlt_worker_thread* thread = _vthread_to_worker(mgr, vid);
     _worker_schedule(ctx->worker, thread, vid, func, 0, 0, ctx);
+
+    if ( ctx->vid == HLT_VID_MAIN )
+        __hlt_files_flush_main(ctx);
 }
 
-void __hlt_thread_mgr_schedule_tcontext(hlt_thread_mgr* mgr, hlt_type_info* type, void* tcontext, hlt_callable* func, hlt_exception** excpt, hlt_execution_context* ctx)
+static void _schedule_tcontext(hlt_thread_mgr* mgr, hlt_type_info* type, void* tcontext, hlt_callable* func, int8_t transfer, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     if ( ! hlt_is_multi_threaded() ) {
+        if ( transfer )
+            GC_DTOR_GENERIC(&tcontext, type, ctx);
+
         hlt_set_exception(excpt, &hlt_exception_no_threading, 0, ctx);
         return;
     }
@@ -825,8 +1159,26 @@ void __hlt_thread_mgr_schedule_tcontext(hlt_thread_mgr* mgr, hlt_type_info* type
     hlt_worker_thread* thread = _vthread_to_worker(mgr, scaled_vid);
 
     void* cloned_tcontext;
-    hlt_clone_deep(&cloned_tcontext, type, &tcontext, excpt, ctx);
+
+    if ( transfer )
+        hlt_clone_transfer(&cloned_tcontext, type, &tcontext, scaled_vid, excpt, ctx);
+    else
+        hlt_clone_deep(&cloned_tcontext, type, &tcontext, excpt, ctx);
+
     _worker_schedule(ctx->worker, thread, scaled_vid, func, type, cloned_tcontext, ctx);
+
+    if ( ctx->vid == HLT_VID_MAIN )
+        __hlt_files_flush_main(ctx);
+}
+
+void __hlt_thread_mgr_schedule_tcontext(hlt_thread_mgr* mgr, hlt_type_info* type, void* tcontext, hlt_callable* func, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    _schedule_tcontext(mgr, type, tcontext, func, 0, excpt, ctx);
+}
+
+void __hlt_thread_mgr_schedule_tcontext_transfer(hlt_thread_mgr* mgr, hlt_type_info* type, void* tcontext, hlt_callable* func, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    _schedule_tcontext(mgr, type, tcontext, func, 1, excpt, ctx);
 }
 
 const char* hlt_thread_mgr_current_native_thread()
@@ -10,6 +10,7 @@
 #include "time_.h"
 
 struct __kh_blocked_jobs_t;
+struct __kh_vthreads_t;
 
 /// Returns whether the HILTI runtime environment is configured for running
 /// multiple threads.
@@ -58,7 +59,8 @@ struct __hlt_thread_mgr_blockable {
 
 // A job queued for execution.
 typedef struct __hlt_job {
-    hlt_fiber* fiber;         // The fiber for running this job.
+    hlt_fiber* fiber;         // The fiber for running this job, or null if it doesn't need one.
+    hlt_callable* func;       // If running without fiber, the function to execute.
     hlt_vthread_id vid;       // The virtual thread the job is scheduled to.
     hlt_type_info* tcontext_type; // The type of the thread context.
     void* tcontext;           // The jobs thread context to use when executing.
@@ -69,15 +71,45 @@ typedef struct __hlt_job {
 } hlt_job;
 
 
+// A worker's state for one of its virtual threads. Entries exist only for
+// virtual threads that have run a job since the worker last evicted them.
+typedef struct __hlt_vthread_state {
+    hlt_execution_context* ctx;   // The virtual thread's execution context.
+    size_t deadline_pos;          // Position plus one in the worker's deadline heap; zero if not in there.
+    uint64_t num_fibers;          // Number of the vthread's jobs holding a fiber that runs with ctx.
+    hlt_time last_active;         // Global time when a job last ran.
+    struct __hlt_vthread_state* prev; // Neighbors in the worker's list ordered by last activity.
+    struct __hlt_vthread_state* next;
+} __hlt_vthread_state;
+
+// The time a virtual thread's earliest timer expires, as tracked by its
+// worker.
+typedef struct {
+    hlt_time time;                // Expiration time of the vthread's next timer.
+    __hlt_vthread_state* vthread; // The virtual thread.
+} __hlt_vthread_deadline;
+
 // A struct that encapsulates data related to a single worker thread.
 typedef struct __hlt_worker_thread {
     // Accesses to these must only be made from the worker thread itself.
     hlt_thread_mgr* mgr;          // The manager this thread is part of.
-    hlt_execution_context** ctxs; // Execution contexts indexed by virtual thread id.
-    hlt_vthread_id max_vid;       // Largest vid allocated space for in ctxs.
+    struct __kh_vthreads_t* vthreads; // Hash table of __hlt_vthread_state indexed by virtual thread id.
+    __hlt_vthread_state* lru_head; // Virtual thread that has been idle the longest.
+    __hlt_vthread_state* lru_tail; // Virtual thread that has run a job most recently.
     hlt_time global_time;         // Last global time all virtual threads have been advanced to.
     __hlt_fiber_pool* fiber_pool; // The pool of available fiber objects for this worker.
 
+    // Min-heap of the next timer deadlines of all virtual threads that have
+    // timers pending, so that advancing time touches only those due.
+    __hlt_vthread_deadline* deadlines; // The heap.
+    size_t num_deadlines;         // Number of entries in the heap.
+    size_t max_deadlines;         // Number of entries allocated for the heap.
+
+    // Statistics. These may be read from other threads for debugging output.
+    uint64_t num_ticks;           // Number of times the global time has advanced.
+    uint64_t num_advanced;        // Number of contexts whose timers have been advanced across all ticks.
+    uint64_t num_evicted;         // Number of idle contexts deleted.
+
     // This can be *read* from different threads without further locking.
     int id;                       // ID of this worker thread in the range 1..*num_workers*.
     char* name;                   // A string identifying the worker.
@@ -233,6 +265,28 @@ extern void __hlt_thread_mgr_schedule(hlt_thread_mgr* mgr, hlt_vthread_id vid, h
 /// excpt: &
 extern void __hlt_thread_mgr_schedule_tcontext(hlt_thread_mgr* mgr, hlt_type_info* type, void* tcontext, hlt_callable* func, hlt_exception** excpt, hlt_execution_context* ctx);
 
+/// Schedules a job to a virtual thread determined by an object's hash,
+/// moving the thread context over instead of deep-copying it where
+/// possible.
+///
+/// This works like __hlt_thread_mgr_schedule_tcontext() except that the
+/// thread context is passed at +1, and ownership of it moves to the target
+/// thread via hlt_clone_transfer(). The code generator uses this for
+/// contexts that it has freshly built for the job.
+///
+/// mgr: The thread manager to use.
+///
+/// type: The type of the thread context to be hashed (i.e., *tcontext*).
+///
+/// tcontext: The thread context for the job, at +1. (!)
+///
+/// cont: The continuation representing a bound function, at +1. (!)
+///
+/// ctx: The caller's execution context.
+///
+/// excpt: &
+extern void __hlt_thread_mgr_schedule_tcontext_transfer(hlt_thread_mgr* mgr, hlt_type_info* type, void* tcontext, hlt_callable* func, hlt_exception** excpt, hlt_execution_context* ctx);
+
 /// Checks whether any worker thread has raised an uncaught exception. In
 /// that case, all worker threads will have been terminated, and this
 /// function willl raise an hlt_exception_uncaught_thread_exception.
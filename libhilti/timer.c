@@ -1,5 +1,6 @@
 
 #include "callable.h"
+#include "file.h"
 #include "int.h"
 #include "string_.h"
 #include "timer.h"
@@ -250,6 +251,8 @@ void hlt_timer_mgr_advance_global(hlt_time t, hlt_exception** excpt, hlt_executi
 
     if ( t > __hlt_globals()->global_time )
         __hlt_globals()->global_time = t;
+
+    __hlt_files_flush_main(ctx);
 }
 
 static inline void _hlt_timer_mgr_init(hlt_timer_mgr* mgr, hlt_exception** excpt, hlt_execution_context* ctx)
@@ -323,6 +326,12 @@ int32_t hlt_timer_mgr_advance(hlt_timer_mgr* mgr, hlt_time t, hlt_exception** ex
     return count;
 }
 
+hlt_time __hlt_timer_mgr_next(hlt_timer_mgr* mgr)
+{
+    hlt_timer* timer = (hlt_timer*) priority_queue_peek(mgr->timers);
+    return timer ? timer->time : 0;
+}
+
 hlt_time hlt_timer_mgr_current(hlt_timer_mgr* mgr, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     if ( ! mgr )
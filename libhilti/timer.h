@@ -248,5 +248,13 @@ extern hlt_timer* __hlt_timer_new_set(__hlt_set_timer_cookie cookie, hlt_excepti
 /// Returns: The new timer object.
 extern hlt_timer* __hlt_timer_new_profiler(__hlt_profiler_timer_cookie cookie, hlt_exception** excpt, hlt_execution_context* ctx);
 
+/// Returns the expiration time of the next timer scheduled with a timer
+/// manager.
+///
+/// mgr: The timer manager.
+///
+/// Returns: The time of the earliest timer, or zero if none is scheduled.
+extern hlt_time __hlt_timer_mgr_next(hlt_timer_mgr* mgr);
+
 
 #endif
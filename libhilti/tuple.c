@@ -56,6 +56,18 @@ void hlt_tuple_clone_init(void* dstp, const hlt_type_info* ti, void* srcp, __hlt
     }
 }
 
+void __hlt_tuple_transfer(const hlt_type_info* ti, void* obj, __hlt_transfer_callback cb, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    hlt_type_info** types = (hlt_type_info**) &ti->type_params;
+    struct _element* elements = (struct _element *)ti->aux;
+
+    for ( int i = 0; i < ti->num_params; i++ ) {
+        (*cb)((char*)obj + elements[i].offset, types[i], cstate, excpt, ctx);
+        if ( hlt_check_exception(excpt) )
+            return;
+    }
+}
+
 hlt_string hlt_tuple_to_string(const hlt_type_info* type, void* obj, int32_t options, __hlt_pointer_stack* seen, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     hlt_string postfix = hlt_string_from_asciiz(")", excpt, ctx);
@@ -6,6 +6,7 @@
 #define LIBHILTI_TUPLE_H
 
 #include "types.h"
+#include "clone.h"
 
 /// Meta-information about a tuple element.
 typedef struct {
@@ -45,6 +46,18 @@ extern hlt_tuple_element hlt_tuple_get_type(const hlt_type_info* type, int index
 /// \hlt_to_string
 extern hlt_string hlt_tuple_to_string(const hlt_type_info* type, void* obj, int32_t options, __hlt_pointer_stack* seen, hlt_exception** excpt, hlt_execution_context* ctx);
 
+/// Internal function that calls a transfer callback for each element of a
+/// tuple being moved to a different thread by hlt_clone_transfer().
+///
+/// type: The type of the tuple.
+///
+/// obj: A pointer to the tuple.
+///
+/// cb: The callback to run for each element.
+///
+/// cstate: The transfer's state, to be passed on to the callback.
+extern void __hlt_tuple_transfer(const hlt_type_info* type, void* obj, __hlt_transfer_callback cb, __hlt_clone_state* cstate, hlt_exception** excpt, hlt_execution_context* ctx);
+
 #endif
 
 
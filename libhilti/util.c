@@ -15,6 +15,7 @@
 #include "threading.h"
 #include "globals.h"
 #include "memory_.h"
+#include "config.h"
 
 void hlt_util_nanosleep(uint64_t nsecs)
 {
@@ -187,17 +188,128 @@ hlt_hash hlt_hash_object(const hlt_type_info* type, const void* obj, int32_t opt
     return (*type->hash)(type, obj, excpt, ctx);
 }
 
-hlt_hash hlt_hash_bytes(const int8_t *s, int16_t len, hlt_hash prev_hash)
+// The hash function is SipHash-1-3 (Aumasson & Bernstein), i.e., SipHash
+// with one compression and three finalization rounds. It processes eight
+// bytes at a time, and the per-process key makes collisions unpredictable
+// for anybody not knowing the key.
+
+#define _ROTL(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
+
+#define _SIPROUND(st) \
+    do { \
+        st->v0 += st->v1; st->v1 = _ROTL(st->v1, 13); st->v1 ^= st->v0; st->v0 = _ROTL(st->v0, 32); \
+        st->v2 += st->v3; st->v3 = _ROTL(st->v3, 16); st->v3 ^= st->v2; \
+        st->v0 += st->v3; st->v3 = _ROTL(st->v3, 21); st->v3 ^= st->v0; \
+        st->v2 += st->v1; st->v1 = _ROTL(st->v1, 17); st->v1 ^= st->v2; st->v2 = _ROTL(st->v2, 32); \
+    } while ( 0 )
+
+static inline void _hash_begin(hlt_hash_state* st, uint64_t k0, uint64_t k1)
+{
+    st->v0 = 0x736f6d6570736575ULL ^ k0;
+    st->v1 = 0x646f72616e646f6dULL ^ k1;
+    st->v2 = 0x6c7967656e657261ULL ^ k0;
+    st->v3 = 0x7465646279746573ULL ^ k1;
+    st->tail = 0;
+    st->len = 0;
+}
+
+static inline void _hash_word(hlt_hash_state* st, uint64_t m)
 {
-    // This is copied and adapted from hhash.h
-    if ( ! len )
-        return 0;
+    st->v3 ^= m;
+    _SIPROUND(st);
+    st->v0 ^= m;
+}
+
+static inline uint64_t _load_le64(const uint8_t* p)
+{
+    uint64_t m;
+    memcpy(&m, p, sizeof(m));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    m = __builtin_bswap64(m);
+#endif
+    return m;
+}
 
-	hlt_hash h = prev_hash;
-    while ( len-- )
-        h = (h << 5) - h + *s++;
+static uint64_t _splitmix64(uint64_t* x)
+{
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+void __hlt_hash_init()
+{
+    __hlt_global_state* globals = __hlt_globals();
+    uint64_t seed = globals->config->hash_seed;
+
+    if ( ! seed ) {
+        FILE* rnd = fopen("/dev/urandom", "r");
+
+        if ( ! rnd || fread(&seed, sizeof(seed), 1, rnd) != 1 )
+            // Not great, but better than nothing.
+            seed = (uint64_t)time(0) ^ ((uint64_t)getpid() << 32) ^ (uint64_t)(uintptr_t)&seed;
+
+        if ( rnd )
+            fclose(rnd);
+    }
+
+    globals->hash_key[0] = _splitmix64(&seed);
+    globals->hash_key[1] = _splitmix64(&seed);
+}
+
+void hlt_hash_bytes_begin(hlt_hash_state* state)
+{
+    const uint64_t* key = __hlt_globals()->hash_key;
+    _hash_begin(state, key[0], key[1]);
+}
+
+void hlt_hash_bytes_update(hlt_hash_state* state, const int8_t* s, uint64_t len)
+{
+    const uint8_t* p = (const uint8_t*)s;
+    unsigned int ntail = state->len & 7;
+
+    state->len += len;
+
+    if ( ntail ) {
+        // Complete the word left over from the previous chunk first.
+        for ( ; ntail < 8 && len; --len )
+            state->tail |= ((uint64_t)*p++) << (8 * ntail++);
+
+        if ( ntail < 8 )
+            return;
+
+        _hash_word(state, state->tail);
+        state->tail = 0;
+    }
+
+    for ( ; len >= 8; p += 8, len -= 8 )
+        _hash_word(state, _load_le64(p));
+
+    for ( ntail = 0; len; --len )
+        state->tail |= ((uint64_t)*p++) << (8 * ntail++);
+}
+
+hlt_hash hlt_hash_bytes_end(hlt_hash_state* state)
+{
+    _hash_word(state, (state->len << 56) | state->tail);
+
+    state->v2 ^= 0xff;
+    _SIPROUND(state);
+    _SIPROUND(state);
+    _SIPROUND(state);
+
+    return state->v0 ^ state->v1 ^ state->v2 ^ state->v3;
+}
+
+hlt_hash hlt_hash_bytes(const int8_t *s, uint64_t len, hlt_hash prev_hash)
+{
+    const uint64_t* key = __hlt_globals()->hash_key;
 
-	return h;
+    hlt_hash_state state;
+    _hash_begin(&state, key[0] ^ prev_hash, key[1]);
+    hlt_hash_bytes_update(&state, s, len);
+    return hlt_hash_bytes_end(&state);
 }
 
 hlt_hash hlt_default_hash(const hlt_type_info* type, const void* obj, hlt_exception** excpt, hlt_execution_context* ctx)
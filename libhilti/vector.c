@@ -4,6 +4,8 @@
 //
 
 #include <stdio.h>
+#include <string.h>
+#include <assert.h>
 
 #include "autogen/hilti-hlt.h"
 #include "type-info.h"
@@ -12,6 +14,8 @@
 #include "interval.h"
 #include "enum.h"
 #include "int.h"
+#include "bytes.h"
+#include "rtti.h"
 
 #include <string.h>
 
@@ -71,6 +75,16 @@ static inline void _access_entry(hlt_vector* v, hlt_vector_idx i, hlt_exception*
     hlt_timer_update(v->timers[i], t, excpt, ctx);
 }
 
+static inline void _start_timer(hlt_vector* v, hlt_vector_idx i, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    GC_CCTOR(v, hlt_vector, ctx);
+    __hlt_vector_timer_cookie cookie = { v, i };
+    v->timers[i] = __hlt_timer_new_vector(cookie, excpt, ctx); // Not memory-managed on our end.
+    hlt_time t = hlt_timer_mgr_current(v->tmgr, excpt, ctx) + v->timeout;
+    hlt_timer_mgr_schedule(v->tmgr, t, v->timers[i], excpt, ctx);
+    GC_DTOR(v->timers[i], hlt_timer, ctx); // Not memory-managed on our end.
+}
+
 // Val is not yet ref'ed.
 static inline void _set_entry(hlt_vector* v, hlt_vector_idx i, void *val, int dtor, hlt_exception** excpt, hlt_execution_context* ctx)
 {
@@ -89,14 +103,8 @@ static inline void _set_entry(hlt_vector* v, hlt_vector_idx i, void *val, int dt
     GC_CCTOR_GENERIC(dst, v->type, ctx);
 
     // Start timer if needed.
-    if ( v->tmgr && v->timeout ) {
-        GC_CCTOR(v, hlt_vector, ctx);
-        __hlt_vector_timer_cookie cookie = { v, i };
-        v->timers[i] = __hlt_timer_new_vector(cookie, excpt, ctx); // Not memory-managed on our end.
-        hlt_time t = hlt_timer_mgr_current(v->tmgr, excpt, ctx) + v->timeout;
-        hlt_timer_mgr_schedule(v->tmgr, t, v->timers[i], excpt, ctx);
-        GC_DTOR(v->timers[i], hlt_timer, ctx); // Not memory-managed on our end.
-    }
+    if ( v->tmgr && v->timeout )
+        _start_timer(v, i, excpt, ctx);
 }
 
 static inline void _hlt_vector_init(hlt_vector* v, const hlt_type_info* elemtype, const void* def, struct __hlt_timer_mgr* tmgr, hlt_exception** excpt, hlt_execution_context* ctx)
@@ -282,6 +290,154 @@ void hlt_vector_push_back(hlt_vector* v, const hlt_type_info* elemtype, void* va
     _set_entry(v, v->last, val, 0, excpt, ctx);
 }
 
+// Copies n integers of the given width from src to dst, reversing the bytes
+// of each if swap is set. The loops are kept trivial so that the compiler
+// can vectorize them.
+static void _copy_ints(int8_t* dst, const int8_t* src, int64_t n, int width, int swap)
+{
+    if ( ! swap || width == 1 ) {
+        memcpy(dst, src, n * width);
+        return;
+    }
+
+    switch ( width ) {
+     case 2: {
+         uint16_t* d = (uint16_t*)dst;
+         for ( int64_t i = 0; i < n; i++ ) {
+             uint16_t x;
+             memcpy(&x, src + i * 2, 2);
+             d[i] = __builtin_bswap16(x);
+         }
+         break;
+     }
+
+     case 4: {
+         uint32_t* d = (uint32_t*)dst;
+         for ( int64_t i = 0; i < n; i++ ) {
+             uint32_t x;
+             memcpy(&x, src + i * 4, 4);
+             d[i] = __builtin_bswap32(x);
+         }
+         break;
+     }
+
+     case 8: {
+         uint64_t* d = (uint64_t*)dst;
+         for ( int64_t i = 0; i < n; i++ ) {
+             uint64_t x;
+             memcpy(&x, src + i * 8, 8);
+             d[i] = __builtin_bswap64(x);
+         }
+         break;
+     }
+
+     default:
+        assert(0);
+    }
+}
+
+void hlt_vector_push_back_unpacked(hlt_vector* v, hlt_iterator_bytes begin, hlt_iterator_bytes end, hlt_enum byte_order, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    assert(v->type->type == HLT_TYPE_INTEGER);
+
+    int width = v->type->size;
+    int swap = 0;
+
+    if ( hlt_enum_equal(byte_order, Hilti_ByteOrder_Big, excpt, ctx) ) {
+#if ! __BIG_ENDIAN__
+        swap = 1;
+#endif
+    }
+
+    else if ( hlt_enum_equal(byte_order, Hilti_ByteOrder_Little, excpt, ctx) ) {
+#if __BIG_ENDIAN__
+        swap = 1;
+#endif
+    }
+
+    else if ( ! hlt_enum_equal(byte_order, Hilti_ByteOrder_Host, excpt, ctx) ) {
+        hlt_set_exception(excpt, &hlt_exception_value_error, 0, ctx);
+        return;
+    }
+
+    hlt_vector_idx n = hlt_iterator_bytes_diff(begin, end, excpt, ctx) / width;
+
+    if ( ! n )
+        return;
+
+    hlt_vector_idx first = v->last + 1;
+
+    if ( first + n > v->capacity ) {
+        hlt_vector_idx c = (v->capacity + 1) * GrowthFactor;
+        hlt_vector_reserve(v, (first + n > c ? first + n : c), excpt, ctx);
+    }
+
+    // Walk the raw blocks. An element may straddle two of them; we collect
+    // those in a small buffer first.
+    int8_t* dst = v->elems + first * width;
+    hlt_bytes_size todo = n * width;
+    int8_t partial[8];
+    int npartial = 0;
+
+    hlt_bytes_block block;
+    void* cookie = 0;
+
+    do {
+        cookie = hlt_bytes_iterate_raw(&block, cookie, begin, end, excpt, ctx);
+
+        if ( *excpt )
+            return;
+
+        const int8_t* p = block.start;
+        hlt_bytes_size avail = block.end - block.start;
+
+        if ( avail > todo )
+            avail = todo;
+
+        todo -= avail;
+
+        if ( npartial ) {
+            int k = (avail < width - npartial ? avail : width - npartial);
+            memcpy(partial + npartial, p, k);
+            npartial += k;
+            p += k;
+            avail -= k;
+
+            if ( npartial == width ) {
+                _copy_ints(dst, partial, 1, width, swap);
+                dst += width;
+                npartial = 0;
+            }
+        }
+
+        hlt_bytes_size m = avail / width;
+        _copy_ints(dst, p, m, width, swap);
+        dst += m * width;
+        p += m * width;
+        avail -= m * width;
+
+        if ( avail ) {
+            memcpy(partial, p, avail);
+            npartial = avail;
+        }
+
+    } while ( cookie && todo );
+
+    assert(! todo && ! npartial);
+
+    v->last = first + n - 1;
+
+    if ( ! v->timers )
+        return;
+
+    for ( hlt_vector_idx i = first; i <= v->last; i++ ) {
+        v->timers[i] = 0;
+
+        if ( v->tmgr && v->timeout )
+            _start_timer(v, i, excpt, ctx);
+    }
+}
+
 hlt_vector_idx hlt_vector_size(hlt_vector* v, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     return v->last + 1;
@@ -316,6 +472,31 @@ void hlt_vector_reserve(hlt_vector* v, hlt_vector_idx n, hlt_exception** excpt,
     v->capacity = n;
 }
 
+void __hlt_vector_resize(hlt_vector* v, hlt_vector_idx n, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    hlt_vector_reserve(v, n, excpt, ctx);
+
+    for ( hlt_vector_idx j = v->last + 1; j < n; j++ ) {
+        void* dst = v->elems + j * v->type->size;
+        hlt_clone_deep(dst, v->type, v->def, excpt, ctx);
+
+        if ( v->tmgr )
+            v->timers[j] = 0;
+    }
+
+    for ( hlt_vector_idx j = n; j <= v->last; j++ ) {
+        if ( v->tmgr && v->timers[j] ) {
+            hlt_timer_cancel(v->timers[j], excpt, ctx);
+            v->timers[j] = 0;
+        }
+
+        void* dst = v->elems + j * v->type->size;
+        GC_DTOR_GENERIC(dst, v->type, ctx);
+    }
+
+    v->last = n - 1;
+}
+
 hlt_iterator_vector hlt_vector_begin(hlt_vector* v, hlt_exception** excpt, hlt_execution_context* ctx)
 {
     hlt_iterator_vector i;
@@ -16,6 +16,7 @@ struct __hlt_iterator_vector {
 };
 
 struct __hlt_timer_mgr;
+struct hlt_iterator_bytes;
 
 /// Cookie for entry expiration timers.
 typedef struct __hlt_iterator_vector __hlt_vector_timer_cookie;
@@ -36,6 +37,14 @@ extern void hlt_vector_set(hlt_vector* v, hlt_vector_idx i, const hlt_type_info*
 // Appends the element to the vector.
 extern void hlt_vector_push_back(hlt_vector* v, const hlt_type_info* elemtype, void* val, hlt_exception** excpt, hlt_execution_context* ctx);
 
+// Appends integers unpacked from the raw bytes between begin and end to the
+// vector, which must have elements of an integer type. Each element takes as
+// many bytes as its width; trailing bytes not making up a full element are
+// ignored. The caller must make sure that all the input is available. This
+// is the same as unpacking each integer in the given byte order and
+// appending it with hlt_vector_push_back(), just faster.
+extern void hlt_vector_push_back_unpacked(hlt_vector* v, struct hlt_iterator_bytes begin, struct hlt_iterator_bytes end, hlt_enum byte_order, hlt_exception** excpt, hlt_execution_context* ctx);
+
 // Returns the size of the vector (i.e., the largest valid index + 1 )
 extern hlt_vector_idx hlt_vector_size(hlt_vector* v, hlt_exception** excpt, hlt_execution_context* ctx);
 
@@ -44,6 +53,11 @@ extern hlt_vector_idx hlt_vector_size(hlt_vector* v, hlt_exception** excpt, hlt_
 // mainly a hint to avoid unnecessary reallocation.
 extern void hlt_vector_reserve(hlt_vector* v, hlt_vector_idx n, hlt_exception** excpt, hlt_execution_context* ctx);
 
+// Changes the size of the vector to n elements. If that grows the vector,
+// the new elements are set to the default; if it shrinks the vector, the
+// removed elements are released.
+extern void __hlt_vector_resize(hlt_vector* v, hlt_vector_idx n, hlt_exception** excpt, hlt_execution_context* ctx);
+
 // Returns an iterator positioned at the first element.
 extern hlt_iterator_vector hlt_vector_begin(hlt_vector* v, hlt_exception** excpt, hlt_execution_context* ctx);
 
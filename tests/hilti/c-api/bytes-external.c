@@ -0,0 +1,66 @@
+/*
+
+@TEST-EXEC:  hilti-build %INPUT -o a.out
+@TEST-EXEC:  ./a.out >output 2>&1
+@TEST-EXEC:  btest-diff output
+
+*/
+
+// Bytes objects referencing external data, as used by packet rings: they
+// don't copy the data until the owner asks them to, refuse to once
+// iterators point into it, and let the owner know when they go away.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <libhilti.h>
+
+static void printb(const char* prefix, hlt_bytes* b, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    hlt_string s = hlt_object_to_string(&hlt_type_info_hlt_bytes, &b, 0, excpt, ctx);
+    printf("%s: %.*s\n", prefix, (int)s->len, s->bytes);
+}
+
+int main()
+{
+    hlt_init();
+
+    hlt_execution_context* ctx = hlt_global_execution_context();
+    hlt_exception* excpt = 0;
+
+    int8_t data[] = "abcdef";
+    hlt_bytes* slot1 = 0;
+    hlt_bytes* slot2 = 0;
+
+    hlt_bytes* b1 = __hlt_bytes_new_external(data, 6, &slot1, ctx);
+    GC_CCTOR(b1, hlt_bytes, ctx);
+
+    hlt_bytes* b2 = __hlt_bytes_new_external(data, 3, &slot2, ctx);
+    GC_CCTOR(b2, hlt_bytes, ctx);
+
+    printf("slots set: %d %d\n", slot1 == b1, slot2 == b2);
+
+    // Not copied yet.
+    data[0] = 'A';
+    printb("b1", b1, &excpt, ctx);
+
+    // Copies, and the owner's changes don't show anymore.
+    printf("detach b1: %d, slot cleared: %d\n", __hlt_bytes_detach(b1, ctx), slot1 == 0);
+    data[1] = 'B';
+    printb("b1", b1, &excpt, ctx);
+
+    // Iterators pin the data.
+    hlt_iterator_bytes i = hlt_bytes_begin(b2, &excpt, ctx);
+    printf("detach b2: %d, slot cleared: %d\n", __hlt_bytes_detach(b2, ctx), slot2 == 0);
+    printf("deref: %c\n", hlt_iterator_bytes_deref(i, &excpt, ctx));
+
+    // Going away clears the slot.
+    GC_DTOR(b2, hlt_bytes, ctx);
+    hlt_memory_safepoint(ctx);
+    printf("b2 gone, slot cleared: %d\n", slot2 == 0);
+
+    GC_DTOR(b1, hlt_bytes, ctx);
+    printf("exception: %s\n", excpt ? "yes" : "no");
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+/*
+
+@TEST-EXEC:  hilti-build %INPUT -o a.out
+@TEST-EXEC:  ./a.out >output 2>&1
+@TEST-EXEC:  btest-diff output
+
+*/
+
+// Transferring a value to another thread moves what's safe to move and
+// copies the rest.
+
+#include <stdio.h>
+
+#include <libhilti.h>
+
+int main()
+{
+    hlt_init();
+
+    hlt_execution_context* ctx = hlt_global_execution_context();
+    hlt_exception* excpt = 0;
+
+    // Strings are immutable and can be handed over as they are.
+    hlt_string s = hlt_string_from_asciiz("abc", &excpt, ctx);
+    GC_CCTOR(s, hlt_string, ctx);
+
+    hlt_string s2 = 0;
+    hlt_clone_transfer(&s2, &hlt_type_info_hlt_string, &s, 1, &excpt, ctx);
+    printf("string: %s\n", s2 == s ? "moved" : "copied");
+    GC_DTOR(s2, hlt_string, ctx);
+
+    // Bytes consisting only of their own data move, however many chunks
+    // they have.
+    hlt_bytes* b = hlt_bytes_new_from_data_copy((int8_t*)"12345", 5, &excpt, ctx);
+    hlt_bytes_append_raw_copy(b, (int8_t*)"6789", 4, &excpt, ctx);
+    GC_CCTOR(b, hlt_bytes, ctx);
+
+    hlt_bytes* b2 = 0;
+    hlt_clone_transfer(&b2, &hlt_type_info_hlt_bytes, &b, 1, &excpt, ctx);
+    printf("bytes: %s, len %ld\n", b2 == b ? "moved" : "copied", (long)hlt_bytes_len(b2, &excpt, ctx));
+    GC_DTOR(b2, hlt_bytes, ctx);
+
+    // Bytes sharing their data with another object get copied.
+    hlt_bytes* whole = hlt_bytes_new_from_data_copy((int8_t*)"abcdef", 6, &excpt, ctx);
+    GC_CCTOR(whole, hlt_bytes, ctx);
+
+    hlt_bytes* part = hlt_bytes_sub(hlt_bytes_offset(whole, 1, &excpt, ctx), hlt_bytes_offset(whole, 4, &excpt, ctx), &excpt, ctx);
+    GC_CCTOR(part, hlt_bytes, ctx);
+
+    hlt_bytes* part2 = 0;
+    hlt_clone_transfer(&part2, &hlt_type_info_hlt_bytes, &part, 1, &excpt, ctx);
+    printf("shared bytes: %s, len %ld\n", part2 == part ? "moved" : "copied", (long)hlt_bytes_len(part2, &excpt, ctx));
+    GC_DTOR(part2, hlt_bytes, ctx);
+    GC_DTOR(whole, hlt_bytes, ctx);
+
+    // Bytes with a separator object may refer to further objects, so they
+    // get copied.
+    int64_t i = 42;
+    hlt_bytes* o = hlt_bytes_new_from_data_copy((int8_t*)"xy", 2, &excpt, ctx);
+    hlt_bytes_append_object(o, &hlt_type_info_hlt_int_64, &i, &excpt, ctx);
+    GC_CCTOR(o, hlt_bytes, ctx);
+
+    hlt_bytes* o2 = 0;
+    hlt_clone_transfer(&o2, &hlt_type_info_hlt_bytes, &o, 1, &excpt, ctx);
+    printf("bytes with object: %s\n", o2 == o ? "moved" : "copied");
+    GC_DTOR(o2, hlt_bytes, ctx);
+
+    // Null stays null.
+    hlt_bytes* n = 0;
+    hlt_bytes* n2 = (hlt_bytes*)1;
+    hlt_clone_transfer(&n2, &hlt_type_info_hlt_bytes, &n, 1, &excpt, ctx);
+    printf("null: %s\n", n2 ? "not null" : "null");
+
+    printf("exception: %s\n", excpt ? "yes" : "no");
+
+    return 0;
+}
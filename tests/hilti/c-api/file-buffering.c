@@ -0,0 +1,109 @@
+/*
+
+@TEST-EXEC:  hilti-build -P file-buffering.hlt
+@TEST-EXEC:  hilti-build %INPUT file-buffering.hlt -o a.out
+@TEST-EXEC:  ./a.out >output 2>&1
+@TEST-EXEC:  btest-diff output
+@TEST-EXEC:  btest-diff output.log
+
+*/
+
+// File output stays buffered until the buffer fills up, the flush interval
+// passes, or the file gets closed. Without worker threads, what gets handed
+// over for writing reaches the file right away, so we can watch it grow.
+
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <libhilti.h>
+
+#include "file-buffering.hlt.h"
+
+static long file_size(const char* path)
+{
+    struct stat st;
+
+    if ( stat(path, &st) < 0 )
+        return -1;
+
+    return (long)st.st_size;
+}
+
+static void write_line(const char* s, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    hlt_string str = hlt_string_from_asciiz(s, excpt, ctx);
+    test_write_log(str, excpt, ctx);
+}
+
+int main()
+{
+    hlt_config cfg = *hlt_config_get();
+    cfg.num_workers = 0;
+    cfg.file_buffer_size = 16;
+    cfg.file_flush_interval = 0.5;
+    hlt_config_set(&cfg);
+
+    hlt_init();
+
+    hlt_execution_context* ctx = hlt_global_execution_context();
+    hlt_exception* excpt = 0;
+
+    test_open_log(&excpt, ctx);
+
+    write_line("abc", &excpt, ctx);
+    printf("buffered: %ld\n", file_size("output.log"));
+
+    // Exceeds the buffer size.
+    write_line("defghijklmno", &excpt, ctx);
+    printf("buffer full: %ld\n", file_size("output.log"));
+
+    write_line("p", &excpt, ctx);
+    printf("buffered: %ld\n", file_size("output.log"));
+
+    // The main thread checks for expired output when time advances.
+    usleep(600000);
+    hlt_timer_mgr_advance_global(hlt_time_from_timestamp(1), &excpt, ctx);
+    printf("interval passed: %ld\n", file_size("output.log"));
+
+    write_line("q", &excpt, ctx);
+    printf("buffered: %ld\n", file_size("output.log"));
+
+    test_close_log(&excpt, ctx);
+    printf("closed: %ld\n", file_size("output.log"));
+
+    printf("exception: %s\n", excpt ? "yes" : "no");
+
+    return 0;
+}
+
+/*
+
+@TEST-START-FILE file-buffering.hlt
+
+module Test
+
+import Hilti
+
+export open_log
+export write_log
+export close_log
+
+global ref<file> f
+
+void open_log() {
+    f = new file
+    file.open f "output.log"
+}
+
+void write_log(string s) {
+    file.write f s
+}
+
+void close_log() {
+    file.close f
+}
+
+@TEST-END-FILE
+
+*/
@@ -0,0 +1,123 @@
+/*
+
+@TEST-EXEC:  hilti-build -P file-direct-write.hlt
+@TEST-EXEC:  hilti-build %INPUT file-direct-write.hlt -o a.out
+@TEST-EXEC:  ./a.out >output 2>&1
+@TEST-EXEC:  btest-diff output
+@TEST-EXEC:  btest-diff output.log
+
+*/
+
+// With direct writes, a worker that is the only one writing to a file
+// writes its full buffer itself, so the output is there by the time the
+// job has finished. Once a second worker writes too, output goes through
+// the command queue again, and everything is in the file once its last
+// writer has closed it.
+
+#include <stdio.h>
+#include <sys/stat.h>
+
+#include <libhilti.h>
+
+#include "file-direct-write.hlt.h"
+
+static long file_size(const char* path)
+{
+    struct stat st;
+
+    if ( stat(path, &st) < 0 )
+        return -1;
+
+    return (long)st.st_size;
+}
+
+int main()
+{
+    hlt_config cfg = *hlt_config_get();
+    cfg.num_workers = 2;
+    cfg.file_buffer_size = 16;
+    cfg.file_flush_interval = 3600;
+    cfg.file_direct_write = 1;
+    hlt_config_set(&cfg);
+
+    hlt_init();
+
+    hlt_execution_context* ctx = hlt_global_execution_context();
+    hlt_exception* excpt = 0;
+
+    test_open_log(&excpt, ctx);
+
+    hlt_string s = hlt_string_from_asciiz("written by vthread 1", &excpt, ctx);
+    test_write_in(1, s, &excpt, ctx);
+    printf("direct: %ld\n", file_size("output.log"));
+
+    s = hlt_string_from_asciiz("vthread 2", &excpt, ctx);
+    test_write_in(2, s, &excpt, ctx);
+
+    test_close_log(&excpt, ctx);
+
+    printf("exception: %s\n", excpt ? "yes" : "no");
+
+    return 0;
+}
+
+/*
+
+@TEST-START-FILE file-direct-write.hlt
+
+module Test
+
+import Hilti
+
+export open_log
+export write_in
+export close_log
+
+global ref<file> f
+
+void open_log() {
+    f = new file
+    file.open f "output.log"
+}
+
+void close_log() {
+    file.close f
+}
+
+void write_line(ref<file> out, string s, ref<channel<int<64>>> ch, int<64> vid) {
+    file.write out s
+    file.close out
+    channel.write ch vid
+}
+
+# Writes a line from vthread vid through the job's copy of the file, and
+# waits for the job to finish.
+void write_in(int<64> vid, string s) {
+    local ref<channel<int<64>>> ch
+    local int<64> x
+    local bool b
+
+    ch = new channel<int<64>>
+    thread.schedule write_line(f, s, ch, vid) vid
+
+@read:
+    x = 0
+
+    try {
+        x = channel.read_try ch
+    }
+
+    catch {
+        call Hilti::sleep(0.01)
+    }
+
+    b = equal x 0
+    if.else b @read @done
+
+@done:
+    return.void
+}
+
+@TEST-END-FILE
+
+*/
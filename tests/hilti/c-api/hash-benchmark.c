@@ -0,0 +1,80 @@
+/*
+
+  We don't integrate this into the test-suite, it's for manual benchmarking
+  of map lookups, which are dominated by hashing the keys.
+
+  @TEST-IGNORE
+  @TEST-EXEC:  hilti-build -v %INPUT -o a.out
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <libhilti.h>
+
+double current_time()
+{
+	struct timeval tv;
+	gettimeofday(&tv, 0);
+	return (double)(tv.tv_sec) + (double)(tv.tv_usec) / 1e6;
+}
+
+// Builds key i; with "colliding", all keys hash identically under a plain
+// h*31+c string hash.
+hlt_string make_key(int i, int len, int colliding, hlt_exception** e, hlt_execution_context* ctx)
+{
+    char buffer[len + 1];
+    int j;
+
+    for ( j = 0; j < len / 2; j++ ) {
+        if ( colliding )
+            memcpy(buffer + 2 * j, (i & (1 << j)) ? "BB" : "Aa", 2);
+        else
+            snprintf(buffer + 2 * j, 3, "%02x", (unsigned char)((i >> (j % 4 * 8)) + j));
+    }
+
+    buffer[len] = '\0';
+    return hlt_string_from_asciiz(buffer, e, ctx);
+}
+
+void run(const char* label, int num_keys, int len, int colliding, int rounds)
+{
+    hlt_execution_context* ctx = hlt_global_execution_context();
+    hlt_exception* e = 0;
+
+    hlt_map* m = hlt_map_new(&hlt_type_info_hlt_string, &hlt_type_info_hlt_int_64, 0, &e, ctx);
+    hlt_string keys[num_keys];
+    int i, r;
+
+    for ( i = 0; i < num_keys; i++ ) {
+        int64_t v = i;
+        keys[i] = make_key(i, len, colliding, &e, ctx);
+        hlt_map_insert(m, &hlt_type_info_hlt_string, &keys[i], &hlt_type_info_hlt_int_64, &v, &e, ctx);
+    }
+
+    double start = current_time();
+    int64_t sum = 0;
+
+    for ( r = 0; r < rounds; r++ ) {
+        for ( i = 0; i < num_keys; i++ )
+            sum += *(int64_t*)hlt_map_get(m, &hlt_type_info_hlt_string, &keys[i], &e, ctx);
+    }
+
+    double delta = current_time() - start;
+    double rate = ((double)num_keys * rounds) / delta;
+
+    fprintf(stderr, "%-24s %6d keys of %3d bytes: %.2fs => %.2f lookups/sec (%ld)\n", label, num_keys, len, delta, rate, (long)sum);
+}
+
+int main(int argc, char** argv)
+{
+    hlt_init();
+
+    run("random short keys", 4096, 8, 0, 2000);
+    run("random medium keys", 4096, 24, 0, 1000);
+    run("random long keys", 4096, 256, 0, 200);
+    run("colliding keys", 4096, 24, 1, 10);
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+/*
+
+@TEST-EXEC:  hilti-build %INPUT -o a.out
+@TEST-EXEC:  ./a.out >output 2>&1
+@TEST-EXEC:  btest-diff output
+
+*/
+
+// "Aa" and "BB" collide under a plain h*31+c string hash, and so does any
+// concatenation of them, which makes it trivial to flood a map with keys
+// that all end up in the same bucket. Make sure that's no longer the case,
+// and that hashes depend on content only, not on length limits or chunking.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libhilti.h>
+
+#define BLOCKS 12
+
+static int cmp_hash(const void* a, const void* b)
+{
+    hlt_hash ha = *(const hlt_hash*)a;
+    hlt_hash hb = *(const hlt_hash*)b;
+    return ha < hb ? -1 : (ha > hb ? 1 : 0);
+}
+
+int main()
+{
+    hlt_init();
+
+    hlt_execution_context* ctx = hlt_global_execution_context();
+    hlt_exception* e = 0;
+
+    // All 2^BLOCKS strings made up of "Aa"/"BB" blocks.
+    int n = 1 << BLOCKS;
+    hlt_hash* hashes = malloc(n * sizeof(hlt_hash));
+    char buffer[2 * BLOCKS + 1];
+    int i, j;
+
+    for ( i = 0; i < n; i++ ) {
+        for ( j = 0; j < BLOCKS; j++ )
+            memcpy(buffer + 2 * j, (i & (1 << j)) ? "BB" : "Aa", 2);
+
+        buffer[2 * BLOCKS] = '\0';
+
+        hlt_string s = hlt_string_from_asciiz(buffer, &e, ctx);
+        hashes[i] = hlt_string_hash(&hlt_type_info_hlt_string, &s, &e, ctx);
+    }
+
+    qsort(hashes, n, sizeof(hlt_hash), cmp_hash);
+
+    int distinct = 1;
+
+    for ( i = 1; i < n; i++ ) {
+        if ( hashes[i] != hashes[i-1] )
+            ++distinct;
+    }
+
+    printf("strings: %d distinct hashes for %d keys\n", distinct, n);
+
+    // Inputs beyond 32K that differ only at their end.
+    const int LEN = 100000;
+    int8_t* large1 = hlt_malloc(LEN);
+    int8_t* large2 = hlt_malloc(LEN);
+    memset(large1, 'x', LEN);
+    memset(large2, 'x', LEN);
+    large2[LEN - 1] = 'y';
+
+    printf("large: %s\n", hlt_hash_bytes(large1, LEN, 0) != hlt_hash_bytes(large2, LEN, 0) ? "differ" : "same");
+
+    // The same content split into chunks differently.
+    hlt_bytes* b1 = hlt_bytes_new(&e, ctx);
+    hlt_bytes_append_raw_copy(b1, large1, LEN, &e, ctx);
+
+    hlt_bytes* b2 = hlt_bytes_new(&e, ctx);
+    hlt_bytes_append_raw_copy(b2, large1, 3, &e, ctx);
+    hlt_bytes_append_raw_copy(b2, large1 + 3, 10, &e, ctx);
+    hlt_bytes_append_raw_copy(b2, large1 + 13, LEN - 13, &e, ctx);
+
+    hlt_hash h1 = hlt_bytes_hash(&hlt_type_info_hlt_bytes, &b1, &e, ctx);
+    hlt_hash h2 = hlt_bytes_hash(&hlt_type_info_hlt_bytes, &b2, &e, ctx);
+
+    printf("chunked: %s\n", h1 == h2 ? "same" : "differ");
+    printf("bytes vs raw: %s\n", h1 == hlt_hash_bytes(large1, LEN, 0) ? "same" : "differ");
+
+    return 0;
+}
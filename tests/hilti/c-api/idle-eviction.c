@@ -0,0 +1,133 @@
+/*
+
+@TEST-EXEC:  hilti-build -P idle-eviction.hlt
+@TEST-EXEC:  hilti-build %INPUT idle-eviction.hlt -o a.out
+@TEST-EXEC:  ./a.out >output 2>&1
+@TEST-EXEC:  btest-diff output
+
+*/
+
+// Virtual threads that have been idle for longer than the configured
+// timeout get their contexts evicted, and come back with fresh ones
+// (i.e., freshly initialized globals) when they run a job again.
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <libhilti.h>
+
+#include "idle-eviction.hlt.h"
+
+static uint64_t num_evicted()
+{
+    hlt_thread_mgr* mgr = hlt_global_thread_mgr();
+    uint64_t n = 0;
+
+    for ( int i = 0; i < mgr->num_workers; i++ )
+        n += mgr->workers[i]->num_evicted;
+
+    return n;
+}
+
+int main()
+{
+    hlt_config cfg = *hlt_config_get();
+    cfg.vthread_idle_timeout = 10;
+    hlt_config_set(&cfg);
+
+    hlt_init();
+
+    hlt_execution_context* ctx = hlt_global_execution_context();
+    hlt_exception* excpt = 0;
+
+    // Each vthread counts its runs in a global, so this sums to 100 only
+    // if all contexts are new.
+    printf("first: %ld\n", (long)test_round(100, &excpt, ctx));
+
+    hlt_timer_mgr_advance_global(hlt_time_from_timestamp(100), &excpt, ctx);
+
+    // The workers evict asynchronously once they notice the new time.
+    for ( int i = 0; i < 100 && num_evicted() < 100; i++ )
+        usleep(100000);
+
+    printf("evicted: %lu\n", (unsigned long)num_evicted());
+
+    printf("second: %ld\n", (long)test_round(100, &excpt, ctx));
+
+    printf("exception: %s\n", excpt ? "yes" : "no");
+
+    return 0;
+}
+
+/*
+
+@TEST-START-FILE idle-eviction.hlt
+
+module Test
+
+import Hilti
+
+export round
+
+global int<64> runs
+
+void bump(ref<channel<int<64>>> ch) {
+    runs = incr runs
+    channel.write ch runs
+}
+
+# Runs bump() once in each of vthreads 1..n and returns the sum of their
+# run counts.
+int<64> round(int<64> n) {
+    local ref<channel<int<64>>> ch
+    local int<64> i
+    local int<64> x
+    local int<64> sum
+    local bool b
+
+    ch = new channel<int<64>>
+    i = 1
+
+@schedule:
+    b = int.sgt i n
+    if.else b @collect_start @next
+
+@next:
+    thread.schedule bump(ch) i
+    i = incr i
+    jump @schedule
+
+@collect_start:
+    i = 1
+    sum = 0
+
+@collect:
+    b = int.sgt i n
+    if.else b @done @read
+
+@read:
+    x = 0
+
+    try {
+        x = channel.read_try ch
+    }
+
+    catch {
+        call Hilti::sleep(0.01)
+    }
+
+    b = equal x 0
+    if.else b @read @got
+
+@got:
+    sum = int.add sum x
+    i = incr i
+    jump @collect
+
+@done:
+    return.result sum
+}
+
+@TEST-END-FILE
+
+*/
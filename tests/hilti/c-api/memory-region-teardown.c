@@ -0,0 +1,81 @@
+/*
+
+@TEST-EXEC:  hilti-build %INPUT -o a.out
+@TEST-EXEC:  ./a.out >output 2>&1
+@TEST-EXEC:  btest-diff output
+
+*/
+
+// Ending a region tears down chains of region objects, including those
+// where each object is referenced only by one created after it. Allocation
+// counts are only tracked in debug builds; elsewhere, the "leaked" lines
+// trivially report zero.
+
+#include <stdio.h>
+
+#include <libhilti.h>
+
+static int64_t outstanding()
+{
+    hlt_memory_stats stats = hlt_memory_statistics();
+    return (int64_t)stats.num_allocs - (int64_t)stats.num_deallocs;
+}
+
+// Builds a chain of lists, each containing the one created before it.
+static hlt_list* chain(int n, hlt_exception** excpt, hlt_execution_context* ctx)
+{
+    hlt_list* prev = 0;
+
+    for ( int i = 0; i < n; i++ ) {
+        hlt_list* l = hlt_list_new(&hlt_type_info_hlt_list, 0, excpt, ctx);
+
+        if ( prev )
+            hlt_list_push_back(l, &hlt_type_info_hlt_list, &prev, excpt, ctx);
+
+        prev = l;
+    }
+
+    return prev;
+}
+
+int main()
+{
+    hlt_init();
+
+    hlt_execution_context* ctx = hlt_global_execution_context();
+    hlt_exception* excpt = 0;
+
+    hlt_memory_safepoint(ctx);
+    int64_t before = outstanding();
+
+    // Nothing escapes, so everything goes.
+    hlt_memory_region_begin(ctx);
+    chain(10000, &excpt, ctx);
+    hlt_memory_region_end(ctx);
+
+    printf("leaked: %ld\n", (long)(outstanding() - before));
+
+    // The head escapes and keeps the rest of its chain alive.
+    hlt_memory_region_begin(ctx);
+    hlt_list* head = chain(10000, &excpt, ctx);
+    GC_CCTOR(head, hlt_list, ctx);
+    hlt_memory_region_end(ctx);
+
+    int depth = 0;
+
+    for ( hlt_list* l = head; hlt_list_size(l, &excpt, ctx); depth++ ) {
+        hlt_iterator_list i = hlt_list_begin(l, &excpt, ctx);
+        l = *(hlt_list**) hlt_iterator_list_deref(i, &excpt, ctx);
+    }
+
+    printf("depth: %d\n", depth);
+
+    // Releasing the head releases the whole chain.
+    GC_DTOR(head, hlt_list, ctx);
+    hlt_memory_safepoint(ctx);
+
+    printf("leaked: %ld\n", (long)(outstanding() - before));
+    printf("exception: %s\n", excpt ? "yes" : "no");
+
+    return 0;
+}
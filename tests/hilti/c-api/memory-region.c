@@ -0,0 +1,65 @@
+/*
+
+@TEST-EXEC:  hilti-build %INPUT -o a.out
+@TEST-EXEC:  ./a.out >output 2>&1
+@TEST-EXEC:  btest-diff output
+
+*/
+
+// Objects allocated inside a region go away with it, except for those still
+// referenced from elsewhere, which remain valid as regular objects.
+
+#include <stdio.h>
+
+#include <libhilti.h>
+
+int main()
+{
+    hlt_init();
+
+    hlt_execution_context* ctx = hlt_global_execution_context();
+    hlt_exception* excpt = 0;
+
+    hlt_bytes* kept = 0;
+
+    hlt_memory_region_begin(ctx);
+
+    for ( int i = 0; i < 1000; i++ ) {
+        // Temporaries only.
+        hlt_bytes* b = hlt_bytes_new_from_data_copy((int8_t*)"12345", 5, &excpt, ctx);
+        hlt_bytes_append_raw_copy(b, (int8_t*)"678", 3, &excpt, ctx);
+    }
+
+    // The second chunk is referenced only by the first one, and must
+    // survive along with it.
+    kept = hlt_bytes_new_from_data_copy((int8_t*)"abcde", 5, &excpt, ctx);
+    hlt_bytes_append_raw_copy(kept, (int8_t*)"fgh", 3, &excpt, ctx);
+    GC_CCTOR(kept, hlt_bytes, ctx);
+
+    hlt_memory_region_end(ctx);
+
+    printf("kept: %ld\n", (long)hlt_bytes_len(kept, &excpt, ctx));
+
+    // Further regions don't affect objects that escaped an earlier one.
+    hlt_memory_region_begin(ctx);
+    hlt_bytes_append_raw_copy(kept, (int8_t*)"ij", 2, &excpt, ctx);
+    hlt_memory_region_end(ctx);
+
+    printf("kept: %ld\n", (long)hlt_bytes_len(kept, &excpt, ctx));
+
+    // Nested regions end with the outermost one.
+    hlt_memory_region_begin(ctx);
+    hlt_memory_region_begin(ctx);
+    hlt_bytes* b = hlt_bytes_new_from_data_copy((int8_t*)"xyz", 3, &excpt, ctx);
+    hlt_memory_region_end(ctx);
+    printf("nested: %ld\n", (long)hlt_bytes_len(b, &excpt, ctx));
+    hlt_memory_region_end(ctx);
+
+    // Objects that escaped a region are released like any other.
+    GC_DTOR(kept, hlt_bytes, ctx);
+    hlt_memory_safepoint(ctx);
+
+    printf("exception: %s\n", excpt ? "yes" : "no");
+
+    return 0;
+}
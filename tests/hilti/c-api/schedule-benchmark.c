@@ -0,0 +1,100 @@
+/*
+
+  We don't integrate this into the test-suite, it's for manual benchmarking.
+  Measures schedule-to-completion time for tiny jobs, with and without
+  fibers. Run as "./a.out noyield" and "./a.out yield".
+
+  @TEST-IGNORE
+  @TEST-EXEC:  hilti-build -P schedule-benchmark.hlt
+  @TEST-EXEC:  hilti-build -v %INPUT schedule-benchmark.hlt -o a.out
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <libhilti.h>
+
+#include "schedule-benchmark.hlt.h"
+
+double current_time()
+{
+	struct timeval tv;
+	gettimeofday(&tv, 0);
+	return (double)(tv.tv_sec) + (double)(tv.tv_usec) / 1e6;
+}
+
+int main(int argc, char** argv)
+{
+    int8_t noyield = (argc < 2 || strcmp(argv[1], "yield") != 0);
+
+    hlt_init();
+
+    hlt_execution_context* ctx = hlt_global_execution_context();
+    hlt_exception* excpt = 0;
+
+    int64_t rounds = 1000000;
+    double start = current_time();
+
+    bench_run(rounds, noyield, &excpt, ctx);
+
+    // Returns once all workers have become idle.
+    hlt_thread_mgr_set_state(hlt_global_thread_mgr(), HLT_THREAD_MGR_FINISH);
+
+    double delta = current_time() - start;
+    double rate = rounds / delta;
+
+    fprintf(stderr, "schedule/%s: %.2fs => %.2f jobs/sec, %.2fus/job\n",
+            noyield ? "noyield" : "yield", delta, rate, delta * 1e6 / rounds);
+
+    return 0;
+}
+
+/*
+
+@TEST-START-FILE schedule-benchmark.hlt
+
+module Bench
+
+import Hilti
+
+export run
+
+void tiny_noyield(int<64> i) &noyield {
+}
+
+void tiny_yield(int<64> i) {
+}
+
+void run(int<64> n, bool noyield) {
+    local int<64> i
+    local bool cont
+
+    i = assign 0
+
+@loop:
+    cont = int.slt i n
+    if.else cont @schedule @done
+
+@schedule:
+    if.else noyield @noyield @yield
+
+@noyield:
+    thread.schedule tiny_noyield(i) i
+    jump @next
+
+@yield:
+    thread.schedule tiny_yield(i) i
+    jump @next
+
+@next:
+    i = int.incr i
+    jump @loop
+
+@done:
+    return.void
+}
+
+@TEST-END-FILE
+
+*/
@@ -40,6 +40,9 @@ static struct option long_options[] = {
     { "profile", no_argument, 0, 'F' },
     { "jit", no_argument, 0, 'j' },
     { "opt", required_argument, 0, 'O' },
+    { "no-opt", required_argument, 0, 'X' },
+    { "pgo", required_argument, 0, 'G' },
+    { "unwind", no_argument, 0, 'U' },
     { "add-stdlibs", no_argument, 0, 's' },
     { "disable-linker", no_argument, 0, 'C' },
     { 0, 0, 0, 0 }
@@ -49,6 +52,8 @@ void usage()
 {
     auto dbglist = hilti::Options().cgDebugLabels();
     auto dbgstr = util::strjoin(dbglist.begin(), dbglist.end(), "/");
+    auto optlist = hilti::Options().optimizationLabels();
+    auto optstr = util::strjoin(optlist.begin(), optlist.end(), "/");
 
     cerr << "Usage: " << Name << " [options] <inputs> [ - <options for JIT main()> ]\n"
             "\n"
@@ -71,6 +76,9 @@ void usage()
             "  -V | --llvm-first     Like -L, but print each file individually to stdout and don't link.\n"
             "  -o | --output <file>  Specify output file.                    [Default: stdout].\n"
             "  -O | --opt            Optimize generated code.                [Default: off].\n"
+            "  -X | --no-opt <pass>  Disable a HILTI-level optimization of -O; pass can be " << optstr << ".\n"
+            "  -G | --pgo <mode>     Profile-guided optimization; mode can be instrument, or use with -O.\n"
+            "  -U | --unwind         Propagate exceptions by unwinding.      [Default: off].\n"
             "  -p | --print          Just output all parsed HILTI code again.\n"
             "  -c | --cfg            Add control/data flow information to output of -p.\n"
             "  -P | --prototypes     Generate C prototypes for HILTI module.\n"
@@ -222,7 +230,7 @@ int main(int argc, char** argv)
     shared_ptr<hilti::Options> options = std::make_shared<hilti::Options>();
 
     while ( true ) {
-        int c = getopt_long(argc, argv, "AdD:hjpcFPWbClLsVo:OvI:", long_options, 0);
+        int c = getopt_long(argc, argv, "AdD:hjpcFPWbClLsVo:OvI:X:G:U", long_options, 0);
 
         if ( c < 0 )
             break;
@@ -253,6 +261,26 @@ int main(int argc, char** argv)
             options->optimize = true;
             break;
 
+         case 'X':
+            if ( ! options->optimizationLabels().count(optarg) )
+                error("", util::fmt("unknown optimization pass '%s'", optarg));
+
+            options->optimizations.erase(optarg);
+            break;
+
+         case 'G':
+            if ( string(optarg) == "instrument" )
+                options->pgo_instrument = true;
+            else if ( string(optarg) == "use" )
+                options->pgo_use = true;
+            else
+                error("", util::fmt("unknown PGO mode '%s'", optarg));
+            break;
+
+         case 'U':
+            options->unwind_exceptions = true;
+            break;
+
          case 'p':
             output_hilti = true;
             ++num_output_types;
@@ -347,6 +375,12 @@ int main(int argc, char** argv)
     if ( disable_linker && options->jit )
         error("", "Cannot use JIT when not linking");
 
+    if ( disable_linker && (options->pgo_instrument || options->pgo_use) )
+        error("", "Cannot use profile-guided optimization when not linking");
+
+    if ( options->pgo_use && ! options->optimize )
+        error("", "Using a profile requires -O");
+
     if ( num_output_types == 0 )
         error("", "No output type specificied.");
 
@@ -63,6 +63,7 @@ typedef struct  {
 } Embed;
 
 int driver_debug = 0;
+uint64_t input_len = 0;
 int debug_hooks = 0;
 
 binpac_parser* request = 0;
@@ -333,15 +334,20 @@ static void dump_memstats()
     uint64_t num_nullbuffer = stats.num_nullbuffer;
     uint64_t max_nullbuffer = stats.max_nullbuffer;
 
+    // Reference count operations per input byte, as a measure of the memory
+    // management overhead the generated code incurs.
+    double ref_ops_per_byte = input_len ? (double)(stats.num_refs + stats.num_unrefs) / input_len : 0;
+
     fprintf(stderr, "--- pac-driver stats: "
                     "%" PRIu64 "M heap, "
                     "%" PRIu64 "M alloced, "
                     "%" PRIu64 " allocations, "
                     "%" PRIu64 " totals refs "
                     "%" PRIu64 " in nullbuffer "
-                    "%" PRIu64 " max nullbuffer"
+                    "%" PRIu64 " max nullbuffer "
+                    "%.2f ref ops/byte"
                     "\n",
-            heap, alloced, current_allocs, total_refs, num_nullbuffer, max_nullbuffer);
+            heap, alloced, current_allocs, total_refs, num_nullbuffer, max_nullbuffer, ref_ops_per_byte);
 }
 
 void parseSingleInput(binpac_parser* p, int chunk_size, Embed* embeds)
@@ -352,6 +358,8 @@ void parseSingleInput(binpac_parser* p, int chunk_size, Embed* embeds)
     hlt_bytes* input = readAllInput(embeds);
     GC_CCTOR(input, hlt_bytes, ctx);
 
+    input_len = hlt_bytes_len(input, &excpt, ctx);
+
     hlt_iterator_bytes cur = hlt_bytes_begin(input, &excpt, ctx);
 
     check_exception(excpt);